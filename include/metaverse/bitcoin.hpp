@@ -35,6 +35,7 @@
 #include <metaverse/bitcoin/chain/script/opcode.hpp>
 #include <metaverse/bitcoin/chain/script/operation.hpp>
 #include <metaverse/bitcoin/chain/script/script.hpp>
+#include <metaverse/bitcoin/chain/script/script_view.hpp>
 #include <metaverse/bitcoin/config/authority.hpp>
 #include <metaverse/bitcoin/config/base16.hpp>
 #include <metaverse/bitcoin/config/base2.hpp>
@@ -122,6 +123,7 @@
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/log.hpp>
 #include <metaverse/bitcoin/utility/logging.hpp>
+#include <metaverse/bitcoin/utility/metrics.hpp>
 #include <metaverse/bitcoin/utility/monitor.hpp>
 #include <metaverse/bitcoin/utility/notifier.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
@@ -135,6 +137,7 @@
 #include <metaverse/bitcoin/utility/string.hpp>
 #include <metaverse/bitcoin/utility/subscriber.hpp>
 #include <metaverse/bitcoin/utility/synchronizer.hpp>
+#include <metaverse/bitcoin/utility/task.hpp>
 #include <metaverse/bitcoin/utility/thread.hpp>
 #include <metaverse/bitcoin/utility/threadpool.hpp>
 #include <metaverse/bitcoin/utility/timer.hpp>
@@ -116,6 +116,7 @@ public:
     static operation factory_from_data(std::istream& stream);
     static operation factory_from_data(reader& source);
 
+    static bool is_push(const opcode code);
     static bool is_push_only(const operation::stack& operations);
 
     /// unspendable pattern (standard)
@@ -180,7 +181,6 @@ public:
     data_chunk data;
 
 private:
-    static bool is_push(const opcode code);
     static uint64_t count_non_push(const operation::stack& operations);
     static bool must_read_data(opcode code);
     static bool read_opcode_data_size(uint32_t& count, opcode code,
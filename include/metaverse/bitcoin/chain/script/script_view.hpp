@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_CHAIN_SCRIPT_VIEW_HPP
+#define MVS_CHAIN_SCRIPT_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/chain/script/opcode.hpp>
+#include <metaverse/bitcoin/chain/script/operation.hpp>
+#include <metaverse/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// An operation decoded in place, push data references the script bytes.
+struct BC_API operation_view
+{
+    data_slice data() const;
+    size_t size() const;
+
+    opcode code;
+    const uint8_t* begin;
+    const uint8_t* end;
+};
+
+/// Non-owning view of a serialized (unprefixed) script.
+/// Decoding and pattern matching walk the raw bytes and never allocate,
+/// operations are only materialized on request (e.g. for the interpreter).
+/// The viewed bytes must outlive the view and its iterators.
+class BC_API script_view
+{
+public:
+    class BC_API const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef operation_view value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const operation_view* pointer;
+        typedef const operation_view& reference;
+
+        const_iterator(const uint8_t* position, const uint8_t* end);
+
+        reference operator*() const;
+        pointer operator->() const;
+        const_iterator& operator++();
+        const_iterator operator++(int);
+        bool operator==(const const_iterator& other) const;
+        bool operator!=(const const_iterator& other) const;
+
+        /// False if the bytes at the current position do not decode.
+        bool valid() const;
+
+    private:
+        void decode();
+
+        const uint8_t* position_;
+        const uint8_t* end_;
+        const uint8_t* next_;
+        operation_view current_;
+        bool valid_;
+    };
+
+    explicit script_view(data_slice raw);
+
+    /// Iteration is empty unless the whole script decodes (strict parse).
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    data_slice raw() const;
+
+    /// The script decodes strictly (an empty script decodes).
+    bool is_valid() const;
+    bool empty() const;
+
+    /// Number of operations, zero if the script does not decode.
+    size_t size() const;
+
+    /// Operation at index (linear walk), index must be less than size().
+    operation_view at(size_t index) const;
+    operation_view back() const;
+
+    /// Same result as script::pattern() on the strictly parsed script.
+    script_pattern pattern() const;
+    bool is_push_only() const;
+
+    /// Materialize operations, false if the script does not decode.
+    bool to_operations(operation::stack& out) const;
+
+private:
+    const uint8_t* begin_;
+    const uint8_t* end_;
+    size_t size_;
+    bool valid_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
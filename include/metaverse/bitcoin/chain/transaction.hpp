@@ -21,6 +21,7 @@
 #ifndef MVS_CHAIN_TRANSACTION_HPP
 #define MVS_CHAIN_TRANSACTION_HPP
 
+#include <atomic>
 #include <cstdint>
 #include <istream>
 #include <memory>
@@ -79,6 +80,10 @@ public:
     void reset();
     hash_digest hash() const;
 
+    /// Seed the hash cache of a transaction read back by its hash, so that
+    /// it is not rehashed. Call before the transaction is shared.
+    void set_hash(const hash_digest& hash);
+
     // sighash_type is used by OP_CHECKSIG
     hash_digest hash(uint32_t sighash_type) const;
     bool is_coinbase() const;
@@ -112,8 +117,19 @@ protected:
     bool all_inputs_final() const;
 
 private:
-    mutable upgrade_mutex mutex_;
-    mutable std::shared_ptr<hash_digest> hash_;
+    enum hash_state : uint8_t
+    {
+        hash_empty,
+        hash_writing,
+        hash_ready
+    };
+
+    void move_hash(transaction& other);
+
+    // The hash is cached inline and published with release/acquire ordering,
+    // so hashing a freshly parsed transaction costs no heap allocation or lock.
+    mutable std::atomic<uint8_t> hash_state_;
+    mutable hash_digest hash_;
 };
 
 } // namespace chain
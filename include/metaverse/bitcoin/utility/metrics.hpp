@@ -0,0 +1,162 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_METRICS_HPP
+#define MVS_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+/// Process wide registry of counters, gauges and latency histograms.
+/// Registration is locked, updates are lock free (relaxed atomics), so a
+/// metric handle may be resolved once and then bumped from any hot path.
+class BC_API metrics
+{
+public:
+    /// Monotonically increasing value.
+    class BC_API counter
+    {
+    public:
+        typedef std::shared_ptr<counter> ptr;
+
+        counter();
+        void increment(uint64_t value=1);
+        uint64_t value() const;
+
+    private:
+        std::atomic<uint64_t> value_;
+    };
+
+    /// Value that may go up and down.
+    class BC_API gauge
+    {
+    public:
+        typedef std::shared_ptr<gauge> ptr;
+
+        gauge();
+        void set(int64_t value);
+        void add(int64_t value);
+        void subtract(int64_t value);
+        int64_t value() const;
+
+    private:
+        std::atomic<int64_t> value_;
+    };
+
+    /// Log-linear (HDR style) histogram of microsecond samples, four linear
+    /// sub buckets per power of two, so relative error stays under 25%.
+    class BC_API histogram
+    {
+    public:
+        typedef std::shared_ptr<histogram> ptr;
+        static const size_t sub_buckets = 4;
+        static const size_t bucket_count = 64 * sub_buckets;
+
+        histogram();
+        void record(uint64_t microseconds);
+        uint64_t count() const;
+        uint64_t sum() const;
+
+        /// Number of samples at or below the given bound (prometheus 'le'),
+        /// exact when the bound is a bucket upper bound (a power of two).
+        uint64_t count_at_most(uint64_t microseconds) const;
+
+        /// Approximate value at the given quantile [0, 1].
+        uint64_t quantile(double fraction) const;
+
+        static size_t to_bucket(uint64_t microseconds);
+        static uint64_t lower_bound(size_t bucket);
+        static uint64_t upper_bound(size_t bucket);
+
+    private:
+        std::array<std::atomic<uint64_t>, bucket_count> buckets_;
+        std::atomic<uint64_t> count_;
+        std::atomic<uint64_t> sum_;
+    };
+
+    /// Records the lifetime of the instance into a histogram.
+    class BC_API scoped_timer
+    {
+    public:
+        typedef std::chrono::steady_clock clock;
+
+        scoped_timer(histogram& target);
+        ~scoped_timer();
+
+        /// Microseconds since construction.
+        uint64_t elapsed() const;
+
+    private:
+        histogram& target_;
+        const clock::time_point start_;
+    };
+
+    static metrics& instance();
+
+    /// Get or create the metric named 'name' with the given label set, where
+    /// labels are prometheus formatted, e.g. table="spend",op="store".
+    counter::ptr make_counter(const std::string& name,
+        const std::string& help, const std::string& labels="");
+    gauge::ptr make_gauge(const std::string& name,
+        const std::string& help, const std::string& labels="");
+    histogram::ptr make_histogram(const std::string& name,
+        const std::string& help, const std::string& labels="");
+
+    /// Drop a labeled series (e.g. for a disconnected peer).
+    void remove(const std::string& name, const std::string& labels);
+
+    /// Render all series in the prometheus text exposition format (0.0.4).
+    std::string to_prometheus() const;
+
+    /// Microseconds elapsed since the given time point.
+    static uint64_t since(const scoped_timer::clock::time_point& start);
+
+private:
+    enum class kind { counter, gauge, histogram };
+
+    struct family
+    {
+        kind type;
+        std::string help;
+        std::map<std::string, counter::ptr> counters;
+        std::map<std::string, gauge::ptr> gauges;
+        std::map<std::string, histogram::ptr> histograms;
+    };
+
+    family& get_family(const std::string& name, const std::string& help,
+        kind type);
+
+    std::map<std::string, family> families_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_TASK_HPP
+#define MVS_TASK_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <boost/intrusive_ptr.hpp>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/utility/metrics.hpp>
+
+namespace libbitcoin {
+
+/// This class is thread safe.
+/// A job posted to a work queue. Nodes are recycled through a bounded free
+/// list of each thread and the handler is kept inline when it fits, so once
+/// warm a thread that runs jobs posts its own without allocating.
+class BC_API task
+{
+public:
+    typedef boost::intrusive_ptr<task> ptr;
+
+    /// Accounting shared by the jobs of one work queue, resolved once.
+    class BC_API queue
+    {
+    public:
+        typedef std::shared_ptr<queue> ptr;
+
+        queue(const std::string& name, const std::string& type);
+
+        /// Jobs posted and not yet run (or dropped) on this queue.
+        size_t backlog() const;
+
+    private:
+        friend class task;
+
+        std::atomic<size_t> backlog_;
+        std::atomic<size_t> posted_;
+        metrics::gauge& depth_;
+        metrics::histogram& wait_;
+        metrics::histogram& run_;
+    };
+
+    /// Posted wrapper, copies share the node and the job runs once.
+    struct runner
+    {
+        void operator()() const
+        {
+            node->invoke();
+        }
+
+        ptr node;
+    };
+
+    /// Trace one of every 'rate' jobs of each queue, zero disables tracing.
+    static void set_trace_sample(size_t rate);
+
+    template <typename Handler>
+    static runner make(Handler&& handler, const queue::ptr& owner)
+    {
+        typedef holder<typename std::decay<Handler>::type> bound;
+        typedef std::integral_constant<bool, sizeof(bound) <= inline_size &&
+            alignof(bound) <= alignof(inline_storage)> fits;
+
+        const auto node = acquire();
+        node->construct<bound>(std::forward<Handler>(handler), fits());
+        node->start(owner);
+        return { ptr(node) };
+    }
+
+private:
+    typedef metrics::scoped_timer::clock clock;
+    static const size_t inline_size = 128;
+    typedef std::aligned_storage<inline_size>::type inline_storage;
+
+    struct callable
+    {
+        virtual ~callable() {}
+        virtual void invoke() = 0;
+    };
+
+    template <typename Handler>
+    struct holder
+      : public callable
+    {
+        template <typename Argument>
+        explicit holder(Argument&& argument)
+          : handler(std::forward<Argument>(argument))
+        {
+        }
+
+        void invoke() override
+        {
+            handler();
+        }
+
+        Handler handler;
+    };
+
+    task();
+
+    template <typename Bound, typename Handler>
+    void construct(Handler&& handler, std::true_type)
+    {
+        callable_ = new (&storage_) Bound(std::forward<Handler>(handler));
+        inline_ = true;
+    }
+
+    template <typename Bound, typename Handler>
+    void construct(Handler&& handler, std::false_type)
+    {
+        callable_ = new Bound(std::forward<Handler>(handler));
+        inline_ = false;
+    }
+
+    static task* acquire();
+    static void recycle(task* node);
+    static task* pop(task*& head);
+
+    void start(const queue::ptr& owner);
+    void invoke();
+    void finish();
+
+    friend struct free_list;
+    friend void intrusive_ptr_add_ref(task* node);
+    friend void intrusive_ptr_release(task* node);
+
+    inline_storage storage_;
+    callable* callable_;
+    bool inline_;
+    bool traced_;
+    clock::time_point posted_;
+    queue::ptr queue_;
+    std::atomic<size_t> references_;
+    task* next_;
+};
+
+BC_API void intrusive_ptr_add_ref(task* node);
+BC_API void intrusive_ptr_release(task* node);
+
+} // namespace libbitcoin
+
+#endif
@@ -21,9 +21,12 @@
 #ifndef MVS_THREADPOOL_HPP
 #define MVS_THREADPOOL_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <memory>
 #include <functional>
 #include <thread>
+#include <vector>
 #include <metaverse/bitcoin/define.hpp>
 #include <metaverse/bitcoin/utility/asio.hpp>
 #include <metaverse/bitcoin/utility/thread.hpp>
@@ -58,6 +61,23 @@ public:
     void spawn(size_t number_threads=1,
         thread_priority priority=thread_priority::normal);
 
+    /**
+     * Run number_shards single threaded shards, each with its own
+     * io_service, creating those that do not yet exist. Shards are stopped
+     * and joined with this threadpool and retained across restarts.
+     * @param[in]   number_shards   Number of shards to run.
+     * @param[in]   priority        Priority of shard threads.
+     */
+    void spawn_shards(size_t number_shards,
+        thread_priority priority=thread_priority::normal);
+
+    /**
+     * The next shard in rotation, or this threadpool if there are none.
+     * Work that shares state (e.g. a channel and its protocols) can be
+     * pinned to one shard so that it never contends across threads.
+     */
+    threadpool& shard();
+
     /**
      * Abandon outstanding operations without dispatching handlers.
      * Terminate threads once work is complete.
@@ -86,6 +106,11 @@ public:
      */
     void join();
 
+    /**
+     * The number of threads of this threadpool, not counting its shards.
+     */
+    size_t size() const;
+
     /**
      * Underlying boost::io_service object.
      */
@@ -101,7 +126,11 @@ private:
 
     asio::service service_;
     std::vector<asio::thread> threads_;
+    std::atomic<size_t> size_;
     std::shared_ptr<asio::service::work> work_;
+    std::vector<std::shared_ptr<threadpool>> shards_;
+    std::atomic<size_t> active_shards_;
+    std::atomic<size_t> next_shard_;
 };
 
 } // namespace libbitcoin
@@ -26,7 +26,7 @@
 #include <utility>
 #include <metaverse/bitcoin/define.hpp>
 #include <metaverse/bitcoin/utility/asio.hpp>
-#include <metaverse/bitcoin/utility/monitor.hpp>
+#include <metaverse/bitcoin/utility/task.hpp>
 #include <metaverse/bitcoin/utility/threadpool.hpp>
 
 namespace libbitcoin {
@@ -65,8 +65,7 @@ public:
     template <typename Handler, typename... Args>
     void concurrent(Handler&& handler, Args&&... args)
     {
-        service_.post(inject(BIND_HANDLER(handler, args), CONCURRENT,
-            concurrent_));
+        service_.post(task::make(BIND_HANDLER(handler, args), concurrent_));
     }
 
     /// Use a strand to prevent concurrency and post vs. dispatch to
@@ -74,7 +73,7 @@ public:
     template <typename Handler, typename... Args>
     void ordered(Handler&& handler, Args&&... args)
     {
-        strand_.post(inject(BIND_HANDLER(handler, args), ORDERED, ordered_));
+        strand_.post(task::make(BIND_HANDLER(handler, args), ordered_));
     }
 
     /// Use a strand wrapper to prevent concurrency and a service post
@@ -82,8 +81,8 @@ public:
     template <typename Handler, typename... Args>
     void unordered(Handler&& handler, Args&&... args)
     {
-        service_.post(strand_.wrap(inject(BIND_HANDLER(handler, args),
-            UNORDERED, unordered_)));
+        service_.post(strand_.wrap(task::make(BIND_HANDLER(handler, args),
+            unordered_)));
     }
 
     size_t ordered_backlog();
@@ -91,23 +90,14 @@ public:
     size_t concurrent_backlog();
     size_t combined_backlog();
 
-private:
-    template <typename Handler>
-    auto inject(Handler handler, const std::string& context,
-        monitor::count_ptr counter) -> std::function<void()>
-    {
-        const auto label = name_ + "_" + context;
-        const auto capture = std::make_shared<monitor>(counter, label);
-        return [=]() { capture->invoke(handler); };
-
-        //// TODO: determine how to define return type across platforms.
-        ////return std::bind(&monitor::invoke<Handler>, capture, handler);
-    }
+    /// Trace one of every 'rate' jobs of each queue, zero disables tracing.
+    static void set_trace_sample(size_t rate);
 
+private:
     // These are thread safe.
-    monitor::count_ptr ordered_;
-    monitor::count_ptr unordered_;
-    monitor::count_ptr concurrent_;
+    task::queue::ptr ordered_;
+    task::queue::ptr unordered_;
+    task::queue::ptr concurrent_;
     asio::service& service_;
     asio::service::strand strand_;
     const std::string name_;
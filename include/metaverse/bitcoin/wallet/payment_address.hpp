@@ -99,6 +99,7 @@ private:
     static payment_address from_public(const ec_public& point, uint8_t version);
     static payment_address from_script(const chain::script& script,
         uint8_t version);
+    static payment_address from_redeem_script(data_slice redeem_data);
 
     /// Members.
     /// These should be const, apart from the need to implement assignment.
@@ -26,10 +26,13 @@
 #include <metaverse/blockchain/block_detail.hpp>
 #include <metaverse/blockchain/block_fetcher.hpp>
 #include <metaverse/blockchain/define.hpp>
+#include <metaverse/blockchain/header_index.hpp>
 #include <metaverse/blockchain/organizer.hpp>
 #include <metaverse/blockchain/orphan_pool.hpp>
+#include <metaverse/blockchain/pool_validations.hpp>
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/simple_chain.hpp>
+#include <metaverse/blockchain/stake_candidates.hpp>
 #include <metaverse/blockchain/transaction_pool.hpp>
 #include <metaverse/blockchain/transaction_pool_index.hpp>
 #include <metaverse/blockchain/validate_block.hpp>
@@ -22,17 +22,22 @@
 #define MVS_BLOCKCHAIN_BLOCK_CHAIN_IMPL_HPP
 
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <functional>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database.hpp>
 #include <metaverse/blockchain/block_chain.hpp>
 #include <metaverse/blockchain/define.hpp>
+#include <metaverse/blockchain/header_index.hpp>
 #include <metaverse/blockchain/organizer.hpp>
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/simple_chain.hpp>
+#include <metaverse/blockchain/stake_candidates.hpp>
 #include <metaverse/blockchain/transaction_pool.hpp>
 #include <metaverse/bitcoin/chain/header.hpp>
 #include <metaverse/consensus/fts.hpp>
@@ -62,6 +67,36 @@ class BCB_API block_chain_impl
 {
     friend class block_chain_writer;
 public:
+    /// The previous output of an input, as resolved for its validation.
+    struct prevout
+    {
+        typedef std::vector<prevout> list;
+
+        /// False if the previous transaction is in neither the store nor
+        /// the pool.
+        bool found;
+
+        /// False if the previous transaction has no output at the index.
+        bool valid;
+
+        /// True if in the store, otherwise it is in the pool.
+        bool confirmed;
+
+        /// True if spent in the store.
+        bool spent;
+
+        /// True if the output is of a coinbase transaction.
+        bool coinbase;
+
+        /// The height of the block holding the output, zero if in the pool.
+        uint64_t height;
+
+        chain::output output;
+    };
+
+    typedef std::function<void(const code&, const prevout::list&)>
+        prevouts_fetch_handler;
+
     block_chain_impl(threadpool& pool,
         const blockchain::settings& chain_settings,
         const database::settings& database_settings);
@@ -129,7 +164,9 @@ public:
     bool get_transaction(chain::transaction& out_transaction,
         uint64_t& out_block_height, const hash_digest& transaction_hash) const override;
 
-    /// Import a block to the blockchain.
+    /// Import a block to the blockchain. With deferred indexes only the
+    /// block and its transactions and spends are stored, and the indexer
+    /// builds the address, asset and stealth indexes behind it.
     bool import(chain::block::ptr block, uint64_t height) override;
 
     /// Append the block to the top of the chain.
@@ -221,6 +258,12 @@ public:
     void fetch_spend(const chain::output_point& outpoint,
         spend_fetch_handler handler) override;
 
+    /// fetch the previous outputs of the points, in their order, with their
+    /// heights and spends, all in one read. Outputs not in the store are
+    /// taken from the pool if given, which must be called on its dispatcher.
+    void fetch_prevouts(const chain::point::list& points,
+        const transaction_pool* pool, prevouts_fetch_handler handler);
+
     /// fetch outputs, values and spends for an address.
     void fetch_history(const wallet::payment_address& address,
         uint64_t limit, uint64_t from_height, history_fetch_handler handler) override;
@@ -251,6 +294,14 @@ public:
     /// Subscribe to blockchain reorganizations.
     virtual void subscribe_reorganize(reorganize_handler handler) override;
 
+    /// The height up to which the address, asset and stealth indexes are
+    /// built, false if no block is indexed.
+    bool get_indexed_height(uint64_t& out_height) const;
+
+    /// Build any deferred indexes now, for callers that read them. This
+    /// takes the write lock, so it must not be called while holding it.
+    void catch_up_indexes();
+
     /// must be have enough etp locked in the address
     virtual bool check_pos_capability(
         uint64_t best_height,
@@ -283,6 +334,14 @@ public:
 
     virtual chain::header::ptr get_last_block_header(const chain::header& parent_header, uint32_t version) const;
 
+    /// The last two headers of version before height, as get_last_block_header
+    /// finds them for a block at height, from the resident retarget window.
+    /// The headers carry only the retarget inputs. Returns false if the window
+    /// does not cover them, in which case the caller must walk the headers.
+    bool get_retarget_headers(chain::header::ptr& out_last,
+        chain::header::ptr& out_previous, uint64_t height,
+        uint32_t version) const;
+
     inline hash_digest get_hash(const std::string& str) const;
     inline short_hash get_short_hash(const std::string& str) const;
 
@@ -318,6 +377,16 @@ public:
     std::shared_ptr<chain::business_address_asset::list> get_account_assets(
         const std::string& name, chain::business_kind kind);
     uint64_t get_address_asset_volume(const std::string& address, const std::string& asset);
+
+    /// The confirmed asset balances of the address from the balance table,
+    /// or nullptr if the address holds encumbered outputs, for which the
+    /// caller must scan the address history instead.
+    std::shared_ptr<database::address_balance::list> get_address_asset_balances(
+        const std::string& address);
+
+    /// The unspent sequence locked outputs of the address, ordered by the
+    /// height at which their height lock expires.
+    database::address_lock::list get_address_locks(const std::string& address);
     uint64_t get_account_asset_volume(const std::string& account, const std::string& asset);
     uint64_t get_asset_volume(const std::string& asset);
 
@@ -517,6 +586,14 @@ private:
     ////void fetch_parallel(perform_read_functor perform_read);
     void fetch_serial(perform_read_functor perform_read);
     bool stopped() const;
+    void load_header_index();
+    bool make_stake_candidate(stake_candidates::candidate& out_candidate,
+        const chain::transaction& tx, uint32_t index, uint64_t height) const;
+    void connect_stake_candidates(const chain::block& block, uint64_t height);
+    void do_catch_up_indexes();
+    void wake_indexer();
+    void run_indexer();
+    void join_indexer();
 
     std::string get_asset_symbol_from_business_data(const chain::business_data& data) const;
 
@@ -524,6 +601,8 @@ private:
     std::atomic<bool> stopped_;
     std::atomic<bool> sync_disabled_;
     const settings& settings_;
+    const bool deferred_indexes_;
+    const bool warm_up_;
 
     // These are thread safe.
     organizer organizer_;
@@ -534,6 +613,15 @@ private:
     // This is protected by mutex.
     database::data_base database_;
     shared_mutex mutex_;
+
+    // These are thread safe, and follow the top of the database.
+    header_index header_index_;
+    stake_candidates stake_candidates_;
+
+    // The indexer trails the imported blocks when indexes are deferred.
+    std::thread indexer_;
+    std::mutex indexer_mutex_;
+    std::condition_variable indexer_wake_;
 };
 
 } // namespace blockchain
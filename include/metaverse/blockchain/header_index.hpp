@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_HEADER_INDEX_HPP
+#define MVS_BLOCKCHAIN_HEADER_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A resident, height ordered index of the consensus fields of the main
+/// chain headers. Heights are contiguous from zero, so the index only ever
+/// grows or shrinks at the top (push, pop and reorganization).
+class BCB_API header_index
+{
+public:
+    /// The retarget inputs of a header.
+    struct retarget_entry
+    {
+        uint64_t height;
+        uint32_t timestamp;
+        u256 bits;
+    };
+
+    /// The number of recent headers of each version, and of recent heights
+    /// of cumulative work, kept to answer retarget and work queries.
+    static const size_t retarget_window;
+
+    header_index();
+
+    /// Append the header at height, truncating anything at or above it.
+    /// A height beyond the top leaves a gap and is ignored.
+    void push(const chain::header& header, uint64_t height);
+
+    /// Remove all entries at and above height.
+    void pop(uint64_t height);
+
+    /// Drop the whole index.
+    void clear();
+
+    /// The number of indexed heights (top + 1), zero if empty.
+    uint64_t size() const;
+
+    bool get_timestamp(uint32_t& out_timestamp, uint64_t height) const;
+
+    /// Find the highest height in [1, height) whose version is (or, if not
+    /// same_version, is not) the given version. Returns false if the version
+    /// is unknown or height - 1 is not indexed, in which case the caller
+    /// must consult the store. A true result with out_height zero means the
+    /// index holds no such header.
+    bool find_previous(uint64_t& out_height, uint64_t height,
+        uint32_t version, bool same_version) const;
+
+    /// Median of the timestamps of the span heights ending at height.
+    /// Returns false if any of them is not indexed.
+    bool median_time_past(uint32_t& out_time, uint64_t height,
+        size_t span) const;
+
+    /// Find the two highest headers in [1, height) of the given version, the
+    /// inputs of the next target of a block of that version at height.
+    /// Returns false if height - 1 is not indexed or the window of the
+    /// version does not reach back to them, in which case the caller must
+    /// consult the store. An entry with height zero means there is none.
+    bool find_retarget(retarget_entry& out_last,
+        retarget_entry& out_previous, uint64_t height,
+        uint32_t version) const;
+
+    /// The sum of the work of heights [height, top]. Returns false if the
+    /// work window does not reach back to height.
+    bool get_work(u256& out_work, uint64_t height) const;
+
+private:
+    typedef std::vector<uint32_t> height_list;
+    typedef std::deque<retarget_entry> retarget_list;
+
+    static size_t bucket(uint32_t version);
+    void truncate(uint64_t height);
+
+    // These are protected by mutex.
+    // Timestamps by height, and the ascending heights of each consensus
+    // version (bucket zero holds any unknown version). Every indexed height
+    // is in exactly one bucket, so the version is not stored per height.
+    std::vector<uint32_t> timestamps_;
+    height_list heights_[chain::block_version_max];
+
+    // The last headers of each version, a suffix of its heights, and the
+    // cumulative work of the top heights. Work is summed modulo 2^256 from
+    // an arbitrary base, so only differences within the window are used.
+    retarget_list retargets_[chain::block_version_max];
+    std::deque<u256> work_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
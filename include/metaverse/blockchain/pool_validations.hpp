@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_POOL_VALIDATIONS_HPP
+#define MVS_BLOCKCHAIN_POOL_VALIDATIONS_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// The results of memory pool validations, kept by transaction hash so that
+/// a block built on the tip they were validated against can reuse them.
+class BCB_API pool_validations
+{
+public:
+    typedef chain::point::indexes indexes;
+
+    /// The results of validating a transaction against a chain tip, which
+    /// still hold for the transaction in a block built on that tip.
+    struct validation
+    {
+        /// The tip validated against, null_hash if it moved meanwhile.
+        hash_digest tip;
+        uint64_t value_in;
+        uint64_t sigops;
+
+        /// Inputs that spend pool transactions.
+        indexes unconfirmed;
+    };
+
+    /// Get the validation of a transaction against the tip, false if there
+    /// is none or it is against another tip.
+    bool find(validation& out_validation, const hash_digest& tx_hash,
+        const hash_digest& tip) const;
+
+    /// Keep the validation, unless the tip moved while it ran.
+    void store(const hash_digest& tx_hash, const validation& result);
+
+    /// Drop validations against any other tip, which may no longer hold.
+    void retain(const hash_digest& tip);
+
+    /// The number of validations kept.
+    size_t size() const;
+
+private:
+    // These are protected by mutex_.
+    std::unordered_map<hash_digest, validation> validations_;
+    mutable shared_mutex mutex_;
+};
+
+/// This class is not thread safe.
+/// The checks of a block, on the tip, between its transactions that keep
+/// their pool validation and the transactions before them. The transactions
+/// of the block are given in block order.
+class BCB_API pooled_connect
+{
+public:
+    /// Connect a transaction with a pool validation, false if a pool parent
+    /// does not precede it or it spends an output spent before it.
+    bool connect(const chain::transaction& tx,
+        const pool_validations::validation& validation);
+
+    /// Add a transaction without a pool validation, whose spends the full
+    /// validation checks against the whole block.
+    void add(const chain::transaction& tx);
+
+private:
+    std::unordered_set<hash_digest> preceding_;
+    std::unordered_set<chain::point> spent_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
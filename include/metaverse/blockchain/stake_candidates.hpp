@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_STAKE_CANDIDATES_HPP
+#define MVS_BLOCKCHAIN_STAKE_CANDIDATES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// The confirmed outputs of the addresses being staked with, kept current
+/// as blocks are connected and ordered by the height from which they can be
+/// staked, so that a staking slot only visits outputs that may be eligible.
+class BCB_API stake_candidates
+{
+public:
+    struct candidate
+    {
+        typedef std::vector<candidate> list;
+
+        chain::output_info info;
+
+        /// The first height at which all height based rules are satisfied.
+        uint64_t ready_height;
+
+        /// Also subject to a time based rule, which must be checked on use.
+        bool recheck;
+
+        /// Value is below the stake minimum, only usable to collect stake.
+        bool small;
+    };
+
+    /// Build the candidate for an output, false if it cannot be staked.
+    typedef std::function<bool(candidate&, const chain::transaction&,
+        uint32_t, uint64_t)> maker;
+
+    /// Produce all candidates of an address from the store.
+    typedef std::function<candidate::list()> loader;
+
+    /// Called in ready order, return false to stop visiting.
+    typedef std::function<bool(const candidate&)> visitor;
+
+    /// Track the address, loading it if it is not tracked or invalidated.
+    /// The loader is called without the lock held, blocks connected while it
+    /// runs are reconciled with its result.
+    void load(const wallet::payment_address& address, loader load);
+
+    /// Add the outputs of the block paid to tracked addresses and remove the
+    /// tracked outputs it spends.
+    void connect(const chain::block& block, uint64_t height, maker make);
+
+    /// Drop all candidates, addresses are reloaded on next use.
+    void invalidate();
+
+    /// Visit the stake candidates and then the small candidates of the
+    /// address that are ready at height.
+    void visit(const wallet::payment_address& address, uint64_t height,
+        visitor stake, visitor collect) const;
+
+private:
+    typedef std::pair<uint64_t, chain::point> key;
+    typedef std::map<key, candidate> schedule;
+
+    enum class state
+    {
+        invalid,
+        loading,
+        valid
+    };
+
+    struct address_candidates
+    {
+        wallet::payment_address address;
+        state status;
+        schedule stakes;
+        schedule smalls;
+        std::unordered_map<chain::point, std::pair<uint64_t, bool>> points;
+
+        // Outputs spent by blocks connected while loading.
+        std::unordered_set<chain::point> spent;
+    };
+
+    static void insert(address_candidates& entry, candidate&& item);
+    static void remove(address_candidates& entry, const chain::point& point);
+    static void clear(address_candidates& entry);
+    address_candidates* find(const wallet::payment_address& address);
+    const address_candidates* find(
+        const wallet::payment_address& address) const;
+
+    // These are protected by mutex.
+    std::vector<address_candidates> addresses_;
+    uint64_t epoch_ = 0;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
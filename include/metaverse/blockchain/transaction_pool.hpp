@@ -28,6 +28,7 @@
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/block_chain.hpp>
+#include <metaverse/blockchain/pool_validations.hpp>
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/transaction_pool_index.hpp>
 
@@ -52,6 +53,8 @@ public:
     typedef resubscriber<const code&, const indexes&, transaction_ptr>
         transaction_subscriber;
 
+    typedef pool_validations::validation validation;
+
     static bool is_spent_by_tx(const chain::output_point& outpoint,
         const transaction_ptr tx);
 
@@ -89,6 +92,12 @@ public:
     /// Subscribe to transaction acceptance into the mempool.
     void subscribe_transaction(transaction_handler handler);
 
+    /// This is thread safe.
+    /// Get the validation of a transaction accepted against the tip, false if
+    /// it was not accepted or was accepted against another tip.
+    bool find_validation(validation& out_validation,
+        const hash_digest& tx_hash, const hash_digest& tip) const;
+
 protected:
     /// This is analogous to the orphan pool's block_detail.
     struct entry
@@ -109,7 +118,8 @@ protected:
     bool handle_reorganized(const code& ec, size_t fork_point,
         const block_list& new_blocks, const block_list& replaced_blocks);
     void handle_validated(const code& ec, transaction_ptr tx,
-        const indexes& unconfirmed, validate_handler handler);
+        const indexes& unconfirmed, const validation& result,
+        validate_handler handler);
 
     void do_validate(transaction_ptr tx, validate_handler handler);
     void do_store(const code& ec, transaction_ptr tx,
@@ -140,8 +150,10 @@ protected:
     std::atomic<bool> stopped_;
 
 private:
-    // Unsafe methods limited to friend caller.
+    // Unsafe methods limited to friend callers, which validate transactions
+    // on the pool dispatcher.
     friend class validate_transaction;
+    friend class block_chain_impl;
 
     // These methods are NOT thread safe.
     bool is_in_pool(const hash_digest& tx_hash) const;
@@ -157,6 +169,7 @@ private:
     transaction_pool_index index_;
     transaction_subscriber::ptr subscriber_;
     const bool maintain_consistency_;
+    pool_validations validations_;
 };
 
 } // namespace blockchain
@@ -85,6 +85,8 @@ protected:
     virtual versions preceding_block_versions(uint64_t count) const = 0;
     virtual chain::header fetch_block(uint64_t fetch_height) const = 0;
     virtual chain::header::ptr get_last_block_header(const chain::header& parent_header, uint32_t version) const = 0;
+    virtual bool get_retarget_headers(chain::header::ptr& out_last,
+        chain::header::ptr& out_previous, uint32_t version) const = 0;
     virtual bool transaction_exists(const hash_digest& tx_hash) const = 0;
     virtual bool fetch_transaction(chain::transaction& tx, uint64_t& tx_height,
         const hash_digest& tx_hash) const = 0;
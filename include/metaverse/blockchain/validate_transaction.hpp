@@ -26,6 +26,7 @@
 #include <functional>
 #include <memory>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/block_chain_impl.hpp>
 #include <metaverse/blockchain/define.hpp>
 
 namespace libbitcoin {
@@ -33,7 +34,6 @@ namespace blockchain {
 
 class validate_block;
 class transaction_pool;
-class block_chain_impl;
 class block_chain;
 
 /// This class is not thread safe.
@@ -55,6 +55,10 @@ public:
 
     void start(validate_handler handler);
 
+    /// The results of a pool validation for reuse when connecting a block,
+    /// valid once the handler has been invoked with success.
+    transaction_pool::validation result() const;
+
     static bool check_consensus(const chain::script& prevout_script,
         const chain::transaction& current_tx, uint64_t input_index,
         uint32_t flags);
@@ -77,6 +81,8 @@ public:
     code connect_attachment_from_did(const chain::output& output) const;
 
     bool connect_input(const chain::transaction& previous_tx, uint64_t parent_height);
+    bool connect_input(const chain::output& previous_output, bool coinbase,
+        uint64_t parent_height);
 
     static bool tally_fees(block_chain_impl& chain,
         const chain::transaction& tx, uint64_t value_in, uint64_t& fees, bool is_coinstake = false);
@@ -111,21 +117,14 @@ private:
     // Last height used for checking coinbase maturity.
     void set_last_height(const code& ec, uint64_t last_height);
 
-    // Begin looping through the inputs, fetching the previous tx
-    void next_previous_transaction();
-    void previous_tx_index(const code& ec, uint64_t parent_height);
-
-    // If previous_tx_index didn't find it then check in pool instead
-    void search_pool_previous_tx();
-    void handle_previous_tx(const code& ec,
-        const chain::transaction& previous_tx, uint64_t parent_height);
-
-    // After running connect_input, we check whether this validated previous
-    // output was not already spent by another input in the blockchain.
-    // is_spent() earlier already checked in the pool.
-    void check_double_spend(const code& ec, const chain::input_point& point);
+    // Validate all inputs against their previous outputs, resolved in one
+    // read. This also checks that the previous outputs are not already spent
+    // in the blockchain, is_spent_in_pool() earlier checked in the pool.
+    void handle_prevouts(const code& ec,
+        const block_chain_impl::prevout::list& prevouts);
     void check_fees() const;
     code check_tx_connect_input() const;
+    hash_digest top_hash() const;
     bool check_did_exist(const std::string& did) const;
     bool check_asset_exist(const std::string& symbol) const;
     bool check_asset_cert_exist(const std::string& cert, chain::asset_cert_type cert_type) const;
@@ -139,6 +138,8 @@ private:
 
     const hash_digest tx_hash_;
     uint64_t last_block_height_;
+    hash_digest tip_;
+    uint64_t sigops_;
     uint64_t value_in_;
     uint64_t asset_amount_in_;
     std::vector<chain::asset_cert_type> asset_certs_in_;
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
 #include <thread>
+#include <vector>
 #include <metaverse/consensus/libethash/ethash.h>
 #include <metaverse/consensus/libdevcore/Log.h>
 #include <metaverse/consensus/libdevcore/BasicType.h>
 #include <metaverse/bitcoin/chain/header.hpp>
 #include <metaverse/bitcoin/chain/output_point.hpp>
+#include <metaverse/bitcoin/utility/threadpool.hpp>
 #include <metaverse/consensus/libdevcore/FixedHash.h>
 #include <metaverse/consensus/libdevcore/Guards.h>
 namespace libbitcoin
@@ -29,11 +35,56 @@ public:
     static bool verify_work(const chain::header& header, const chain::header::ptr parent);
     static bool verify_stake(const chain::header& header, const chain::output_info& stake_output);
 
+    typedef std::function<void(size_t failed)> verify_handler;
+    typedef std::shared_ptr<const chain::header::list> header_list_ptr;
+
+    /// Verify the proof of work headers of the list in parallel on the pool.
+    /// The handler is invoked once, on a pool thread, with the index of the
+    /// lowest failing header or the list size if all are valid. The list is
+    /// held until the handler is invoked.
+    static void verify_work(threadpool& pool, header_list_ptr headers,
+        verify_handler handler);
+
+    /// Build the light cache of the next epoch on the attached pool once
+    /// height is near the epoch boundary, so that verification does not
+    /// block on it. Does nothing while no pool is attached.
+    static void prepare_light(uint64_t height);
+
+    /// Attach the pool on which light caches are prepared, or detach it
+    /// (nullptr) before the pool is stopped.
+    static void attach(threadpool* pool);
+
 private:
+    typedef std::shared_future<LightType> LightFuture;
+
+    // A pending build is run by whichever of the preparing job and the first
+    // verifier claims it, so a verifier never waits on a queued job.
+    struct LightBuild
+    {
+        LightBuild() : claimed(false) {}
+        std::promise<LightType> promise;
+        std::atomic<bool> claimed;
+    };
+
+    typedef std::shared_ptr<LightBuild> LightPromise;
+
+    struct LightEntry
+    {
+        LightFuture future;
+        LightPromise build;
+    };
+
+    // Find the light cache of the seed, reserving it if not yet known.
+    static LightFuture find_light(h256& _seedHash, LightPromise& _build);
+    static void build_light(h256 _seedHash, LightPromise _build);
+
     MinerAux() {m_rate = 0;}
     static MinerAux* s_this;
     SharedMutex x_lights;
-    std::unordered_map<h256, std::shared_ptr<LightAllocation>> m_lights;
+    std::unordered_map<h256, LightEntry> m_lights;
+    std::vector<h256> m_lightOrder;
+    Mutex x_pool;
+    threadpool* m_pool = nullptr;
     Mutex x_fulls;
     std::condition_variable m_fullsChanged;
     std::unordered_map<h256, std::weak_ptr<FullAllocation>> m_fulls;
@@ -15,6 +15,8 @@
  */
 
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/database/address_key.hpp>
+#include <metaverse/database/block_file.hpp>
 #include <metaverse/database/data_base.hpp>
 #include <metaverse/database/define.hpp>
 #include <metaverse/database/settings.hpp>
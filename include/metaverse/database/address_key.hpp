@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_ADDRESS_KEY_HPP
+#define MVS_DATABASE_ADDRESS_KEY_HPP
+
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// The key of an address in the address asset, did, mit, balance and lock
+/// tables. It is derived from the address version and hash, so indexing a
+/// block does no Base58 encoding, only queries given an address string
+/// decode it.
+class BCD_API address_key
+{
+public:
+    static short_hash from_address(const wallet::payment_address& address);
+
+    /// Returns null_short_hash if the string is not a valid address, under
+    /// which nothing is stored.
+    static short_hash from_string(const std::string& address);
+
+    /// The key used by database versions before 0.6.7, the hash of the
+    /// Base58 encoded address, only for upgrading existing tables.
+    static short_hash legacy(const wallet::payment_address& address);
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_BLOCK_FILE_HPP
+#define MVS_DATABASE_BLOCK_FILE_HPP
+
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+#include <metaverse/database/settings.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// A flat file of the blocks of a chain, for provisioning a node without
+/// peer to peer sync. The file is a magic and format version, then one frame
+/// per block in height order: height (4), size (4) and the block itself.
+/// The node must not be running while the store is exported or imported.
+class BCD_API block_file
+{
+public:
+    typedef boost::filesystem::path path;
+
+    /// Write all stored blocks to the file.
+    static bool export_blocks(const settings& settings, const path& file);
+
+    /// Store the blocks of the file above the stored top, then build their
+    /// indexes. Blocks are parsed, hashed and checked against their merkle
+    /// root in parallel and stored in order, linked to the stored chain. They
+    /// are not otherwise validated, so the file must be trusted.
+    static bool import_blocks(const settings& settings, const path& file);
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -23,6 +23,7 @@
 
 #include <atomic>
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <boost/filesystem.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
@@ -59,6 +60,8 @@
 #include <metaverse/database/databases/address_mit_database.hpp>
 #include <metaverse/database/databases/mit_history_database.hpp>
 #include <metaverse/database/databases/blockchain_witness_profile_database.hpp>
+#include <metaverse/database/databases/address_balance_database.hpp>
+#include <metaverse/database/databases/address_lock_database.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -85,12 +88,23 @@ public:
         bool mits_exist() const;
         bool touch_witness_profiles() const;
         bool witness_profiles_exist() const;
+        bool touch_address_balances() const;
+        bool address_balances_exist() const;
+        bool touch_address_locks() const;
+        bool address_locks_exist() const;
+        bool touch_stealth() const;
+        bool stealth_exist() const;
 
         path database_lock;
         path blocks_lookup;
         path blocks_index;
         path history_lookup;
         path history_rows;
+        path stealth_prefixes;
+        path stealth_payloads;
+        path stealth_build;
+
+        // The stealth rows of the previous (row) form, removed on upgrade.
         path stealth_rows;
         path spends_lookup;
         path transactions_lookup;
@@ -115,6 +129,14 @@ public:
         path mit_history_lookup;
         path mit_history_rows;
         path witness_profiles_lookup;
+        path address_balances_lookup;
+        path address_balances_rows;
+        path address_balances_build;
+        path address_locks_lookup;
+        path address_locks_rows;
+        path address_locks_build;
+        path address_keys;
+        path index_height;
     };
 
     class db_metadata
@@ -151,6 +173,26 @@ public:
     /// If database exists then upgrades to version 64.
     static bool upgrade_version_64(const path& prefix);
 
+    /// If database exists then upgrades to version 65.
+    /// Outputs below the history height are not counted, as when pushed.
+    static bool upgrade_version_65(const path& prefix,
+        size_t history_height=0);
+
+    /// If database exists then upgrades to version 66.
+    /// Outputs below the history height are not stored, as when pushed.
+    static bool upgrade_version_66(const path& prefix,
+        size_t history_height=0);
+
+    /// If database exists then upgrades to version 67.
+    static bool upgrade_version_67(const path& prefix);
+
+    /// If database exists then upgrades to version 68.
+    static bool upgrade_version_68(const path& prefix);
+
+    /// Rewrite the transaction table with every transaction in compact form,
+    /// or in full form if not compact. The node must not be running.
+    static bool convert_transactions(const path& prefix, bool compact);
+
     static bool touch_file(const path& file_path);
     static void write_metadata(const path& metadata_path, data_base::db_metadata& metadata);
     static void read_metadata(const path& metadata_path, data_base::db_metadata& metadata);
@@ -169,6 +211,8 @@ public:
     bool create_witness_certs();
     bool create_mits();
     bool create_witness_profiles();
+    bool create_address_balances();
+    bool create_address_locks();
 
     /// Start all databases.
     bool start();
@@ -201,6 +245,34 @@ public:
     /// Throws if the chain is empty.
     bool pop(chain::block& block);
 
+    /// Commit block at given height without the address, asset and stealth
+    /// indexes and without synchronising, for bulk loading. The indexes of
+    /// such blocks are built later by build_indexes.
+    void push_unindexed(const chain::block& block, uint64_t height);
+
+    /// Synchronise all databases with disk.
+    void synchronize();
+
+    /// Read the hash table headers of the block, transaction, spend and
+    /// history tables into memory, as each lookup reads a random bucket.
+    void warm_up();
+
+    /// Log and publish the resident size of each file of those tables.
+    void report_residency() const;
+
+    /// The lowest stored height whose indexes are not built, false if the
+    /// indexes of all stored blocks are built.
+    bool unindexed_height(uint64_t& out_height) const;
+
+    /// Build the indexes of the stored blocks from the unindexed height up,
+    /// in height order. Progress is persisted, so this resumes if stopped.
+    bool build_indexes();
+
+    /// Build the indexes of the lowest unindexed block and advance the
+    /// persisted mark past it, for an indexer trailing the stored tip.
+    /// Returns true if there was nothing to index.
+    bool index_next();
+
     /* begin store asset info into  database */
 
     void push_attachment(const chain::attachment& attach, const wallet::payment_address& address,
@@ -315,8 +387,10 @@ public:
    /* begin store asset info into  database */
 
 protected:
-    data_base(const store& paths, size_t history_height, size_t stealth_height);
-    data_base(const path& prefix, size_t history_height, size_t stealth_height);
+    data_base(const store& paths, size_t history_height,
+        size_t stealth_height, bool compress_transactions=false);
+    data_base(const path& prefix, size_t history_height,
+        size_t stealth_height, bool compress_transactions=false);
 
 private:
     typedef chain::input::list inputs;
@@ -329,17 +403,41 @@ private:
     static bool initialize_witness_certs(const path& prefix);
     static bool initialize_mits(const path& prefix);
     static bool initialize_witness_profiles(const path& prefix);
+    static bool initialize_address_balances(const path& prefix,
+        size_t history_height);
+    static bool initialize_address_locks(const path& prefix,
+        size_t history_height);
+    static bool initialize_address_keys(const path& prefix);
+    static bool initialize_stealth(const path& prefix);
 
     static void uninitialize_lock(const path& lock);
     static file_lock initialize_lock(const path& lock);
 
-    void synchronize();
     void synchronize_dids();
     void synchronize_certs();
     void synchronize_witness_certs();
     void synchronize_mits();
     void synchronize_witness_profiles();
-
+    void synchronize_address_balances();
+    void synchronize_address_locks();
+    void synchronize_address_keys();
+
+    typedef std::function<void(const chain::output&,
+        const chain::output_point&, size_t)> output_visitor;
+    bool scan_outputs(const std::string& table, output_visitor visitor);
+    bool build_address_balances();
+    bool build_address_locks();
+    bool rekey_addresses();
+    void update_balance(const chain::output& output, bool credit);
+    void update_previous(const chain::output_point& previous, bool spent);
+    bool push_lock(const chain::output& output,
+        const chain::output_point& point, size_t height);
+    bool spend_lock(const chain::output& output,
+        const chain::output_point& point, bool spent);
+
+    void set_index_height(uint64_t height);
+    bool index_block(uint64_t height);
+    void push_spends(const hash_digest& tx_hash, const inputs& inputs);
     void push_inputs(const hash_digest& tx_hash, size_t height,
         const inputs& inputs);
     void push_outputs(const hash_digest& tx_hash, size_t height,
@@ -353,6 +451,11 @@ private:
     const size_t history_height_;
     const size_t stealth_height_;
 
+    // The lowest unindexed height, max_uint64 if all are indexed.
+    // Written under the chain write lock, read without it for reporting.
+    const path index_height_path_;
+    std::atomic<uint64_t> index_height_;
+
     // Atomic counter for implementing the sequential lock pattern.
     sequential_lock sequential_lock_;
 
@@ -388,6 +491,8 @@ public:
     address_mit_database address_mits;
     mit_history_database mit_history;
     blockchain_witness_profile_database witness_profiles;
+    address_balance_database address_balances;
+    address_lock_database address_locks;
 };
 
 } // namespace database
@@ -126,6 +126,9 @@ public:
     /// Delete the last row that was added to key.
     void delete_last_row(const short_hash& key);
 
+    /// Move the rows of a key to another key, for upgrading the key form.
+    bool rekey(const short_hash& from, const short_hash& to);
+
     /// Synchonise with disk.
     void sync();
 
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_ADDRESS_BALANCE_DATABASE_HPP
+#define MVS_DATABASE_ADDRESS_BALANCE_DATABASE_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/record_multimap.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// The unspent quantity of one asset symbol held by an address.
+struct BCD_API address_balance
+{
+    typedef std::vector<address_balance> list;
+
+    std::string symbol;
+
+    /// Total quantity of the unspent outputs.
+    uint64_t quantity;
+
+    /// Part of quantity in attenuation model or sequence locked outputs,
+    /// of which the locked amount depends on the height being queried.
+    uint64_t encumbered_quantity;
+
+    /// Number of such outputs.
+    uint32_t encumbered_count;
+
+    /// Number of unspent outputs, some may be of zero quantity.
+    uint32_t output_count;
+};
+
+struct BCD_API address_balance_statinfo
+{
+    /// Number of buckets used in the hashtable.
+    /// load factor = addrs / buckets
+    const size_t buckets;
+
+    /// Total number of unique addresses in the database.
+    const size_t addrs;
+
+    /// Total number of rows across all addresses.
+    const size_t rows;
+};
+
+/// This is a multimap where the key is the address hash (as used by the
+/// address asset database), with one row per asset symbol ever held by the
+/// address. Rows are updated in place as outputs are added and spent, so
+/// a row of no unspent outputs means the symbol is no longer held.
+class BCD_API address_balance_database
+{
+public:
+    /// Construct the database.
+    address_balance_database(const boost::filesystem::path& lookup_filename,
+        const boost::filesystem::path& rows_filename,
+        std::shared_ptr<shared_mutex> mutex=nullptr);
+
+    /// Close the database (all threads must first be stopped).
+    ~address_balance_database();
+
+    /// Initialize a new address balance database.
+    bool create();
+
+    /// Call before using the database.
+    bool start();
+
+    /// Call to signal a stop of current operations.
+    bool stop();
+
+    /// Call to unload the memory map.
+    bool close();
+
+    /// Add an unspent output of symbol to the key.
+    void credit(const short_hash& key, const std::string& symbol,
+        uint64_t quantity, bool encumbered);
+
+    /// Remove a spent (or popped) output of symbol from the key.
+    void debit(const short_hash& key, const std::string& symbol,
+        uint64_t quantity, bool encumbered);
+
+    /// True if the key has held any symbol, even if none is held now.
+    bool contains(const short_hash& key) const;
+
+    /// Get the symbols currently held by the key.
+    address_balance::list get(const short_hash& key) const;
+
+    /// Get the balance of one symbol, zero outputs if not held.
+    address_balance get(const short_hash& key,
+        const std::string& symbol) const;
+
+    /// Move the rows of a key to another key, for upgrading the key form.
+    bool rekey(const short_hash& from, const short_hash& to);
+
+    /// Synchonise with disk.
+    void sync();
+
+    /// Return statistical info about the database.
+    address_balance_statinfo statinfo() const;
+
+private:
+    typedef record_hash_table<short_hash> record_map;
+    typedef record_multimap<short_hash> record_multiple_map;
+
+    memory_ptr find(const short_hash& key, const std::string& symbol) const;
+    void update(const short_hash& key, const std::string& symbol,
+        uint64_t quantity, bool encumbered, bool credit);
+
+    /// Hash table used for start index lookup for linked list by address hash.
+    memory_map lookup_file_;
+    record_hash_table_header lookup_header_;
+    record_manager lookup_manager_;
+    record_map lookup_map_;
+
+    /// List of balance rows.
+    memory_map rows_file_;
+    record_manager rows_manager_;
+    record_list rows_list_;
+    record_multiple_map rows_multimap_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_ADDRESS_LOCK_DATABASE_HPP
+#define MVS_DATABASE_ADDRESS_LOCK_DATABASE_HPP
+
+#include <memory>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/record_multimap.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// A confirmed output of an address paid with a sequence lock script.
+struct BCD_API address_lock
+{
+    typedef std::vector<address_lock> list;
+
+    /// The height at which the height lock of the output expires.
+    uint64_t expiration() const;
+
+    /// True if the output is still locked on a chain of the given top height.
+    bool is_locked(uint64_t top_height) const;
+
+    chain::output_point point;
+
+    /// Height of the block containing the output.
+    uint32_t height;
+
+    /// The relative lock time of the script, as encoded in the script.
+    uint32_t sequence;
+
+    /// ETP value of the output.
+    uint64_t value;
+
+    bool is_etp;
+    bool is_asset;
+};
+
+struct BCD_API address_lock_statinfo
+{
+    /// Number of buckets used in the hashtable.
+    /// load factor = addrs / buckets
+    const size_t buckets;
+
+    /// Total number of unique addresses in the database.
+    const size_t addrs;
+
+    /// Total number of rows across all addresses.
+    const size_t rows;
+};
+
+/// This is a multimap where the key is the address hash (as used by the
+/// address asset database), with one row per sequence locked output paid
+/// to the address. Rows are marked when the output is spent, so a query
+/// only visits the locked outputs of an address, not its whole history.
+class BCD_API address_lock_database
+{
+public:
+    /// Construct the database.
+    address_lock_database(const boost::filesystem::path& lookup_filename,
+        const boost::filesystem::path& rows_filename,
+        std::shared_ptr<shared_mutex> mutex=nullptr);
+
+    /// Close the database (all threads must first be stopped).
+    ~address_lock_database();
+
+    /// Initialize a new address lock database.
+    bool create();
+
+    /// Call before using the database.
+    bool start();
+
+    /// Call to signal a stop of current operations.
+    bool stop();
+
+    /// Call to unload the memory map.
+    bool close();
+
+    /// Add a locked output to the key.
+    void store(const short_hash& key, const address_lock& lock);
+
+    /// Mark (or unmark) the locked output of the key as spent, false if
+    /// the key has no such output.
+    bool spend(const short_hash& key, const chain::output_point& point,
+        bool spent);
+
+    /// Delete the last row that was added for the key.
+    void delete_last_row(const short_hash& key);
+
+    /// True if the key has any locked output, even if spent.
+    bool contains(const short_hash& key) const;
+
+    /// Get the unspent locked outputs of the key, ordered by the height at
+    /// which their height lock expires.
+    address_lock::list get(const short_hash& key) const;
+
+    /// Move the rows of a key to another key, for upgrading the key form.
+    bool rekey(const short_hash& from, const short_hash& to);
+
+    /// Synchonise with disk.
+    void sync();
+
+    /// Return statistical info about the database.
+    address_lock_statinfo statinfo() const;
+
+private:
+    typedef record_hash_table<short_hash> record_map;
+    typedef record_multimap<short_hash> record_multiple_map;
+
+    /// Hash table used for start index lookup for linked list by address hash.
+    memory_map lookup_file_;
+    record_hash_table_header lookup_header_;
+    record_manager lookup_manager_;
+    record_map lookup_map_;
+
+    /// List of lock rows.
+    memory_map rows_file_;
+    record_manager rows_manager_;
+    record_list rows_list_;
+    record_multiple_map rows_multimap_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -84,6 +84,12 @@ public:
     /// Should be done at the end of every block write.
     void sync();
 
+    /// Read the hash table header into memory, returns the bytes read.
+    size_t warm_up();
+
+    /// The mapped and resident size of each file.
+    memory_map::residency::list residency() const;
+
     /// The index of the highest existing block, independent of gaps.
     bool top(size_t& out_height) const;
 
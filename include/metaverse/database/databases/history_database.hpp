@@ -87,6 +87,12 @@ public:
     /// Synchonise with disk.
     void sync();
 
+    /// Read the hash table header into memory, returns the bytes read.
+    size_t warm_up();
+
+    /// The mapped and resident size of each file.
+    memory_map::residency::list residency() const;
+
     /// Return statistical info about the database.
     history_statinfo statinfo() const;
 
@@ -80,6 +80,12 @@ public:
     /// Should be done at the end of every block write.
     void sync();
 
+    /// Read the hash table header into memory, returns the bytes read.
+    size_t warm_up();
+
+    /// The mapped and resident size of each file.
+    memory_map::residency::list residency() const;
+
     /// Return statistical info about the database.
     spend_statinfo statinfo() const;
 
@@ -22,8 +22,10 @@
 #define MVS_DATABASE_STEALTH_DATABASE_HPP
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
 #include <metaverse/database/define.hpp>
 #include <metaverse/database/memory/memory.hpp>
 #include <metaverse/database/memory/memory_map.hpp>
@@ -32,13 +34,20 @@
 namespace libbitcoin {
 namespace database {
 
+/// Stealth rows are kept in height order as two columns, the 32 bit prefix
+/// of each row and its payload (height, ephemeral key, address and tx).
+/// The rows of any range of heights are therefore a contiguous partition of
+/// both columns, found by binary search over the payload heights.
 class BCD_API stealth_database
 {
 public:
     typedef std::function<void(memory_ptr)> write_function;
+    typedef std::function<bool(uint32_t height,
+        const hash_digest& tx_hash)> confirm_function;
 
     /// Construct the database.
-    stealth_database(const boost::filesystem::path& rows_filename,
+    stealth_database(const boost::filesystem::path& prefixes_filename,
+        const boost::filesystem::path& payloads_filename,
         std::shared_ptr<shared_mutex> mutex=nullptr);
 
     /// Close the database (all threads must first be stopped).
@@ -56,28 +65,40 @@ public:
     /// Call to unload the memory map.
     bool close();
 
-    /// Linearly scan all entries, discarding those after from_height.
+    /// Scan the prefixes of the rows at and above from_height.
     chain::stealth_compact::list scan(const binary& filter,
         size_t from_height) const;
 
-    /// Add a stealth row to the database.
+    /// Add a stealth row to the database, rows must be added in height order.
     void store(uint32_t prefix, uint32_t height,
         const chain::stealth_compact& row);
 
-    /// Delete all rows after and including from_height (no implemented).
+    /// Delete all rows at and above from_height.
     void unlink(size_t from_height);
 
+    /// Append the confirmed rows of a stealth table of the previous (row)
+    /// form, in height order and without duplicates.
+    bool import(const boost::filesystem::path& rows_filename,
+        confirm_function confirmed);
+
     /// Synchronise storage with disk so things are consistent.
     /// Should be done at the end of every block write.
     void sync();
 
+    /// The mapped and resident size of each file.
+    memory_map::residency::list residency() const;
+
 private:
-    void write_index();
-    array_index read_index(size_t from_height) const;
+    array_index count() const;
+    array_index first_row(size_t from_height, array_index count) const;
+
+    // The prefix column.
+    memory_map prefixes_file_;
+    record_manager prefixes_manager_;
 
-    // Row entries containing stealth tx data.
-    memory_map rows_file_;
-    record_manager rows_manager_;
+    // The payload column, in the same row order.
+    memory_map payloads_file_;
+    record_manager payloads_manager_;
 };
 
 } // namespace database
@@ -42,8 +42,10 @@ class BCD_API transaction_database
 {
 public:
     /// Construct the database.
+    /// Transactions are stored in compact form if compact is set, both forms
+    /// are always readable.
     transaction_database(const boost::filesystem::path& map_filename,
-        std::shared_ptr<shared_mutex> mutex=nullptr);
+        std::shared_ptr<shared_mutex> mutex=nullptr, bool compact=false);
 
     /// Close the database (all threads must first be stopped).
     ~transaction_database();
@@ -63,6 +65,13 @@ public:
     /// Fetch transaction from its hash.
     transaction_result get(const hash_digest& hash) const;
 
+    /// Fetch all transactions of the block at height, given their hashes.
+    /// The transactions of a block are stored back to back, so this is one
+    /// hash lookup and a sequential read. Returns false if they are not
+    /// contiguous in this store, in which case fetch them one by one.
+    bool get_block(chain::transaction::list& out_transactions,
+        const hash_list& hashes, size_t height) const;
+
     /// Store a transaction in the database. Returns a unique index
     /// which can be used to reference the transaction.
     void store(size_t height, size_t index, const chain::transaction& tx);
@@ -74,6 +83,15 @@ public:
     /// Should be done at the end of every block write.
     void sync();
 
+    /// Read the hash table header into memory, returns the bytes read.
+    size_t warm_up();
+
+    /// The mapped and resident size of each file.
+    memory_map::residency::list residency() const;
+
+    /// The number of bytes in use by the stored transactions.
+    file_offset size() const;
+
 private:
     typedef slab_hash_table<hash_digest> slab_map;
 
@@ -82,6 +100,7 @@ private:
     slab_hash_table_header lookup_header_;
     slab_manager lookup_manager_;
     slab_map lookup_map_;
+    const bool compact_;
 };
 
 } // namespace database
@@ -45,8 +45,17 @@
 // Log name.
 #define LOG_DATABASE "database"
 
-// Remap safety is required if the mmap file is not fully preallocated.
-#define REMAP_SAFETY
+// Reserved mapping reserves the address space of each mmap file up front so
+// that it grows in place and never moves (64 bit posix only).
+#if defined(RESERVED_MAPPING) && (defined(_WIN32) || defined(__ANDROID__))
+    #undef RESERVED_MAPPING
+#endif
+
+// Remap safety is required if the mmap file is not fully preallocated and
+// may move as it grows.
+#ifndef RESERVED_MAPPING
+    #define REMAP_SAFETY
+#endif
 
 // Allocate safety is required for support of concurrent write operations.
 #define ALLOCATE_SAFETY
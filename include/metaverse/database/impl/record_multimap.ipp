@@ -151,6 +151,38 @@ void record_multimap<KeyType>::delete_last_row(const KeyType& key)
     ///////////////////////////////////////////////////////////////////////////
 }
 
+template <typename KeyType>
+bool record_multimap<KeyType>::rekey(const KeyType& from, const KeyType& to)
+{
+    const auto first = lookup(from);
+    if (first == records_.empty)
+        return false;
+
+    // Both keys are linked to the rows if a previous rekey was interrupted.
+    const auto existing = lookup(to);
+    if (existing != records_.empty && existing != first)
+        return false;
+
+    if (existing == records_.empty)
+    {
+        const auto write_start_info = [this, first](memory_ptr data)
+        {
+            auto serial = make_serializer(REMAP_ADDRESS(data));
+
+            // Critical Section
+            ///////////////////////////////////////////////////////////////////
+            unique_lock lock(mutex_);
+            serial.template write_little_endian<array_index>(first);
+            ///////////////////////////////////////////////////////////////////
+        };
+        map_.store(to, write_start_info);
+    }
+
+    DEBUG_ONLY(bool success =) map_.unlink(from);
+    BITCOIN_ASSERT(success);
+    return true;
+}
+
 template <typename KeyType>
 void record_multimap<KeyType>::create_new(const KeyType& key,
     write_function write)
@@ -116,6 +116,38 @@ const memory_ptr slab_hash_table<KeyType>::find(const KeyType& key) const
     return nullptr;
 }
 
+// This is limited to returning the first of multiple matching key values.
+template <typename KeyType>
+file_offset slab_hash_table<KeyType>::find_position(const KeyType& key) const
+{
+    // Find start item...
+    auto current = read_bucket_value(key);
+
+    // Iterate through list...
+    while (current != header_.empty)
+    {
+        const slab_row<KeyType> item(manager_, current);
+
+        if(item.out_of_memory())
+            break;
+
+        // Found.
+        if (item.compare(key))
+            return current;
+
+        const auto previous = current;
+        current = item.next_position();
+
+        // This may otherwise produce an infinite loop here.
+        // It indicates that a write operation has interceded.
+        // So we must return gracefully vs. looping forever.
+        if (previous == current)
+            break;
+    }
+
+    return header_.empty;
+}
+
 // This is limited to returning the last of multiple matching key values.
 template <typename KeyType>
 const memory_ptr slab_hash_table<KeyType>::rfind(const KeyType& key) const
@@ -64,7 +64,7 @@ public:
     #define REMAP_ADDRESS(ptr) ptr
     #define REMAP_DOWNGRADE(ptr, data)
     #define REMAP_INCREMENT(ptr, offset) ptr += (offset)
-    #define REMAP_ACCESSOR(ptr, mutex)
+    #define REMAP_ACCESSOR(ptr, mutex) ptr
     #define REMAP_ALLOCATOR(mutex)
     #define REMAP_READ(mutex)
     #define REMAP_WRITE(mutex)
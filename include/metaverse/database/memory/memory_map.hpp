@@ -29,6 +29,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/define.hpp>
@@ -38,12 +39,32 @@ namespace libbitcoin {
 namespace database {
 
 /// This class is thread safe, allowing concurent read and write.
-/// A change to the size of the memory map waits on and locks read and write.
+/// A change to the size of the memory map waits on and locks read and write,
+/// unless the mapping is reserved (RESERVED_MAPPING), in which case the file
+/// grows in place within its reserved address space and reads never lock.
 class BCD_API memory_map
 {
 public:
     typedef std::shared_ptr<shared_mutex> mutex_ptr;
 
+    /// The expected access pattern of the file beyond its hot region.
+    enum class access_pattern
+    {
+        normal,
+        random,
+        sequential
+    };
+
+    /// The mapped and page cache resident bytes of a file.
+    struct residency
+    {
+        typedef std::vector<residency> list;
+
+        boost::filesystem::path file;
+        size_t mapped;
+        size_t resident;
+    };
+
     /// Construct a database (start is currently called, may throw).
     memory_map(const boost::filesystem::path& filename);
     memory_map(const boost::filesystem::path& filename, mutex_ptr mutex);
@@ -67,6 +88,17 @@ public:
     /// True if stop has signaled the end of work.
     bool stopped() const;
 
+    /// Set the access pattern advised for the file and the size of its
+    /// leading hot region (a hash table header), which is always advised
+    /// as random. Applied on start and on each remap, so call before start.
+    void set_access(access_pattern pattern, size_t hot_size=0);
+
+    /// Read the hot region into the page cache, returns the bytes read.
+    size_t warm_up();
+
+    /// The resident size of the mapping (zero where not supported).
+    residency get_residency() const;
+
     size_t size() const;
     memory_ptr access();
     memory_ptr resize(size_t size);
@@ -80,12 +112,14 @@ private:
         const boost::filesystem::path& filename);
 
     size_t page();
+    size_t mapped_size() const;
     bool unmap();
     bool map(size_t size);
     bool remap(size_t size);
     bool truncate(size_t size);
     bool truncate_mapped(size_t size);
     bool validate(size_t size);
+    bool advise();
 
     void log_mapping();
     void log_resizing(size_t size);
@@ -99,6 +133,8 @@ private:
     const boost::filesystem::path filename_;
 
     // Protected by internal mutex.
+    access_pattern pattern_;
+    size_t hot_size_;
     uint8_t* data_;
     size_t file_size_;
     size_t logical_size_;
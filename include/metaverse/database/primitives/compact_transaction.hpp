@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_COMPACT_TRANSACTION_HPP
+#define MVS_DATABASE_COMPACT_TRANSACTION_HPP
+
+#include <cstdint>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// Set in the stored index of a transaction kept in compact form.
+BC_CONSTEXPR uint32_t compact_transaction_flag = 0x80000000;
+
+/// A smaller, lossless storage form of a transaction. Fixed width integers
+/// are written as variable integers and the standard pay to key hash and
+/// pay to script hash output scripts as their hash only. The transaction
+/// decodes to exactly the one encoded, so its hash is unchanged.
+class BCD_API compact_transaction
+{
+public:
+    static data_chunk to_data(const chain::transaction& tx);
+    static bool from_data(chain::transaction& tx, reader& source);
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -66,6 +66,10 @@ public:
     /// blocks we must walk backwards and delete in reverse order.
     void delete_last_row(const KeyType& key);
 
+    /// Move the rows of a key to a key that has none, without copying them.
+    /// Returns false if the source has no rows or the target has other rows.
+    bool rekey(const KeyType& from, const KeyType& to);
+
 private:
     // Add new value to existing key.
     void add_to_list(memory_ptr start_info, write_function write);
@@ -69,6 +69,10 @@ public:
         write_function write, const size_t value_size);
     /// Find the slab for a given hash. Returns a null pointer if not found.
     const memory_ptr find(const KeyType& key) const;
+
+    /// Find the slab position for a given hash. Returns empty if not found.
+    file_offset find_position(const KeyType& key) const;
+
     std::shared_ptr<std::vector<memory_ptr>> find(uint64_t index) const;
     const memory_ptr rfind(const KeyType& key) const;
     std::vector<memory_ptr> finds(const KeyType& key) const;
@@ -38,6 +38,9 @@ public:
     /// Properties.
     uint32_t history_start_height;
     uint32_t stealth_start_height;
+    bool compress_transactions;
+    bool deferred_indexes;
+    bool warm_up;
     boost::filesystem::path directory;
     boost::filesystem::path default_directory;
 };
@@ -24,12 +24,26 @@
  * 1. for DID (Digital IDentities) support, adding some new tables.
  *    these tables can be created automatically if not exist.
  *    this way only soft fork is needed when user upgrade.
+ *
+ * modify to 0.6.5
+ * 1. add the address balance table, built from the block data on upgrade.
+ *
+ * modify to 0.6.6
+ * 1. add the address lock table, built from the block data on upgrade.
+ *
+ * modify to 0.6.7
+ * 1. key the address tables by address version and hash instead of by the
+ *    hash of the encoded address, rekeyed from the block data on upgrade.
+ *
+ * modify to 0.6.8
+ * 1. store stealth rows in height order as a prefix and a payload column,
+ *    converted from the stealth row table on upgrade.
  */
-#define MVS_DATABASE_VERSION "0.6.4"
+#define MVS_DATABASE_VERSION "0.6.8"
 
 #define MVS_DATABASE_MAJOR_VERSION 0
 #define MVS_DATABASE_MINOR_VERSION 6
-#define MVS_DATABASE_PATCH_VERSION 4
+#define MVS_DATABASE_PATCH_VERSION 8
 
 #define MVS_DATABASE_VERSION_NUMBER (((MVS_DATABASE_MAJOR_VERSION)*100) + ((MVS_DATABASE_MINOR_VERSION)*10) + (MVS_DATABASE_PATCH_VERSION))
 
@@ -39,6 +39,7 @@ public:
 
     void rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_version = 1);
     void ws_request(mg_connection& nc, WebsocketMessage ws);
+    void metrics_request(mg_connection& nc, HttpMessage data);
 
 public:
     void reset(HttpMessage& data) noexcept;
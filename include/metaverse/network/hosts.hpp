@@ -25,6 +25,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -37,8 +38,13 @@ namespace network {
 
 /// This class is thread safe.
 /// The hosts class manages a thread-safe dynamic store of network addresses.
-/// The store can be loaded and saved from/to the specified file path.
-/// The file is a line-oriented set of config::authority serializations.
+/// Addresses start in the new table and move to the tried table once an
+/// outbound connection succeeds. Each keeps a history of connection
+/// failures, round trip time, delivered blocks and bans, which is used to
+/// prefer well behaved peers when fetching an address to connect to.
+/// The store is loaded and saved from/to the specified file path in a
+/// compact binary format, a line-oriented set of config::authority
+/// serializations is still accepted on load.
 /// Duplicate addresses and those with zero-valued ports are disacarded.
 
 struct address_compare{
@@ -87,18 +93,50 @@ public:
     address::list copy();
     address::list copy_seeds();
 
+    /// Record a successful outbound connection, moving host to tried.
+    virtual void connected(const address& host);
+
+    /// Fold a measured round trip time into the history of host.
+    virtual void measured(const address& host, uint32_t milliseconds);
+
+    /// Credit host with blocks it delivered.
+    virtual void delivered(const address& host, size_t blocks);
+
+    /// Record that host was banned for misbehavior.
+    virtual void banned(const address& host);
+
 private:
     typedef boost::circular_buffer<address> list;
     typedef list::iterator iterator;
 
+    // The persisted record of a host, timestamps are in unix seconds.
+    struct history
+    {
+        uint32_t last_attempt;
+        uint32_t last_success;
+        uint32_t latency;
+        uint32_t blocks;
+        uint16_t failures;
+        uint16_t bans;
+    };
+
+    typedef std::map<address, history, address_compare> history_map;
+
     iterator find(const address& host);
     iterator find(list& buffer, const address& host);
     void handle_timer(const code& ec);
 
     bool store_cache(bool succeed_clear_buffer = false);
+    bool load_cache();
+    bool load_legacy_cache();
+    history* find_history(const address& host);
+    int64_t score(const address& host) const;
+    void insert_tried(const address& host);
 
     template <typename T>
     code fetch(T& buffer, address& out, const config::authority::list& excluded_list);
+    bool fetch_scored(const list& buffer, address& out,
+        const config::authority::list& excluded_list) const;
 
     // record the seed count
     const size_t seed_count;
@@ -106,8 +144,10 @@ private:
 
     // These are protected by a mutex.
     list buffer_;
+    list tried_;
     list backup_;
     list inactive_;
+    history_map history_;
     address::list seeds_;
     std::atomic<bool> stopped_;
     mutable upgrade_mutex mutex_;
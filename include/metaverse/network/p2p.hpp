@@ -195,6 +195,18 @@ public:
     /// Get the number of addresses.
     virtual void address_count(count_handler handler);
 
+    /// Record a successful outbound connection to an address.
+    virtual void connected(const address& address);
+
+    /// Record a measured round trip time to an address.
+    virtual void measured(const address& address, uint32_t milliseconds);
+
+    /// Credit an address with blocks it delivered.
+    virtual void delivered(const address& address, size_t blocks);
+
+    /// Record that an address was banned for misbehavior.
+    virtual void banned(const address& address);
+
     address::list address_list();
     address::list seed_address_list();
 
@@ -116,7 +116,7 @@ protected:
 
     uint32_t peer_start_height();
 
-    /// Get the threadpool.
+    /// Get the threadpool of the channel.
     virtual threadpool& pool();
 
     /// Stop the channel (and the protocol).
@@ -124,9 +124,16 @@ protected:
 
     virtual bool misbehaving(int32_t howmuch);
 
+    /// Report a measured round trip time of the peer to the hosts pool.
+    void report_latency(uint32_t milliseconds);
+
+    /// Credit the peer with delivered blocks in the hosts pool.
+    void report_blocks(size_t count);
+
     bool channel_stopped() { return channel_->stopped(); }
 
 private:
+    p2p& network_;
     threadpool& pool_;
     channel::ptr channel_;
     const std::string name_;
@@ -65,7 +65,7 @@ private:
     void test_call_handler(const code& ec);
     bool handle_receive_ping(const code& ec, message::ping::ptr message);
     bool handle_receive_pong(const code& ec, message::pong::ptr message,
-        uint64_t nonce);
+        uint64_t nonce, asio::time_point sent);
 
     const settings& settings_;
 };
@@ -87,6 +87,9 @@ public:
     /// Get the authority of the far end of this socket.
     virtual const config::authority& authority() const;
 
+    /// Get the threadpool that runs the work of this proxy.
+    virtual threadpool& thread_pool();
+
     /// Get the p2p protocol version object of the peer.
     virtual message::version version() const;
 
@@ -140,6 +143,7 @@ private:
 
     void handle_request(data_chunk payload_buffer, uint32_t protocol_version_, message::heading head, size_t payload_size);
 
+    threadpool& pool_;
     const uint32_t protocol_magic_;
     const uint32_t protocol_version_;
     const config::authority authority_;
@@ -160,6 +164,12 @@ private:
     std::queue<request_callback> outbound_queue_;
     std::atomic_bool has_sent_;
 
+    // Per peer traffic, exported while the channel is running.
+    const std::string peer_label_;
+    std::atomic<bool> exported_;
+    metrics::counter::ptr received_;
+    metrics::counter::ptr sent_;
+
     std::atomic_int misbehaving_;
     static boost::detail::spinlock spinlock_;
     static std::map<config::authority, int64_t> banned_;
@@ -148,6 +148,8 @@ protected:
 
     void store(const message::network_address& address);
 
+    void connected(const message::network_address& address);
+
     /// Socket creators.
     virtual acceptor::ptr create_acceptor();
     virtual connector::ptr create_connector();
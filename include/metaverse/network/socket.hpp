@@ -50,10 +50,14 @@ public:
     /// Obtain the authority of the remote endpoint.
     config::authority get_authority() const;
 
+    /// The threadpool on which the socket completes its operations.
+    threadpool& thread_pool();
+
     /// Close the contained socket.
     virtual void close();
 
 private:
+    threadpool& pool_;
     asio::socket socket_;
     mutable upgrade_mutex mutex_;
 };
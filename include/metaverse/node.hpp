@@ -34,6 +34,7 @@
 #include <metaverse/node/sessions/session_inbound.hpp>
 #include <metaverse/node/sessions/session_manual.hpp>
 #include <metaverse/node/sessions/session_outbound.hpp>
+#include <metaverse/node/utility/block_pipeline.hpp>
 #include <metaverse/node/utility/header_queue.hpp>
 #include <metaverse/node/utility/performance.hpp>
 #include <metaverse/node/utility/reservation.hpp>
@@ -56,6 +56,7 @@ public:
     /// Options.
     bool help;
     bool initchain;
+    bool convert_transactions;
     bool settings;
     bool version;
     bool daemon;
@@ -66,6 +67,8 @@ public:
     /// Options and environment vars.
     boost::filesystem::path file;
     boost::filesystem::path data_dir;
+    boost::filesystem::path export_blocks;
+    boost::filesystem::path import_blocks;
 
     /// Settings.
     node::settings node;
@@ -23,6 +23,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 #include <metaverse/blockchain.hpp>
 #include <metaverse/network.hpp>
 #include <metaverse/node/configuration.hpp>
@@ -87,6 +88,10 @@ public:
     /// Transaction pool interface.
     virtual blockchain::transaction_pool& pool();
 
+    /// The request window and throughput of each block sync slot, empty
+    /// once block sync has completed.
+    std::vector<reservation::flow_statistics> block_sync_flows() const;
+
     // Subscriptions.
     // ------------------------------------------------------------------------
 
@@ -122,6 +127,10 @@ private:
     // These are thread safe.
     header_queue hashes_;
     const settings& settings_;
+
+    // This is protected by mutex.
+    std::weak_ptr<session_block_sync> block_sync_;
+    mutable shared_mutex block_sync_mutex_;
 protected:
     // fix me, for explorer only.
     blockchain::block_chain_impl blockchain_;
@@ -63,6 +63,11 @@ private:
     void headers_complete(const code& ec, event_handler handler);
     bool handle_receive(const code& ec, headers_ptr message,
         event_handler complete);
+    void handle_verified(size_t failed, headers_ptr message,
+        event_handler complete);
+
+    // The node threadpool, proof of work is verified off the channel thread.
+    threadpool& verify_pool_;
 
     // Thread safe and guarded by sequential header sync.
     header_queue& hashes_;
@@ -47,6 +47,9 @@ public:
 
     virtual void start(result_handler handler) override;
 
+    /// The request window and throughput of each download slot.
+    std::vector<reservation::flow_statistics> flows() const;
+
 protected:
     /// Overridden to attach and start specialized handshake.
     void attach_handshake_protocols(network::channel::ptr channel,
@@ -59,6 +62,7 @@ protected:
 
 private:
     void handle_started(const code& ec, result_handler handler);
+    void handle_synchronized(const code& ec, result_handler handler);
     void new_connection(network::connector::ptr connect,
         reservation::ptr row, result_handler handler);
     void handle_complete(const code& ec, network::channel::ptr channel, network::connector::ptr connect,
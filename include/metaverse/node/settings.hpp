@@ -38,7 +38,10 @@ public:
     /// Properties.
     uint32_t block_timeout_seconds;
     uint32_t download_connections;
+    uint32_t download_staging_blocks;
+    uint32_t download_check_threads;
     bool transaction_pool_refresh;
+    uint32_t work_trace_sample;
 };
 
 } // namespace node
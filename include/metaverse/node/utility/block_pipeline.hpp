@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_NODE_BLOCK_PIPELINE_HPP
+#define MVS_NODE_BLOCK_PIPELINE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <set>
+#include <boost/thread/condition_variable.hpp>
+#include <metaverse/blockchain.hpp>
+#include <metaverse/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Stages blocks downloaded out of order during sync, runs the context-free
+/// checks concurrently while they wait and imports them strictly in height
+/// order, thread safe.
+class BCN_API block_pipeline
+{
+public:
+    typedef std::function<void(const hash_digest&, size_t)> reject_handler;
+
+    /// Construct a pipeline that stages at most capacity heights ahead of the
+    /// lowest height not yet imported, checking them on the given number of
+    /// threads.
+    block_pipeline(blockchain::simple_chain& chain, size_t capacity,
+        size_t threads);
+
+    /// Stops the check threads, staged blocks are discarded.
+    ~block_pipeline();
+
+    /// Set the handler invoked with the hash and height of a failed block.
+    void set_reject_handler(reject_handler handler);
+
+    /// Register a height that is reserved for download.
+    void expect(size_t height);
+
+    /// The lowest expected height that has not yet been staged.
+    size_t missing() const;
+
+    /// Heights at or above this limit are not accepted for staging.
+    size_t limit() const;
+
+    /// Stage the block, false if the height is beyond the staging window.
+    bool stage(chain::block::ptr block, size_t height);
+
+    /// Wait until all importable blocks are imported, discard and log the
+    /// remainder.
+    void flush();
+
+    /// Stop importing and discard staged blocks.
+    void stop();
+
+    /// Context-free block checks (size, coinbase, merkle, distinct, work).
+    static code check(const chain::block& block);
+
+private:
+    struct entry
+    {
+        chain::block::ptr block;
+        bool checked;
+    };
+
+    typedef std::map<size_t, entry> staged_blocks;
+
+    // Check the staged block on the thread pool and record the result.
+    void do_check(chain::block::ptr block, size_t height);
+
+    // Import checked blocks from the head of the window, one thread at a time.
+    void drain();
+
+    // True if the head of the staging buffer can be imported (not locked).
+    bool importable() const;
+
+    // The lowest expected height, or max_size_t if none (not locked).
+    size_t head() const;
+
+    // Thread safe.
+    blockchain::simple_chain& chain_;
+    threadpool pool_;
+    dispatcher dispatch_;
+    const size_t capacity_;
+
+    // Protected by mutex.
+    bool stopped_;
+    bool draining_;
+    size_t checking_;
+    std::set<size_t> expected_;
+    staged_blocks staged_;
+    reject_handler rejected_;
+    mutable unique_mutex mutex_;
+    boost::condition_variable idle_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
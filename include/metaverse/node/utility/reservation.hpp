@@ -23,7 +23,9 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 #include <boost/bimap.hpp>
 #include <boost/bimap/set_of.hpp>
@@ -45,6 +47,18 @@ public:
     typedef std::shared_ptr<reservation> ptr;
     typedef std::vector<reservation::ptr> list;
 
+    typedef struct
+    {
+        size_t slot;
+        std::string peer;
+        size_t window;
+        size_t in_flight;
+        size_t remaining;
+        uint64_t round_trip;
+        double rate;
+        size_t reissued;
+    } flow_statistics;
+
     /// Construct a block reservation with the specified identifier.
     reservation(reservations& reservations, size_t slot,
         uint32_t block_timeout_seconds);
@@ -79,7 +93,26 @@ public:
     /// The current cached average block import rate excluding import time.
     void set_rate(const performance& rate);
 
-    /// The block data request message for the outstanding block hashes.
+    /// Set the peer the reservation is applied to, for reporting.
+    void set_peer(const config::authority& peer);
+
+    /// The peer the reservation is applied to.
+    std::string peer() const;
+
+    /// The request window, round trip (microseconds) and block rate (per
+    /// second) of the reservation.
+    flow_statistics flow() const;
+
+    /// The maximum number of requested blocks not yet received.
+    size_t window() const;
+
+    /// Hand the requested blocks outstanding past the deadline of this peer
+    /// to another row, and shrink the window.
+    void reissue_stalled();
+
+    /// The block data request message for the outstanding block hashes that
+    /// have not been requested and are within the import staging window,
+    /// limited so no more than the window are in flight.
     /// Set new if the preceding request was unsuccessful or discarded.
     message::get_data request(bool new_channel);
 
@@ -89,6 +122,9 @@ public:
     /// Add the block hash to the reservation.
     void insert(const hash_digest& hash, size_t height);
 
+    /// Remove the block hash at the height, return false if not found.
+    bool extract(size_t height, hash_digest& out_hash);
+
     /// Add to the blockchain, with height determined by the reservation.
     void import(chain::block::ptr block);
 
@@ -138,11 +174,21 @@ private:
     // Update rate history to reflect an additional block of the given size.
     void update_rate(size_t events, const std::chrono::microseconds& database);
 
+    // Fold a request round trip into the window, call under hash lock.
+    void adapt_window(const std::chrono::microseconds& round_trip);
+
+    // The time a request may be outstanding, call under hash lock.
+    std::chrono::microseconds stall_deadline() const;
+
+    // Remove and return the stalled requests, shrinking the window.
+    config::checkpoint::list release_stalled();
+
     // Thread safe.
     reservations& reservations_;
 
     // Protected by rate mutex.
     performance rate_;
+    std::string peer_;
     mutable upgrade_mutex rate_mutex_;
 
     // Protected by history mutex.
@@ -157,6 +203,12 @@ private:
     bool pending_;
     bool partitioned_;
     hash_heights heights_;
+    std::map<uint32_t, std::chrono::high_resolution_clock::time_point>
+        requested_;
+    size_t window_;
+    uint64_t round_trip_;
+    uint64_t minimum_round_trip_;
+    size_t reissued_;
     mutable upgrade_mutex hash_mutex_;
 
     const size_t slot_;
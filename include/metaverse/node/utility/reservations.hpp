@@ -28,6 +28,7 @@
 #include <metaverse/blockchain.hpp>
 #include <metaverse/node/define.hpp>
 #include <metaverse/node/settings.hpp>
+#include <metaverse/node/utility/block_pipeline.hpp>
 #include <metaverse/node/utility/header_queue.hpp>
 #include <metaverse/node/utility/reservation.hpp>
 
@@ -58,9 +59,25 @@ public:
     /// Return a copy of the reservation table.
     reservation::list table() const;
 
-    /// Import the given block to the blockchain at the specified height.
+    /// Stage the given block for import at the specified height.
+    /// False if the height is too far ahead of import, retry it later.
     bool import(chain::block::ptr block, size_t height);
 
+    /// Heights at or above this limit are not yet accepted for import.
+    size_t import_limit() const;
+
+    /// Move the lowest missing height to the row so it is requested next.
+    bool expedite(reservation::ptr row);
+
+    /// Give blocks that stalled on the row to the fastest other active row.
+    void reissue(reservation::ptr row, const config::checkpoint::list& blocks);
+
+    /// The request window and throughput of each row.
+    std::vector<reservation::flow_statistics> flows() const;
+
+    /// Wait for staged blocks to be imported, call once all rows complete.
+    void flush();
+
     /// Populate a starved row by taking half of the hashes from a weak row.
     bool populate(reservation::ptr minimal);
 
@@ -95,16 +112,26 @@ private:
     // Move the maximum unreserved hashes to the specified reservation.
     bool reserve(reservation::ptr minimal);
 
+    // Return a block that failed its checks to the least loaded row.
+    void reject(const hash_digest& hash, size_t height);
+
+    // Move blocks rejected while no row was active to the reservation.
+    void reclaim(reservation::ptr minimal);
+
     // Thread safe.
     header_queue& hashes_;
     blockchain::simple_chain& blockchain_;
 
     // Protected by mutex.
     reservation::list table_;
+    config::checkpoint::list rejected_;
     mutable upgrade_mutex mutex_;
 
     const uint32_t timeout_;
     std::atomic<size_t> max_request_;
+
+    // Thread safe, declared last so its threads stop before the table dies.
+    block_pipeline pipeline_;
 };
 
 } // namespace node
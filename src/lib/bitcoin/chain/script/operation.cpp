@@ -24,6 +24,7 @@
 #include <sstream>
 #include <boost/iostreams/stream.hpp>
 #include <metaverse/bitcoin/chain/script/script.hpp>
+#include <metaverse/bitcoin/chain/script/script_view.hpp>
 #include <metaverse/bitcoin/chain/point.hpp>
 #include <metaverse/bitcoin/formats/base_16.hpp>
 #include <metaverse/bitcoin/math/elliptic_curve.hpp>
@@ -485,10 +486,8 @@ bool operation::is_sign_script_hash_pattern(const operation::stack& ops)
     if (redeem_data.empty())
         return false;
 
-    script redeem_script;
-
-    if (!redeem_script.from_data(redeem_data, false, script::parse_mode::strict))
-        return false;
+    // Match the redeem script in place, an invalid one is non_standard.
+    const script_view redeem_script(redeem_data);
 
     // Is the redeem script a standard pay (output) script?
     const auto redeem_script_pattern = redeem_script.pattern();
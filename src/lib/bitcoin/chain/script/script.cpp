@@ -28,6 +28,7 @@
 #include <metaverse/bitcoin/chain/script/operation.hpp>
 #include <metaverse/bitcoin/chain/transaction.hpp>
 #include <metaverse/bitcoin/chain/attachment/asset/attenuation_model.hpp>
+#include <metaverse/bitcoin/chain/script/script_view.hpp>
 #include <metaverse/bitcoin/formats/base_16.hpp>
 #include <metaverse/bitcoin/math/elliptic_curve.hpp>
 #include <metaverse/bitcoin/math/hash.hpp>
@@ -49,6 +50,10 @@ static const data_chunk stack_false_value;
 static const data_chunk stack_true_value{ 1 };
 static constexpr uint64_t op_counter_limit = 201;
 
+// Scratch capacity above this is released after use rather than retained,
+// the largest script that can be run, so only oversized ones are released.
+static constexpr size_t scratch_retain_limit = 10000;
+
 enum class signature_parse_result
 {
     valid,
@@ -174,10 +179,13 @@ bool script::from_data(reader& source, bool prefix, parse_mode mode)
     reset();
 
     auto result = true;
-    data_chunk raw_script;
 
     if (prefix)
     {
+        // Every input and output script passes through here while a block is
+        // parsed, so the raw bytes are staged in a reused per-thread buffer.
+        static thread_local data_chunk raw_script;
+
         const auto script_length = source.read_variable_uint_little_endian();
         result = source;
         BITCOIN_ASSERT(script_length <= max_uint32);
@@ -185,19 +193,24 @@ bool script::from_data(reader& source, bool prefix, parse_mode mode)
         if (result)
         {
             auto script_length32 = static_cast<uint32_t>(script_length);
-            raw_script = source.read_data(script_length32);
-            result = source && (raw_script.size() == script_length32);
+            raw_script.resize(script_length32);
+            const auto read = source.read_data(raw_script.data(),
+                script_length32);
+            result = source && (read == script_length32);
         }
+
+        if (result)
+            result = deserialize(raw_script, mode);
+
+        if (raw_script.capacity() > scratch_retain_limit)
+            data_chunk().swap(raw_script);
     }
     else
     {
-        raw_script = source.read_data_to_eof();
-        result = source;
+        const auto raw_script = source.read_data_to_eof();
+        result = source && deserialize(raw_script, mode);
     }
 
-    if (result)
-        result = deserialize(raw_script, mode);
-
     if (!result)
         reset();
 
@@ -353,21 +366,8 @@ bool script::deserialize(const data_chunk& raw_script, parse_mode mode)
 
 bool script::parse(const data_chunk& raw_script)
 {
-    auto result = true;
-
-    if (raw_script.begin() != raw_script.end())
-    {
-        data_source istream(raw_script);
-
-        while (result && istream &&
-            (istream.peek() != std::istream::traits_type::eof()))
-        {
-            operations.emplace_back();
-            result = operations.back().from_data(istream);
-        }
-    }
-
-    return result;
+    // Decode in place, then materialize with a single stack allocation.
+    return script_view(raw_script).to_operations(operations);
 }
 
 inline hash_digest one_hash()
@@ -0,0 +1,491 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/chain/script/script_view.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <metaverse/bitcoin/math/elliptic_curve.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Longest fixed size pattern is pay_multisig with 16 keys (19 operations).
+static constexpr size_t pattern_window = 20;
+
+// operation_view
+// ----------------------------------------------------------------------------
+
+data_slice operation_view::data() const
+{
+    return data_slice(begin, end);
+}
+
+size_t operation_view::size() const
+{
+    return static_cast<size_t>(end - begin);
+}
+
+// const_iterator
+// ----------------------------------------------------------------------------
+
+script_view::const_iterator::const_iterator(const uint8_t* position,
+    const uint8_t* end)
+  : position_(position), end_(end), next_(end),
+    current_{ opcode::bad_operation, end, end }, valid_(true)
+{
+    decode();
+}
+
+// Mirrors operation::from_data, without copying the push data.
+void script_view::const_iterator::decode()
+{
+    valid_ = true;
+    next_ = end_;
+    current_ = { opcode::bad_operation, end_, end_ };
+
+    if (position_ == end_)
+        return;
+
+    auto cursor = position_;
+    const auto byte = *cursor++;
+    const auto available = [this, &cursor]()
+    {
+        return static_cast<uint64_t>(end_ - cursor);
+    };
+
+    auto code = static_cast<opcode>(byte);
+    if (0 < byte && byte <= 75)
+        code = opcode::special;
+
+    uint64_t size = 0;
+    switch (code)
+    {
+        case opcode::special:
+            size = byte;
+            break;
+
+        case opcode::pushdata1:
+            if (available() < 1)
+            {
+                valid_ = false;
+                return;
+            }
+
+            size = cursor[0];
+            cursor += 1;
+            break;
+
+        case opcode::pushdata2:
+            if (available() < 2)
+            {
+                valid_ = false;
+                return;
+            }
+
+            size = uint64_t(cursor[0]) | (uint64_t(cursor[1]) << 8);
+            cursor += 2;
+            break;
+
+        case opcode::pushdata4:
+            if (available() < 4)
+            {
+                valid_ = false;
+                return;
+            }
+
+            size = uint64_t(cursor[0]) | (uint64_t(cursor[1]) << 8) |
+                (uint64_t(cursor[2]) << 16) | (uint64_t(cursor[3]) << 24);
+            cursor += 4;
+            break;
+
+        default:
+            break;
+    }
+
+    if (available() < size)
+    {
+        valid_ = false;
+        return;
+    }
+
+    current_ = { code, cursor, cursor + size };
+    next_ = cursor + size;
+}
+
+script_view::const_iterator::reference
+script_view::const_iterator::operator*() const
+{
+    return current_;
+}
+
+script_view::const_iterator::pointer
+script_view::const_iterator::operator->() const
+{
+    return &current_;
+}
+
+script_view::const_iterator& script_view::const_iterator::operator++()
+{
+    position_ = next_;
+    decode();
+    return *this;
+}
+
+script_view::const_iterator script_view::const_iterator::operator++(int)
+{
+    auto copy = *this;
+    ++(*this);
+    return copy;
+}
+
+bool script_view::const_iterator::operator==(
+    const const_iterator& other) const
+{
+    return position_ == other.position_;
+}
+
+bool script_view::const_iterator::operator!=(
+    const const_iterator& other) const
+{
+    return !(*this == other);
+}
+
+bool script_view::const_iterator::valid() const
+{
+    return valid_;
+}
+
+// script_view
+// ----------------------------------------------------------------------------
+
+script_view::script_view(data_slice raw)
+  : begin_(raw.begin()), end_(raw.end()), size_(0), valid_(true)
+{
+    for (const_iterator it(begin_, end_); it != end(); ++it)
+    {
+        if (!it.valid())
+        {
+            valid_ = false;
+            size_ = 0;
+            break;
+        }
+
+        ++size_;
+    }
+}
+
+script_view::const_iterator script_view::begin() const
+{
+    return valid_ ? const_iterator(begin_, end_) : end();
+}
+
+script_view::const_iterator script_view::end() const
+{
+    return const_iterator(end_, end_);
+}
+
+data_slice script_view::raw() const
+{
+    return data_slice(begin_, end_);
+}
+
+bool script_view::is_valid() const
+{
+    return valid_;
+}
+
+bool script_view::empty() const
+{
+    return size_ == 0;
+}
+
+size_t script_view::size() const
+{
+    return size_;
+}
+
+operation_view script_view::at(size_t index) const
+{
+    BITCOIN_ASSERT(index < size_);
+    auto it = begin();
+    for (size_t position = 0; position < index; ++position)
+        ++it;
+
+    return *it;
+}
+
+operation_view script_view::back() const
+{
+    return at(size_ - 1);
+}
+
+bool script_view::is_push_only() const
+{
+    return std::all_of(begin(), end(), [](const operation_view& op)
+    {
+        return operation::is_push(op.code);
+    });
+}
+
+bool script_view::to_operations(operation::stack& out) const
+{
+    out.clear();
+    if (!valid_)
+        return false;
+
+    out.reserve(size_);
+    for (const auto& op: *this)
+        out.push_back({ op.code, data_chunk(op.begin, op.end) });
+
+    return true;
+}
+
+// Pattern matching, equivalent to the operation::is_*_pattern predicates.
+// ----------------------------------------------------------------------------
+
+static bool is_null_data(const operation_view* ops, size_t count)
+{
+    return count == 2
+        && ops[0].code == opcode::return_
+        && ops[1].code == opcode::special
+        && ops[1].size() <= operation::max_null_data_size;
+}
+
+static bool is_pay_multisig(const operation_view* ops, size_t count)
+{
+    static constexpr size_t op_1 = static_cast<uint8_t>(opcode::op_1);
+    static constexpr size_t op_16 = static_cast<uint8_t>(opcode::op_16);
+
+    if (count < 4 || ops[count - 1].code != opcode::checkmultisig)
+        return false;
+
+    const auto op_m = static_cast<uint8_t>(ops[0].code);
+    const auto op_n = static_cast<uint8_t>(ops[count - 2].code);
+
+    if (op_m < op_1 || op_m > op_n || op_n < op_1 || op_n > op_16)
+        return false;
+
+    const auto n = op_n - op_1 + 1u;
+    const auto points = count - 3u;
+
+    if (n != points)
+        return false;
+
+    for (size_t index = 1; index < count - 2; ++index)
+        if (!is_public_key(ops[index].data()))
+            return false;
+
+    return true;
+}
+
+static bool is_pay_public_key(const operation_view* ops, size_t count)
+{
+    return count == 2
+        && ops[0].code == opcode::special
+        && is_public_key(ops[0].data())
+        && ops[1].code == opcode::checksig;
+}
+
+static bool is_pay_key_hash(const operation_view* ops, size_t count)
+{
+    return count == 5
+        && ops[0].code == opcode::dup
+        && ops[1].code == opcode::hash160
+        && ops[2].code == opcode::special
+        && ops[2].size() == short_hash_size
+        && ops[3].code == opcode::equalverify
+        && ops[4].code == opcode::checksig;
+}
+
+static bool is_pay_key_hash_with_lock_height(const operation_view* ops,
+    size_t count)
+{
+    return count == 7
+        && ops[0].code == opcode::special
+        && ops[1].code == opcode::numequalverify
+        && ops[2].code == opcode::dup
+        && ops[3].code == opcode::hash160
+        && ops[4].code == opcode::special
+        && ops[4].size() == short_hash_size
+        && ops[5].code == opcode::equalverify
+        && ops[6].code == opcode::checksig;
+}
+
+static bool is_pay_script_hash(const operation_view* ops, size_t count)
+{
+    return count == 3
+        && ops[0].code == opcode::hash160
+        && ops[1].code == opcode::special
+        && ops[1].size() == short_hash_size
+        && ops[2].code == opcode::equal;
+}
+
+static bool is_pay_blackhole(const operation_view* ops, size_t count)
+{
+    return count == 1
+        && ops[0].code == opcode::return_;
+}
+
+static bool is_pay_key_hash_with_attenuation_model(const operation_view* ops,
+    size_t count)
+{
+    return count == 8
+        && ops[0].code == opcode::pushdata2
+        && ops[1].code == opcode::special
+        && ops[2].code == opcode::checkattenuationverify
+        && ops[3].code == opcode::dup
+        && ops[4].code == opcode::hash160
+        && ops[5].code == opcode::special
+        && ops[5].size() == short_hash_size
+        && ops[6].code == opcode::equalverify
+        && ops[7].code == opcode::checksig;
+}
+
+static bool is_pay_key_hash_with_sequence_lock(const operation_view* ops,
+    size_t count)
+{
+    return count == 8
+        && ops[0].code == opcode::special
+        && ops[1].code == opcode::checksequenceverify
+        && ops[2].code == opcode::drop
+        && ops[3].code == opcode::dup
+        && ops[4].code == opcode::hash160
+        && ops[5].code == opcode::special
+        && ops[5].size() == short_hash_size
+        && ops[6].code == opcode::equalverify
+        && ops[7].code == opcode::checksig;
+}
+
+// Sign patterns are push only and may exceed the window, so are matched in a
+// single walk of the script.
+static script_pattern sign_pattern(const script_view& view)
+{
+    const auto count = view.size();
+    if (count == 0)
+        return script_pattern::non_standard;
+
+    auto first = opcode::bad_operation;
+    auto middle_special = true;
+    size_t index = 0;
+    const uint8_t* second_begin = nullptr;
+    const uint8_t* second_end = nullptr;
+    const uint8_t* last_begin = nullptr;
+    const uint8_t* last_end = nullptr;
+
+    for (const auto& op: view)
+    {
+        if (!operation::is_push(op.code))
+            return script_pattern::non_standard;
+
+        if (index == 0)
+            first = op.code;
+
+        if (index == 1)
+        {
+            second_begin = op.begin;
+            second_end = op.end;
+        }
+
+        if (index > 0 && index < count - 1 && op.code != opcode::special)
+            middle_special = false;
+
+        last_begin = op.begin;
+        last_end = op.end;
+        ++index;
+    }
+
+    if (count >= 2 && first == opcode::zero && middle_special)
+        return script_pattern::sign_multisig;
+
+    if (count == 1)
+        return script_pattern::sign_public_key;
+
+    if (count == 2 && is_public_key(data_slice(second_begin, second_end)))
+        return script_pattern::sign_key_hash;
+
+    if (count == 3 && is_public_key(data_slice(second_begin, second_end)))
+        return script_pattern::sign_key_hash_with_lock_height;
+
+    // Is the redeem script a standard pay (output) script?
+    if (last_begin == last_end)
+        return script_pattern::non_standard;
+
+    switch (script_view(data_slice(last_begin, last_end)).pattern())
+    {
+        case script_pattern::pay_multisig:
+        case script_pattern::pay_public_key:
+        case script_pattern::pay_key_hash:
+        case script_pattern::pay_script_hash:
+        case script_pattern::null_data:
+            return script_pattern::sign_script_hash;
+        default:
+            return script_pattern::non_standard;
+    }
+}
+
+script_pattern script_view::pattern() const
+{
+    if (!valid_ || size_ == 0)
+        return script_pattern::non_standard;
+
+    if (size_ <= pattern_window)
+    {
+        operation_view ops[pattern_window];
+        auto op = begin();
+        for (size_t index = 0; index < size_; ++index, ++op)
+            ops[index] = *op;
+
+        if (is_null_data(ops, size_))
+            return script_pattern::null_data;
+
+        if (is_pay_multisig(ops, size_))
+            return script_pattern::pay_multisig;
+
+        if (is_pay_public_key(ops, size_))
+            return script_pattern::pay_public_key;
+
+        if (is_pay_key_hash(ops, size_))
+            return script_pattern::pay_key_hash;
+
+        if (is_pay_key_hash_with_lock_height(ops, size_))
+            return script_pattern::pay_key_hash_with_lock_height;
+
+        if (is_pay_script_hash(ops, size_))
+            return script_pattern::pay_script_hash;
+
+        // These all contain a non-push operation, so cannot be sign patterns.
+        if (is_pay_blackhole(ops, size_))
+            return script_pattern::pay_blackhole_address;
+
+        if (is_pay_key_hash_with_attenuation_model(ops, size_))
+            return script_pattern::pay_key_hash_with_attenuation_model;
+
+        if (is_pay_key_hash_with_sequence_lock(ops, size_))
+            return script_pattern::pay_key_hash_with_sequence_lock;
+    }
+
+    return sign_pattern(*this);
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -40,10 +40,11 @@ namespace chain {
 // default constructors
 
 transaction::transaction()
-  : version(0), locktime(0), hash_(nullptr)
+  : version(0), locktime(0), hash_state_(hash_empty)
 {
 }
 
+// A copy is made to be changed, so it hashes itself when asked.
 transaction::transaction(const transaction& other)
   : transaction(other.version, other.locktime, other.inputs, other.outputs)
 {
@@ -55,7 +56,7 @@ transaction::transaction(uint32_t version, uint32_t locktime,
     locktime(locktime),
     inputs(inputs),
     outputs(outputs),
-    hash_(nullptr)
+    hash_state_(hash_empty)
 {
 }
 
@@ -64,6 +65,7 @@ transaction::transaction(transaction&& other)
         std::forward<input::list>(other.inputs),
         std::forward<output::list>(other.outputs))
 {
+    move_hash(other);
 }
 
 transaction::transaction(uint32_t version, uint32_t locktime,
@@ -72,7 +74,7 @@ transaction::transaction(uint32_t version, uint32_t locktime,
     locktime(locktime),
     inputs(std::forward<input::list>(inputs)),
     outputs(std::forward<output::list>(outputs)),
-    hash_(nullptr)
+    hash_state_(hash_empty)
 {
 }
 
@@ -82,6 +84,7 @@ transaction& transaction::operator=(transaction&& other)
     locktime = other.locktime;
     inputs = std::move(other.inputs);
     outputs = std::move(other.outputs);
+    move_hash(other);
     return *this;
 }
 
@@ -92,9 +95,32 @@ transaction& transaction::operator=(const transaction& other)
     locktime = other.locktime;
     inputs = other.inputs;
     outputs = other.outputs;
+    hash_state_.store(hash_empty, std::memory_order_release);
     return *this;
 }
 
+void transaction::set_hash(const hash_digest& hash)
+{
+    hash_ = hash;
+    hash_state_.store(hash_ready, std::memory_order_release);
+}
+
+// The moved from transaction no longer holds what it hashed.
+void transaction::move_hash(transaction& other)
+{
+    const auto state = other.hash_state_.exchange(hash_empty,
+        std::memory_order_acq_rel);
+
+    if (state == hash_ready)
+    {
+        hash_ = other.hash_;
+        hash_state_.store(hash_ready, std::memory_order_release);
+        return;
+    }
+
+    hash_state_.store(hash_empty, std::memory_order_release);
+}
+
 bool transaction::is_valid() const
 {
     return (version != 0) || (locktime != 0) || !inputs.empty() ||
@@ -109,10 +135,7 @@ void transaction::reset()
     inputs.shrink_to_fit();
     outputs.clear();
     outputs.shrink_to_fit();
-
-    mutex_.lock();
-    hash_.reset();
-    mutex_.unlock();
+    hash_state_.store(hash_empty, std::memory_order_release);
 }
 
 bool transaction::from_data_t(reader& source)
@@ -224,23 +247,26 @@ std::string transaction::to_string(uint32_t flags) const
 
 hash_digest transaction::hash() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (!hash_)
+    if (hash_state_.load(std::memory_order_acquire) == hash_ready)
+        return hash_;
+
+    // Serialize into a single exact-size buffer rather than a growing one.
+    data_chunk data;
+    data.reserve(serialized_size());
+    data_sink ostream(data);
+    to_data(ostream);
+    ostream.flush();
+    const auto hash = bitcoin_hash(data);
+
+    // Concurrent first callers may each compute the hash, only one publishes.
+    uint8_t expected = hash_empty;
+    if (hash_state_.compare_exchange_strong(expected, hash_writing,
+        std::memory_order_acq_rel))
     {
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        mutex_.unlock_upgrade_and_lock();
-        hash_.reset(new hash_digest(bitcoin_hash(to_data())));
-        mutex_.unlock_and_lock_upgrade();
-        //---------------------------------------------------------------------
+        hash_ = hash;
+        hash_state_.store(hash_ready, std::memory_order_release);
     }
 
-    hash_digest hash = *hash_;
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
-
     return hash;
 }
 
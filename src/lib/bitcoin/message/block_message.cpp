@@ -67,7 +67,7 @@ block_message::block_message()
 }
 
 block_message::block_message(const block& other)
-  : block(other)
+  : block(other), originator_(0)
 {
 }
 
@@ -83,7 +83,7 @@ block_message::block_message(const chain::header& header,
 }
 
 block_message::block_message(block&& other)
-  : block(std::forward<block>(other))
+  : block(std::forward<block>(other)), originator_(0)
 {
 }
 
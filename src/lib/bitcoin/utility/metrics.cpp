@@ -0,0 +1,342 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/metrics.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <metaverse/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+
+// Bucket bounds reported to prometheus, powers of four from 1us to ~1073s.
+static const size_t exported_bounds = 16;
+
+// Counter.
+// ----------------------------------------------------------------------------
+
+metrics::counter::counter()
+  : value_(0)
+{
+}
+
+void metrics::counter::increment(uint64_t value)
+{
+    value_.fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t metrics::counter::value() const
+{
+    return value_.load(std::memory_order_relaxed);
+}
+
+// Gauge.
+// ----------------------------------------------------------------------------
+
+metrics::gauge::gauge()
+  : value_(0)
+{
+}
+
+void metrics::gauge::set(int64_t value)
+{
+    value_.store(value, std::memory_order_relaxed);
+}
+
+void metrics::gauge::add(int64_t value)
+{
+    value_.fetch_add(value, std::memory_order_relaxed);
+}
+
+void metrics::gauge::subtract(int64_t value)
+{
+    value_.fetch_sub(value, std::memory_order_relaxed);
+}
+
+int64_t metrics::gauge::value() const
+{
+    return value_.load(std::memory_order_relaxed);
+}
+
+// Histogram.
+// ----------------------------------------------------------------------------
+
+metrics::histogram::histogram()
+  : count_(0), sum_(0)
+{
+    for (auto& bucket: buckets_)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+// Values below 4 map one to one, above that the two bits following the most
+// significant bit select one of four linear sub buckets.
+size_t metrics::histogram::to_bucket(uint64_t microseconds)
+{
+    if (microseconds < sub_buckets)
+        return static_cast<size_t>(microseconds);
+
+    size_t msb = 63;
+    while ((microseconds >> msb) == 0)
+        --msb;
+
+    const auto sub = (microseconds >> (msb - 2)) & (sub_buckets - 1);
+    return (msb - 1) * sub_buckets + static_cast<size_t>(sub);
+}
+
+uint64_t metrics::histogram::lower_bound(size_t bucket)
+{
+    if (bucket < sub_buckets)
+        return bucket;
+
+    const auto msb = bucket / sub_buckets + 1;
+    const uint64_t sub = bucket % sub_buckets;
+    return (sub_buckets + sub) << (msb - 2);
+}
+
+uint64_t metrics::histogram::upper_bound(size_t bucket)
+{
+    if (bucket < sub_buckets)
+        return bucket + 1;
+
+    const auto msb = bucket / sub_buckets + 1;
+    return lower_bound(bucket) + (uint64_t(1) << (msb - 2));
+}
+
+// A sample is counted in the bucket of the value below it, so each bucket
+// holds (lower, upper] and the count at or below a bucket bound is exact.
+void metrics::histogram::record(uint64_t microseconds)
+{
+    const auto bucket = to_bucket(microseconds == 0 ? 0 : microseconds - 1);
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(microseconds, std::memory_order_relaxed);
+}
+
+uint64_t metrics::histogram::count() const
+{
+    return count_.load(std::memory_order_relaxed);
+}
+
+uint64_t metrics::histogram::sum() const
+{
+    return sum_.load(std::memory_order_relaxed);
+}
+
+uint64_t metrics::histogram::count_at_most(uint64_t microseconds) const
+{
+    uint64_t total = 0;
+    for (size_t bucket = 0; bucket < bucket_count; ++bucket)
+    {
+        if (upper_bound(bucket) > microseconds)
+            break;
+
+        total += buckets_[bucket].load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+uint64_t metrics::histogram::quantile(double fraction) const
+{
+    const auto samples = count();
+    if (samples == 0)
+        return 0;
+
+    const auto rank = static_cast<uint64_t>(fraction * samples);
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < bucket_count; ++bucket)
+    {
+        seen += buckets_[bucket].load(std::memory_order_relaxed);
+        if (seen > rank)
+            return (lower_bound(bucket) + upper_bound(bucket) + 1) / 2;
+    }
+
+    return lower_bound(bucket_count - 1);
+}
+
+// Scoped timer.
+// ----------------------------------------------------------------------------
+
+metrics::scoped_timer::scoped_timer(histogram& target)
+  : target_(target), start_(clock::now())
+{
+}
+
+metrics::scoped_timer::~scoped_timer()
+{
+    target_.record(elapsed());
+}
+
+uint64_t metrics::scoped_timer::elapsed() const
+{
+    return since(start_);
+}
+
+uint64_t metrics::since(const scoped_timer::clock::time_point& start)
+{
+    const auto delta = scoped_timer::clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::microseconds>(delta).count();
+}
+
+// Registry.
+// ----------------------------------------------------------------------------
+
+metrics& metrics::instance()
+{
+    static metrics instance;
+    return instance;
+}
+
+metrics::family& metrics::get_family(const std::string& name,
+    const std::string& help, kind type)
+{
+    auto it = families_.find(name);
+    if (it == families_.end())
+    {
+        it = families_.emplace(name, family{}).first;
+        it->second.type = type;
+        it->second.help = help;
+    }
+
+    BITCOIN_ASSERT_MSG(it->second.type == type, "Metric type mismatch.");
+    return it->second;
+}
+
+metrics::counter::ptr metrics::make_counter(const std::string& name,
+    const std::string& help, const std::string& labels)
+{
+    unique_lock lock(mutex_);
+    auto& series = get_family(name, help, kind::counter).counters[labels];
+    if (!series)
+        series = std::make_shared<counter>();
+
+    return series;
+}
+
+metrics::gauge::ptr metrics::make_gauge(const std::string& name,
+    const std::string& help, const std::string& labels)
+{
+    unique_lock lock(mutex_);
+    auto& series = get_family(name, help, kind::gauge).gauges[labels];
+    if (!series)
+        series = std::make_shared<gauge>();
+
+    return series;
+}
+
+metrics::histogram::ptr metrics::make_histogram(const std::string& name,
+    const std::string& help, const std::string& labels)
+{
+    unique_lock lock(mutex_);
+    auto& series = get_family(name, help, kind::histogram).histograms[labels];
+    if (!series)
+        series = std::make_shared<histogram>();
+
+    return series;
+}
+
+void metrics::remove(const std::string& name, const std::string& labels)
+{
+    unique_lock lock(mutex_);
+    const auto it = families_.find(name);
+    if (it == families_.end())
+        return;
+
+    it->second.counters.erase(labels);
+    it->second.gauges.erase(labels);
+    it->second.histograms.erase(labels);
+}
+
+static std::string series_name(const std::string& name,
+    const std::string& labels, const std::string& extra="")
+{
+    if (labels.empty() && extra.empty())
+        return name;
+
+    const auto separator = labels.empty() || extra.empty() ? "" : ",";
+    return name + "{" + labels + separator + extra + "}";
+}
+
+std::string metrics::to_prometheus() const
+{
+    std::ostringstream out;
+    out << std::setprecision(9);
+
+    shared_lock lock(mutex_);
+    for (const auto& entry: families_)
+    {
+        const auto& name = entry.first;
+        const auto& family = entry.second;
+
+        out << "# HELP " << name << " " << family.help << "\n";
+
+        switch (family.type)
+        {
+            case kind::counter:
+                out << "# TYPE " << name << " counter\n";
+                for (const auto& series: family.counters)
+                    out << series_name(name, series.first) << " "
+                        << series.second->value() << "\n";
+                break;
+
+            case kind::gauge:
+                out << "# TYPE " << name << " gauge\n";
+                for (const auto& series: family.gauges)
+                    out << series_name(name, series.first) << " "
+                        << series.second->value() << "\n";
+                break;
+
+            case kind::histogram:
+                out << "# TYPE " << name << " histogram\n";
+                for (const auto& series: family.histograms)
+                {
+                    const auto& labels = series.first;
+                    const auto& values = *series.second;
+
+                    // Samples are microseconds, prometheus expects seconds.
+                    uint64_t bound = 1;
+                    for (size_t index = 0; index < exported_bounds; ++index)
+                    {
+                        std::ostringstream le;
+                        le << "le=\"" << std::setprecision(9)
+                            << bound / 1e6 << "\"";
+                        out << series_name(name + "_bucket", labels, le.str())
+                            << " " << values.count_at_most(bound) << "\n";
+                        bound <<= 2;
+                    }
+
+                    out << series_name(name + "_bucket", labels, "le=\"+Inf\"")
+                        << " " << values.count() << "\n";
+                    out << series_name(name + "_sum", labels) << " "
+                        << values.sum() / 1e6 << "\n";
+                    out << series_name(name + "_count", labels) << " "
+                        << values.count() << "\n";
+                }
+                break;
+        }
+    }
+
+    return out.str();
+}
+
+} // namespace libbitcoin
@@ -0,0 +1,190 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/task.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace libbitcoin {
+
+static std::atomic<size_t> trace_sample(0);
+
+// Each thread keeps the nodes its jobs released, up to a bound, for the jobs
+// it posts next. Nodes beyond the bound, and the list itself when the thread
+// exits, are deleted, so no lock is taken and the memory is returned.
+static const size_t free_limit = 1024;
+
+struct free_list
+{
+    ~free_list();
+
+    task* head = nullptr;
+    size_t size = 0;
+};
+
+// Trivially destructible, so still readable by destructors that release
+// jobs after the list of the exiting thread is gone.
+static thread_local bool free_closed = false;
+static thread_local free_list free_nodes;
+
+free_list::~free_list()
+{
+    free_closed = true;
+    while (head != nullptr)
+        delete task::pop(head);
+}
+
+task::queue::queue(const std::string& name, const std::string& type)
+  : backlog_(0),
+    posted_(0),
+    depth_(*metrics::instance().make_gauge("mvs_work_backlog",
+        "Jobs posted to work queues and not yet run.",
+        "queue=\"" + name + "\",type=\"" + type + "\"")),
+    wait_(*metrics::instance().make_histogram("mvs_work_wait_seconds",
+        "Sampled time from posting a job to running it.",
+        "queue=\"" + name + "\",type=\"" + type + "\"")),
+    run_(*metrics::instance().make_histogram("mvs_work_run_seconds",
+        "Sampled time spent running a job.",
+        "queue=\"" + name + "\",type=\"" + type + "\""))
+{
+}
+
+size_t task::queue::backlog() const
+{
+    return backlog_.load();
+}
+
+void task::set_trace_sample(size_t rate)
+{
+    trace_sample.store(rate, std::memory_order_relaxed);
+}
+
+task::task()
+  : callable_(nullptr),
+    inline_(false),
+    traced_(false),
+    references_(0),
+    next_(nullptr)
+{
+}
+
+task* task::acquire()
+{
+    if (free_closed || free_nodes.head == nullptr)
+        return new task;
+
+    free_nodes.size--;
+    return pop(free_nodes.head);
+}
+
+void task::recycle(task* node)
+{
+    if (free_closed || free_nodes.size == free_limit)
+    {
+        delete node;
+        return;
+    }
+
+    free_nodes.size++;
+    node->next_ = free_nodes.head;
+    free_nodes.head = node;
+}
+
+task* task::pop(task*& head)
+{
+    const auto node = head;
+    head = node->next_;
+    node->next_ = nullptr;
+    return node;
+}
+
+void task::start(const queue::ptr& owner)
+{
+    queue_ = owner;
+    queue_->backlog_++;
+    queue_->depth_.add(1);
+
+    const auto rate = trace_sample.load(std::memory_order_relaxed);
+    traced_ = rate != 0 &&
+        queue_->posted_.fetch_add(1, std::memory_order_relaxed) % rate == 0;
+
+    if (traced_)
+        posted_ = clock::now();
+}
+
+void task::invoke()
+{
+    // A strand wrapped job may be copied, but is run only once.
+    if (callable_ == nullptr)
+        return;
+
+    if (traced_)
+    {
+        const auto start = clock::now();
+        queue_->wait_.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                start - posted_).count()));
+        callable_->invoke();
+        queue_->run_.record(metrics::since(start));
+    }
+    else
+    {
+        callable_->invoke();
+    }
+
+    // Release the bound arguments as soon as the job has run.
+    finish();
+}
+
+void task::finish()
+{
+    if (inline_)
+        callable_->~callable();
+    else
+        delete callable_;
+
+    callable_ = nullptr;
+    queue_->backlog_--;
+    queue_->depth_.subtract(1);
+}
+
+void intrusive_ptr_add_ref(task* node)
+{
+    node->references_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void intrusive_ptr_release(task* node)
+{
+    if (node->references_.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    // Dropped without running (e.g. the service was stopped).
+    if (node->callable_ != nullptr)
+        node->finish();
+
+    node->queue_.reset();
+    task::recycle(node);
+}
+
+} // namespace libbitcoin
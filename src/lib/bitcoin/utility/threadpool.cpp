@@ -29,6 +29,9 @@
 namespace libbitcoin {
 
 threadpool::threadpool(size_t number_threads, thread_priority priority)
+  : size_(0),
+    active_shards_(0),
+    next_shard_(0)
 {
     spawn(number_threads, priority);
 }
@@ -59,29 +62,66 @@ void threadpool::spawn_once(thread_priority priority)
     };
 
     threads_.push_back(asio::thread(action));
+    ++size_;
+}
+
+void threadpool::spawn_shards(size_t number_shards,
+    thread_priority priority)
+{
+    while (shards_.size() < number_shards)
+        shards_.push_back(std::make_shared<threadpool>());
+
+    for (size_t i = 0; i < number_shards; ++i)
+        shards_[i]->spawn(1, priority);
+
+    active_shards_ = number_shards;
+}
+
+threadpool& threadpool::shard()
+{
+    const size_t active = active_shards_;
+    if (active == 0)
+        return *this;
+
+    return *shards_[next_shard_++ % active];
 }
 
 void threadpool::abort()
 {
+    for (auto& shard: shards_)
+        shard->abort();
+
     service_.stop();
 }
 
 void threadpool::shutdown()
 {
+    for (auto& shard: shards_)
+        shard->shutdown();
+
     work_ = nullptr;
 }
 
 void threadpool::join()
 {
+    for (auto& shard: shards_)
+        shard->join();
+
     for (auto& thread: threads_)
         if (thread.joinable())
             thread.join();
 
     // This allows the pool to be cleanly restarted by calling spawn.
     threads_.clear();
+    size_ = 0;
     service_.reset();
 }
 
+size_t threadpool::size() const
+{
+    return size_;
+}
+
 asio::service& threadpool::service()
 {
     return service_;
@@ -23,14 +23,15 @@
 #include <memory>
 #include <string>
 #include <metaverse/bitcoin/utility/delegates.hpp>
+#include <metaverse/bitcoin/utility/task.hpp>
 #include <metaverse/bitcoin/utility/threadpool.hpp>
 
 namespace libbitcoin {
 
 work::work(threadpool& pool, const std::string& name)
-  : ordered_(std::make_shared<monitor::count>(0)),
-    unordered_(std::make_shared<monitor::count>(0)),
-    concurrent_(std::make_shared<monitor::count>(0)),
+  : ordered_(std::make_shared<task::queue>(name, ORDERED)),
+    unordered_(std::make_shared<task::queue>(name, UNORDERED)),
+    concurrent_(std::make_shared<task::queue>(name, CONCURRENT)),
     service_(pool.service()),
     strand_(service_),
     name_(name)
@@ -39,17 +40,17 @@ work::work(threadpool& pool, const std::string& name)
 
 size_t work::ordered_backlog()
 {
-    return ordered_->load();
+    return ordered_->backlog();
 }
 
 size_t work::unordered_backlog()
 {
-    return unordered_->load();
+    return unordered_->backlog();
 }
 
 size_t work::concurrent_backlog()
 {
-    return concurrent_->load();
+    return concurrent_->backlog();
 }
 
 size_t work::combined_backlog()
@@ -57,4 +58,9 @@ size_t work::combined_backlog()
     return ordered_backlog() + unordered_backlog() + concurrent_backlog();
 }
 
+void work::set_trace_sample(size_t rate)
+{
+    task::set_trace_sample(rate);
+}
+
 } // namespace libbitcoin
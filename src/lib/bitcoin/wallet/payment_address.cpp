@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <string>
 #include <boost/program_options.hpp>
+#include <metaverse/bitcoin/chain/script/script_view.hpp>
 #include <metaverse/bitcoin/formats/base_58.hpp>
 #include <metaverse/bitcoin/math/checksum.hpp>
 #include <metaverse/bitcoin/math/hash.hpp>
@@ -232,6 +233,21 @@ std::ostream& operator<<(std::ostream& out, const payment_address& of)
 // Static functions.
 // ----------------------------------------------------------------------------
 
+// The redeem script is matched in place, a strictly parsed script serializes
+// back to the same bytes, so the script hash is taken over the raw data.
+payment_address payment_address::from_redeem_script(data_slice redeem_data)
+{
+    if (redeem_data.empty())
+        return payment_address();
+
+    // Is the redeem script a standard pay (output) script?
+    const chain::script_view redeem_script(redeem_data);
+    if (redeem_script.pattern() != chain::script_pattern::pay_multisig)
+        return payment_address();
+
+    return payment_address(bitcoin_short_hash(redeem_data), 5);
+}
+
 payment_address payment_address::extract(const chain::script& script,
     uint8_t p2kh_version, uint8_t p2sh_version)
 {
@@ -240,10 +256,11 @@ payment_address payment_address::extract(const chain::script& script,
 
     short_hash hash;
     const auto& ops = script.operations;
+    const auto pattern = script.pattern();
 
     // Split out the assertions for readability.
     // We know that the script is valid and can therefore rely on these.
-    switch (script.pattern())
+    switch (pattern)
     {
         // pay
         // --------------------------------------------------------------------
@@ -305,7 +322,7 @@ payment_address payment_address::extract(const chain::script& script,
     }
 
     // Convert data to hash or point and construct address.
-    switch (script.pattern())
+    switch (pattern)
     {
         // pay
         // --------------------------------------------------------------------
@@ -353,29 +370,9 @@ payment_address payment_address::extract(const chain::script& script,
         // --------------------------------------------------------------------
 
         case chain::script_pattern::sign_multisig:
-        {
-            bc::chain::script redeem_script;
             // extract address from multisig payment script
             // zero sig1 sig2 ... encoded-multisig
-            const auto& redeem_data = ops.back().data;
-
-            if (redeem_data.empty())
-                return payment_address(); //throw std::logic_error{"empty redeem script."};
-
-            if (!redeem_script.from_data(redeem_data, false, bc::chain::script::parse_mode::strict))
-                return payment_address(); //throw std::logic_error{"error occured when parse redeem script data."};
-
-            // Is the redeem script a standard pay (output) script?
-            const auto redeem_script_pattern = redeem_script.pattern();
-            if(redeem_script_pattern != chain::script_pattern::pay_multisig)
-                return payment_address(); //throw std::logic_error{"redeem script is not pay multisig pattern."};
-
-            const payment_address address(redeem_script, 5);
-            //auto addr_str = address.encoded(); // pay address
-            //log::trace("input_addr")<<redeem_script.to_string(false);
-            //log::trace("input_addr")<<addr_str;
-            return address;
-        }
+            return from_redeem_script(ops.back().data);
 
         case chain::script_pattern::sign_public_key:
             return payment_address();
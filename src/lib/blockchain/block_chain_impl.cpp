@@ -65,6 +65,8 @@ block_chain_impl::block_chain_impl(threadpool& pool,
   : stopped_(true),
     sync_disabled_(false),
     settings_(chain_settings),
+    deferred_indexes_(database_settings.deferred_indexes),
+    warm_up_(database_settings.warm_up),
     organizer_(pool, *this, chain_settings),
     ////read_dispatch_(pool, NAME),
     ////write_dispatch_(pool, NAME),
@@ -94,6 +96,24 @@ static hash_list to_hashes(const block_result& result)
     return hashes;
 }
 
+// Read the whole block with one sequential transaction read, false if its
+// transactions are not stored back to back.
+static bool read_block(chain::block& out, const block_result& result,
+    const transaction_database& transactions)
+{
+    out.header = result.header();
+    out.header.transaction_count = result.transaction_count();
+
+    if (out.header.is_proof_of_stake() || out.header.is_proof_of_dpos())
+        out.blocksig = result.blocksig();
+
+    if (out.header.is_proof_of_dpos())
+        out.public_key = result.public_key();
+
+    return transactions.get_block(out.transactions, to_hashes(result),
+        result.height());
+}
+
 // Properties.
 // ----------------------------------------------------------------------------
 
@@ -116,10 +136,20 @@ bool block_chain_impl::start()
     if (!stopped() || !database_.start())
         return false;
 
+    if (warm_up_)
+        database_.warm_up();
+
+    database_.report_residency();
+
     stopped_ = false;
+    load_header_index();
     organizer_.start();
     transaction_pool_.start();
 
+    // Also resumes indexing of blocks imported before the last shutdown.
+    if (deferred_indexes_)
+        indexer_ = std::thread(&block_chain_impl::run_indexer, this);
+
     //init the single instance here, to avoid multi-thread init confilict
     auto* temp = account_security_strategy::get_instance();
 
@@ -132,12 +162,16 @@ bool block_chain_impl::stop()
     stopped_ = true;
     organizer_.stop();
     transaction_pool_.stop();
+    join_indexer();
     return database_.stop();
 }
 
 // Database threads must be joined before close is called (or destruct).
 bool block_chain_impl::close()
 {
+    // The indexer writes to the database, so it cannot outlive it.
+    stopped_ = true;
+    join_indexer();
     return database_.close();
 }
 
@@ -148,6 +182,35 @@ bool block_chain_impl::stopped() const
     return stopped_;
 }
 
+// private
+// The header index is resident only, so it is rebuilt from the block table.
+void block_chain_impl::load_header_index()
+{
+    header_index_.clear();
+
+    size_t top;
+    if (!database_.blocks.top(top))
+        return;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t height = 0; height <= top; ++height)
+    {
+        const auto result = database_.blocks.get(height);
+        if (!result)
+            break;
+
+        header_index_.push(result.header(), height);
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    log::info(LOG_BLOCKCHAIN)
+        << "Loaded header index of " << header_index_.size()
+        << " blocks in " << elapsed.count() << " ms.";
+}
+
 // Subscriber
 // ------------------------------------------------------------------------
 
@@ -157,12 +220,15 @@ void block_chain_impl::subscribe_reorganize(reorganize_handler handler)
     organizer_.subscribe_reorganize(handler);
 }
 
+// The stake maturity never drops below this, whatever the bits.
+static constexpr uint64_t stake_utxo_min_maturity_height = 250;
+
 static uint64_t get_stake_utxo_maturity_height(const u256& bits)
 {
     auto adjust = bits / 100000000;
     auto value = adjust.convert_to<double>();
     auto result = 1000.0 / (1 + std::exp(-std::log(value)));
-    return std::max<uint64_t>(250, std::round(result));
+    return std::max<uint64_t>(stake_utxo_min_maturity_height, std::round(result));
 }
 
 bool block_chain_impl::check_pos_utxo_height_and_value(
@@ -219,6 +285,17 @@ bool block_chain_impl::pos_exist_before(const uint64_t& height) const
     }
 #endif
 
+    // Any PoS header in (pos_enabled_height, height].
+    const auto indexed = header_index_.size();
+    if (indexed > 0) {
+        uint64_t previous;
+        const auto last = std::min<uint64_t>(height, indexed - 1);
+        if (header_index_.find_previous(previous, last + 1,
+            chain::block_version_pos, true)) {
+            return previous > pos_enabled_height;
+        }
+    }
+
     auto pos = pos_enabled_height;
     while (pos++ < height) {
         chain::header header;
@@ -237,54 +314,88 @@ uint32_t block_chain_impl::select_utxo_for_staking(
     std::shared_ptr<chain::output_info::list> stake_outputs,
     uint32_t max_count)
 {
-    bool result = false;
-    auto&& rows = get_address_history(pay_address, false);
+    catch_up_indexes();
 
-    chain::transaction tx_temp;
-    uint64_t tx_height;
-    uint32_t stake_utxos = 0;
-    uint32_t collect_utxos = 0;
-
-    bool enable_collect_stake = settings_.collect_split_stake;
-
-    for (auto & row : rows) {
-        if (row.value == 0) {
-            continue;
-        }
+    // The history of the address is scanned once, after that the candidates
+    // follow the blocks as they are connected.
+    stake_candidates_.load(pay_address, [this, &pay_address]()
+    {
+        stake_candidates::candidate::list candidates;
+        auto&& rows = get_address_history(pay_address, false);
 
-        // spend unconfirmed (or no spend attempted)
-        if ((row.spend.hash == null_hash)
-                && get_transaction(tx_temp, tx_height, row.output.hash)) {
-            BITCOIN_ASSERT(row.output.index < tx_temp.outputs.size());
-            auto output = tx_temp.outputs.at(row.output.index);
-            if (!output.is_etp() || output.get_script_address() != pay_address.encoded()) {
-                continue;
-            }
+        chain::transaction tx_temp;
+        uint64_t tx_height;
 
-            if (!check_pos_utxo_capability(bits, best_height, tx_temp, row.output.index, row.output_height, false)){
+        for (const auto& row : rows) {
+            if (row.value == 0) {
                 continue;
             }
 
-            bool satisfied = check_pos_utxo_height_and_value(bits, row.output_height, best_height, row.value);
-            if (satisfied) {
-                ++stake_utxos;
-                if (stake_outputs) {
-                    stake_outputs->push_back( {output, row.output, tx_height} );
+            // spend unconfirmed (or no spend attempted)
+            if ((row.spend.hash == null_hash)
+                    && get_transaction(tx_temp, tx_height, row.output.hash)) {
+                BITCOIN_ASSERT(row.output.index < tx_temp.outputs.size());
+                const auto& output = tx_temp.outputs.at(row.output.index);
+                if (!output.is_etp()
+                    || wallet::payment_address::extract(output.script) != pay_address) {
+                    continue;
                 }
-                if (stake_utxos >= max_count) {
-                    break;
+
+                stake_candidates::candidate candidate;
+                if (make_stake_candidate(candidate, tx_temp, row.output.index, tx_height)) {
+                    candidates.push_back(std::move(candidate));
                 }
             }
-            else if (stake_outputs
-                && enable_collect_stake
-                && collect_utxos < pos_coinstake_max_utxos
-                && row.value < pos_stake_min_value) {
-                // collect utxos to satisfy pos_stake_min_value
-                ++collect_utxos;
-                stake_outputs->push_back( {output, row.output, tx_height} );
-            }
         }
-    }
+
+        return candidates;
+    });
+
+    uint32_t stake_utxos = 0;
+    uint32_t collect_utxos = 0;
+    chain::transaction tx_temp;
+    uint64_t tx_height;
+
+    // Time based rules cannot be scheduled by height, check them in full.
+    const auto spendable = [&](const stake_candidates::candidate& candidate)
+    {
+        const auto& point = candidate.info.point;
+        return !candidate.recheck
+            || (get_transaction(tx_temp, tx_height, point.hash)
+                && check_pos_utxo_capability(bits, best_height, tx_temp,
+                    point.index, candidate.info.height, false));
+    };
+
+    const auto stake = [&](const stake_candidates::candidate& candidate)
+    {
+        if (!check_pos_utxo_height_and_value(bits, candidate.info.height,
+                best_height, candidate.info.data.value)
+            || !spendable(candidate)) {
+            return true;
+        }
+
+        ++stake_utxos;
+        if (stake_outputs) {
+            stake_outputs->push_back(candidate.info);
+        }
+
+        return stake_utxos < max_count;
+    };
+
+    // collect utxos to satisfy pos_stake_min_value
+    const auto collect = [&](const stake_candidates::candidate& candidate)
+    {
+        if (spendable(candidate)) {
+            ++collect_utxos;
+            stake_outputs->push_back(candidate.info);
+        }
+
+        return collect_utxos < pos_coinstake_max_utxos;
+    };
+
+    const auto enable_collect_stake = stake_outputs && settings_.collect_split_stake;
+    stake_candidates_.visit(pay_address, best_height, stake,
+        enable_collect_stake ? stake_candidates::visitor(collect) : nullptr);
 
 #ifdef MVS_DEBUG
     if (stake_utxos > 0) {
@@ -303,6 +414,44 @@ chain::header::ptr block_chain_impl::get_last_block_header(const chain::header&
     return get_prev_block_header(parent_header.number, static_cast<chain::block_version>(version));
 }
 
+bool block_chain_impl::get_retarget_headers(chain::header::ptr& out_last,
+    chain::header::ptr& out_previous, uint64_t height, uint32_t version) const
+{
+    header_index::retarget_entry last;
+    header_index::retarget_entry previous;
+    if (!header_index_.find_retarget(last, previous, height, version))
+        return false;
+
+    // The parent is taken whatever its height, older headers are subject to
+    // the same activation heights as get_prev_block_header.
+    const auto to_header = [version](const header_index::retarget_entry& entry,
+        uint64_t parent) -> chain::header::ptr
+    {
+        if (entry.height == 0)
+            return nullptr;
+
+        if (entry.height != parent) {
+            if (version == chain::block_version_pos && entry.height < pos_enabled_height)
+                return nullptr;
+
+            if (version == chain::block_version_dpos && entry.height < consensus::witness::witness_enable_height)
+                return nullptr;
+        }
+
+        const auto header = std::make_shared<chain::header>();
+        header->version = version;
+        header->number = static_cast<uint32_t>(entry.height);
+        header->timestamp = entry.timestamp;
+        header->bits = entry.bits;
+        return header;
+    };
+
+    out_last = to_header(last, height - 1);
+    out_previous = out_last && out_last->number > 2 ?
+        to_header(previous, out_last->number - 1) : nullptr;
+    return true;
+}
+
 // simple_chain (no locks, not thread safe).
 // ----------------------------------------------------------------------------
 
@@ -346,6 +495,11 @@ bool block_chain_impl::get_difficulty(u256& out_difficulty,
     if (!database_.blocks.top(top))
         return false;
 
+    // The recent heights are summed in the resident work window.
+    if (header_index_.size() == top + 1 &&
+        header_index_.get_work(out_difficulty, height))
+        return true;
+
     out_difficulty = 0;
     for (uint64_t index = height; index <= top; ++index)
     {
@@ -442,14 +596,43 @@ bool block_chain_impl::import(block::ptr block, uint64_t height)
     if (stopped())
         return false;
 
-    // THIS IS THE DATABASE BLOCK WRITE AND INDEX OPERATION.
-    database_.push(*block, height);
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section.
+    unique_lock lock(mutex_);
+
+    if (deferred_indexes_)
+    {
+        // THIS IS THE DATABASE BLOCK WRITE, THE INDEXER INDEXES IT LATER.
+        database_.push_unindexed(*block, height);
+        database_.synchronize();
+    }
+    else
+    {
+        // THIS IS THE DATABASE BLOCK WRITE AND INDEX OPERATION.
+        database_.push(*block, height);
+    }
+
+    header_index_.push(block->header, height);
+    connect_stake_candidates(*block, height);
+    lock.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (deferred_indexes_)
+        wake_indexer();
+
     return true;
 }
 
 bool block_chain_impl::push(block_detail::ptr block)
 {
     database_.push(*block->actual());
+
+    size_t top;
+    if (database_.blocks.top(top)) {
+        header_index_.push(block->actual()->header, top);
+        connect_stake_candidates(*block->actual(), top);
+    }
+
     return true;
 }
 
@@ -475,8 +658,15 @@ bool block_chain_impl::pop_from(block_detail::list& out_blocks,
     // If the fork is at the top there is one block to pop, and so on.
     out_blocks.reserve(top - height + 1);
 
+    // Spent outputs cannot be restored without their transactions, so the
+    // staking addresses are reloaded on next use instead.
+    stake_candidates_.invalidate();
+
     for (uint64_t index = top; index >= height; --index)
     {
+        // Drop the index entry first so it never runs ahead of the store.
+        header_index_.pop(index);
+
         chain::block block;
         if (!database_.pop(block)) {
             return false;
@@ -485,6 +675,8 @@ bool block_chain_impl::pop_from(block_detail::list& out_blocks,
         out_blocks.push_back(sp_block);
     }
 
+    // Also discard any load that read the store while it was being popped.
+    stake_candidates_.invalidate();
     return true;
 }
 
@@ -514,6 +706,114 @@ block_chain_writer::~block_chain_writer()
     chain_.stop_write();
 }
 
+// Deferred indexes.
+// ----------------------------------------------------------------------------
+
+bool block_chain_impl::get_indexed_height(uint64_t& out_height) const
+{
+    uint64_t unindexed;
+    if (!database_.unindexed_height(unindexed))
+        return get_last_height(out_height);
+
+    if (unindexed == 0)
+        return false;
+
+    out_height = unindexed - 1;
+    return true;
+}
+
+void block_chain_impl::catch_up_indexes()
+{
+    uint64_t unindexed;
+    if (!database_.unindexed_height(unindexed))
+        return;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section.
+    unique_lock lock(mutex_);
+    do_catch_up_indexes();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private, call under exclusive lock.
+void block_chain_impl::do_catch_up_indexes()
+{
+    uint64_t unindexed;
+    if (!database_.unindexed_height(unindexed))
+        return;
+
+    log::info(LOG_BLOCKCHAIN)
+        << "Catching up indexes from height " << unindexed;
+
+    while (database_.unindexed_height(unindexed))
+    {
+        block_chain_writer writer(*this);
+        if (!database_.index_next())
+        {
+            log::error(LOG_BLOCKCHAIN)
+                << "Failure indexing block at height " << unindexed;
+            return;
+        }
+    }
+}
+
+// private
+void block_chain_impl::wake_indexer()
+{
+    // Taking the mutex orders the wake after a waiter's check of the mark.
+    {
+        std::lock_guard<std::mutex> lock(indexer_mutex_);
+    }
+
+    indexer_wake_.notify_one();
+}
+
+// private
+void block_chain_impl::join_indexer()
+{
+    if (!indexer_.joinable())
+        return;
+
+    wake_indexer();
+    indexer_.join();
+}
+
+// private
+// Index one block per write lock, so imports and reads are not held up for
+// the length of a catch-up, and persist the mark after each.
+void block_chain_impl::run_indexer()
+{
+    uint64_t unindexed;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(indexer_mutex_);
+            indexer_wake_.wait(lock, [this, &unindexed]()
+            {
+                return stopped() || database_.unindexed_height(unindexed);
+            });
+        }
+
+        if (stopped())
+            return;
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section.
+        unique_lock lock(mutex_);
+
+        block_chain_writer writer(*this);
+        if (!database_.index_next())
+        {
+            log::error(LOG_BLOCKCHAIN)
+                << "Failure indexing block at height " << unindexed
+                << ", indexing stopped.";
+            return;
+        }
+        ///////////////////////////////////////////////////////////////////////
+    }
+}
+
 // This call is sequential, but we are preserving the callback model for now.
 void block_chain_impl::store(message::block_message::ptr block,
     block_store_handler handler)
@@ -567,6 +867,9 @@ void block_chain_impl::do_store(message::block_message::ptr block,
         return;
     }
 
+    // Validation reads the indexes, so they must cover the whole chain.
+    do_catch_up_indexes();
+
     // Otherwise organize the chain...
     organizer_.organize();
 
@@ -590,11 +893,24 @@ void block_chain_impl::fetch_serial(perform_read_functor perform_read)
         return (!database_.is_write_locked(handle) && perform_read(handle));
     };
 
+    static auto& wait_time = *metrics::instance().make_histogram(
+        "mvs_fetch_serial_wait_seconds",
+        "Time a serial read waited for the database write lock.");
+
     const auto do_read = [try_read]()
     {
+        const auto start = metrics::scoped_timer::clock::now();
+        auto attempt = start;
+
         // Sleep while waiting for write to complete.
         while (!try_read())
+        {
             std::this_thread::sleep_for(asio::milliseconds(10));
+            attempt = metrics::scoped_timer::clock::now();
+        }
+
+        wait_time.record(std::chrono::duration_cast<
+            std::chrono::microseconds>(attempt - start).count());
     };
 
     // Initiate serial read operation.
@@ -891,13 +1207,61 @@ void block_chain_impl::filter_orphans(message::get_data::ptr message,
 void block_chain_impl::fetch_block(uint64_t height,
     block_fetch_handler handler)
 {
-    blockchain::fetch_block(*this, height, handler);
+    if (stopped())
+    {
+        handler(error::service_stopped, nullptr);
+        return;
+    }
+
+    auto contiguous = true;
+    const auto do_fetch = [this, height, handler, &contiguous](size_t slock)
+    {
+        const auto result = database_.blocks.get(height);
+        if (!result)
+            return finish_fetch(slock, handler, error::not_found,
+                chain::block::ptr());
+
+        const auto block = std::make_shared<chain::block>();
+        contiguous = read_block(*block, result, database_.transactions);
+        return contiguous ?
+            finish_fetch(slock, handler, error::success, block) :
+            database_.is_read_valid(slock);
+    };
+    fetch_serial(do_fetch);
+
+    // Not stored back to back, fetch the transactions one by one.
+    if (!contiguous)
+        blockchain::fetch_block(*this, height, handler);
 }
 
 void block_chain_impl::fetch_block(const hash_digest& hash,
     block_fetch_handler handler)
 {
-    blockchain::fetch_block(*this, hash, handler);
+    if (stopped())
+    {
+        handler(error::service_stopped, nullptr);
+        return;
+    }
+
+    auto contiguous = true;
+    const auto do_fetch = [this, hash, handler, &contiguous](size_t slock)
+    {
+        const auto result = database_.blocks.get(hash);
+        if (!result)
+            return finish_fetch(slock, handler, error::not_found,
+                chain::block::ptr());
+
+        const auto block = std::make_shared<chain::block>();
+        contiguous = read_block(*block, result, database_.transactions);
+        return contiguous ?
+            finish_fetch(slock, handler, error::success, block) :
+            database_.is_read_valid(slock);
+    };
+    fetch_serial(do_fetch);
+
+    // Not stored back to back, fetch the transactions one by one.
+    if (!contiguous)
+        blockchain::fetch_block(*this, hash, handler);
 }
 
 void block_chain_impl::fetch_block_header(uint64_t height,
@@ -1261,6 +1625,75 @@ void block_chain_impl::fetch_spend(const chain::output_point& outpoint,
     fetch_serial(do_fetch);
 }
 
+void block_chain_impl::fetch_prevouts(const chain::point::list& points,
+    const transaction_pool* pool, prevouts_fetch_handler handler)
+{
+    if (stopped())
+    {
+        handler(error::service_stopped, {});
+        return;
+    }
+
+    const auto do_fetch = [this, points, pool, handler](size_t slock)
+    {
+        struct previous
+        {
+            bool found;
+            bool confirmed;
+            uint64_t height;
+            chain::transaction tx;
+        };
+
+        // Each previous transaction is read and decoded once, however many
+        // of the points are its outputs.
+        std::unordered_map<hash_digest, previous> cache;
+        prevout::list prevouts;
+        prevouts.reserve(points.size());
+
+        for (const auto& point: points)
+        {
+            auto it = cache.find(point.hash);
+            if (it == cache.end())
+            {
+                previous entry{ false, false, 0, {} };
+                const auto result = database_.transactions.get(point.hash);
+
+                if (result)
+                {
+                    entry.found = true;
+                    entry.confirmed = true;
+                    entry.height = result.height();
+                    entry.tx = result.transaction();
+                }
+                else if (pool != nullptr)
+                {
+                    entry.found = pool->find(entry.tx, point.hash);
+                }
+
+                it = cache.emplace(point.hash, std::move(entry)).first;
+            }
+
+            const auto& entry = it->second;
+            prevout out{ entry.found, false, entry.confirmed, false, false,
+                entry.height, {} };
+
+            if (entry.found && point.index < entry.tx.outputs.size())
+            {
+                out.valid = true;
+                out.coinbase = entry.tx.is_coinbase();
+                out.output = entry.tx.outputs[point.index];
+                out.spent = entry.confirmed &&
+                    database_.spends.get(point).valid;
+            }
+
+            prevouts.push_back(std::move(out));
+        }
+
+        return finish_fetch(slock, handler, error::success, prevouts);
+    };
+    fetch_serial(do_fetch);
+}
+
 void block_chain_impl::fetch_history(const wallet::payment_address& address,
     uint64_t limit, uint64_t from_height, history_fetch_handler handler)
 {
@@ -1916,31 +2349,30 @@ std::shared_ptr<asset_mit::list> block_chain_impl::get_account_mits(
     return sp_vec;
 }
 
-uint64_t block_chain_impl::get_address_asset_volume(const std::string& addr, const std::string& asset)
+std::shared_ptr<database::address_balance::list>
+block_chain_impl::get_address_asset_balances(const std::string& address)
 {
-    uint64_t asset_volume = 0;
-    auto address = wallet::payment_address(addr);
-    auto&& rows = get_address_history(address);
+    auto balances = std::make_shared<database::address_balance::list>(
+        database_.address_balances.get(address_key::from_string(address)));
 
-    chain::transaction tx_temp;
-    uint64_t tx_height;
+    for (const auto& balance: *balances)
+        if (balance.encumbered_count != 0)
+            return nullptr;
 
-    for (auto& row: rows)
-    {
-        // spend unconfirmed (or no spend attempted)
-        if ((row.spend.hash == null_hash)
-            && get_transaction(tx_temp, tx_height, row.output.hash))
-        {
-            auto output = tx_temp.outputs.at(row.output.index);
-            if ((output.is_asset_transfer() || output.is_asset_issue() || output.is_asset_secondaryissue())) {
-                if (output.get_asset_symbol() == asset) {
-                    asset_volume += output.get_asset_amount();
-                }
-            }
-        }
-    }
+    return balances;
+}
+
+database::address_lock::list block_chain_impl::get_address_locks(
+    const std::string& address)
+{
+    return database_.address_locks.get(address_key::from_string(address));
+}
 
-    return asset_volume;
+uint64_t block_chain_impl::get_address_asset_volume(const std::string& addr, const std::string& asset)
+{
+    // Encumbered outputs count in full toward the volume.
+    return database_.address_balances.get(address_key::from_string(addr),
+        asset).quantity;
 }
 
 uint64_t block_chain_impl::get_account_asset_volume(const std::string& account, const std::string& asset)
@@ -2103,7 +2535,7 @@ std::shared_ptr<business_history::list> block_chain_impl::get_address_business_h
 std::shared_ptr<business_history::list> block_chain_impl::get_address_business_history(const std::string& addr)
 {
     auto sp_asset_vec = std::make_shared<business_history::list>();
-    auto key = get_short_hash(addr);
+    const auto key = address_key::from_string(addr);
     business_history::list asset_vec = database_.address_assets.get_business_history(key, 0);
     const auto add_asset = [&](const business_history& addr_asset)
     {
@@ -2119,7 +2551,7 @@ std::shared_ptr<business_record::list> block_chain_impl::get_address_business_re
     size_t from_height, size_t limit)
 {
     auto sp_asset_vec = std::make_shared<business_record::list>();
-    auto key = get_short_hash(addr);
+    const auto key = address_key::from_string(addr);
     business_record::list asset_vec = database_.address_assets.get(key, from_height, limit);
     const auto add_asset = [&](const business_record& addr_asset)
     {
@@ -2773,26 +3205,17 @@ std::pair<uint64_t, uint64_t> block_chain_impl::get_locked_balance(
     uint64_t locked_weight = 0;
     uint64_t expiration = epoch_height + witness::register_witness_lock_height;
 
-    auto&& rows = get_address_history(wallet::payment_address(address));
-
-    chain::transaction tx_temp;
-    uint64_t tx_height = 0;
-
     uint64_t last_height = 0;
     get_last_height(last_height);
 
-    for (auto& row: rows)
+    // Only the locked outputs of the address are visited.
+    for (const auto& lock: get_address_locks(address))
     {
-        if (row.value == 0) {
+        if (lock.value == 0 || !lock.is_etp) {
             continue;
         }
 
-        // spend unconfirmed (or no spend attempted)
-        bool tx_ready = (row.spend.hash == null_hash)
-            && get_transaction(tx_temp, tx_height, row.output.hash);
-        if (!tx_ready) {
-            continue;
-        }
+        const uint64_t tx_height = lock.height;
 
         // tx not maturity
         if (tx_height + witness::vote_maturity > last_height) {
@@ -2807,24 +3230,16 @@ std::pair<uint64_t, uint64_t> block_chain_impl::get_locked_balance(
             }
         }
 
-        BITCOIN_ASSERT(row.output.index < tx_temp.outputs.size());
-        const auto& output = tx_temp.outputs.at(row.output.index);
-
-        if (!output.is_etp()) {
-            continue;
-        }
-
         // only support lock sequence with block height
-        auto lock_sequence = output.get_lock_heights_sequence();
-        auto seq_expiration = tx_height + lock_sequence;
+        const auto seq_expiration = lock.expiration();
 
         // use any kind of blocks
-        if ((seq_expiration <= last_height) ||
+        if (!lock.is_locked(last_height) ||
             (expiration > last_height && seq_expiration <= expiration)) {
             continue;
         }
 
-        uint64_t locked_value = row.value;
+        uint64_t locked_value = lock.value;
         locked_balance += locked_value;
         auto weight = std::min<uint64_t>(witness::epoch_cycle_height, seq_expiration - last_height);
         locked_weight += locked_value * weight;
@@ -3201,6 +3616,30 @@ chain::header::ptr block_chain_impl::get_prev_block_header(
     typedef std::function<bool(chain::header&, uint64_t)> FuncType;
     FuncType func = std::bind(&block_chain_impl::get_header, this, _1, _2);
 
+    // Jump straight to the header with the resident index, if it covers it.
+    uint64_t previous;
+    if (header_index_.find_previous(previous, height, ver, same_version)) {
+        if (previous == 0) {
+            return nullptr;
+        }
+
+        if (same_version) {
+            if (ver == chain::block_version_pos && previous < pos_enabled_height) {
+                return nullptr;
+            }
+            else if (ver == chain::block_version_dpos && previous < consensus::witness::witness_enable_height) {
+                return nullptr;
+            }
+        }
+
+        chain::header header;
+        if (!func(header, previous)) {
+            return nullptr;
+        }
+
+        return std::make_shared<chain::header>(header);
+    }
+
     return get_prev_block_header_impl(height, ver, same_version, func);
 }
 
@@ -3321,6 +3760,11 @@ uint32_t block_chain_impl::get_median_time_past(uint64_t height) const
     constexpr uint64_t median_time_span = 11;
     const auto count = std::min(height, median_time_span);
 
+    uint32_t median;
+    if (header_index_.median_time_past(median, height, median_time_span)) {
+        return median;
+    }
+
     chain::header header;
     std::vector<uint32_t> times;
 
@@ -3404,6 +3848,75 @@ bool block_chain_impl::is_utxo_spendable(const chain::transaction& tx, uint32_t
     return true;
 }
 
+// private
+// The height based rules of is_utxo_spendable, solved for the first height
+// at which they pass. Time based rules are left to a full check on use.
+bool block_chain_impl::make_stake_candidate(
+    stake_candidates::candidate& out_candidate, const chain::transaction& tx,
+    uint32_t index, uint64_t height) const
+{
+    if (index >= tx.outputs.size() || height == 0) {
+        return false;
+    }
+
+    const auto& output = tx.outputs[index];
+    if (output.value == 0 || !output.is_etp()) {
+        return false;
+    }
+
+    auto ready_height = height + transaction_maturity;
+    auto recheck = false;
+
+    if (chain::operation::is_pay_key_hash_with_lock_height_pattern(output.script.operations)) {
+        // deposit utxo in block
+        uint64_t lock_height = chain::operation::
+            get_lock_height_from_pay_key_hash_with_lock_height(output.script.operations);
+        ready_height = std::max(ready_height, height + lock_height);
+    }
+    else if (chain::operation::is_pay_key_hash_with_sequence_lock_pattern(output.script.operations)) {
+        auto raw_value = output.get_lock_sequence();
+        if (is_relative_locktime_time_locked(raw_value)) {
+            recheck = true;
+        }
+        else {
+            auto locked_heights = get_relative_locktime_locked_heights(raw_value);
+            ready_height = std::max<uint64_t>(ready_height, height + locked_heights);
+        }
+    }
+    else if (tx.is_coinbase()) {
+        ready_height = std::max<uint64_t>(ready_height, height + coinbase_maturity);
+    }
+    else if (tx.version >= relative_locktime_min_version && !tx.is_final(0, 0)) {
+        // neither a zero locktime nor final inputs, so the locktime decides
+        if (tx.locktime < locktime_threshold) {
+            ready_height = std::max<uint64_t>(ready_height, tx.locktime);
+        }
+        else {
+            recheck = true;
+        }
+    }
+
+    const auto small = output.value < pos_stake_min_value;
+    if (!small) {
+        ready_height = std::max(ready_height, height + stake_utxo_min_maturity_height);
+    }
+
+    out_candidate.info = { output, { tx.hash(), index }, height };
+    out_candidate.ready_height = ready_height;
+    out_candidate.recheck = recheck;
+    out_candidate.small = small;
+    return true;
+}
+
+// private
+void block_chain_impl::connect_stake_candidates(const chain::block& block,
+    uint64_t height)
+{
+    using namespace std::placeholders;
+    stake_candidates_.connect(block, height,
+        std::bind(&block_chain_impl::make_stake_candidate, this, _1, _2, _3, _4));
+}
+
 bool block_chain_impl::is_valid_symbol(const std::string& symbol, uint32_t tx_version)
 {
     if (symbol.empty() || symbol.length() > ASSET_DETAIL_SYMBOL_FIX_SIZE)
@@ -0,0 +1,262 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/header_index.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <metaverse/blockchain/block.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+const size_t header_index::retarget_window = 1024;
+
+header_index::header_index()
+{
+}
+
+size_t header_index::bucket(uint32_t version)
+{
+    return version >= chain::block_version_min &&
+        version < chain::block_version_max ? version : 0;
+}
+
+// private, call under exclusive lock.
+void header_index::truncate(uint64_t height)
+{
+    if (height >= timestamps_.size())
+        return;
+
+    const auto popped = timestamps_.size() - height;
+    work_.resize(work_.size() > popped ? work_.size() - popped : 0);
+    timestamps_.resize(height);
+
+    for (auto& retargets: retargets_)
+        while (!retargets.empty() && retargets.back().height >= height)
+            retargets.pop_back();
+
+    // Heights are ascending, so the popped ones are at the back of each list.
+    for (auto& heights: heights_)
+    {
+        const auto it = std::lower_bound(heights.begin(), heights.end(),
+            static_cast<uint32_t>(height));
+        heights.erase(it, heights.end());
+    }
+}
+
+void header_index::push(const chain::header& header, uint64_t height)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    truncate(height);
+
+    if (height != timestamps_.size() || height >= max_uint32)
+        return;
+
+    const auto index = bucket(header.version);
+    timestamps_.push_back(header.timestamp);
+    heights_[index].push_back(static_cast<uint32_t>(height));
+
+    auto& retargets = retargets_[index];
+    retargets.push_back({ height, header.timestamp, header.bits });
+    if (retargets.size() > retarget_window)
+        retargets.pop_front();
+
+    const auto work = block_work(header.bits);
+    work_.push_back(work_.empty() ? work : work_.back() + work);
+    if (work_.size() > retarget_window)
+        work_.pop_front();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_index::pop(uint64_t height)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+    truncate(height);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_index::clear()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+    truncate(0);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+uint64_t header_index::size() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+    return timestamps_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_index::get_timestamp(uint32_t& out_timestamp,
+    uint64_t height) const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    if (height >= timestamps_.size())
+        return false;
+
+    out_timestamp = timestamps_[height];
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_index::find_previous(uint64_t& out_height, uint64_t height,
+    uint32_t version, bool same_version) const
+{
+    const auto match = bucket(version);
+    if (match == 0)
+        return false;
+
+    out_height = 0;
+    if (height < 2)
+        return true;
+
+    const auto limit = static_cast<uint32_t>(
+        std::min<uint64_t>(height, max_uint32));
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    if (height - 1 >= timestamps_.size())
+        return false;
+
+    // The highest height below limit in each candidate bucket, zero if none.
+    for (size_t index = 0; index < chain::block_version_max; ++index)
+    {
+        if ((index == match) != same_version)
+            continue;
+
+        const auto& heights = heights_[index];
+        const auto it = std::lower_bound(heights.begin(), heights.end(),
+            limit);
+
+        if (it != heights.begin())
+            out_height = std::max<uint64_t>(out_height, *(it - 1));
+    }
+
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_index::median_time_past(uint32_t& out_time, uint64_t height,
+    size_t span) const
+{
+    const auto count = std::min<uint64_t>(height, span);
+    std::vector<uint32_t> times;
+    times.reserve(count);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    if (count > 0 && height >= timestamps_.size())
+        return false;
+
+    for (uint64_t i = 1; i <= count; ++i)
+        times.push_back(timestamps_[height - count + i]);
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Sort and select middle (median) value from the array.
+    std::sort(times.begin(), times.end());
+    out_time = times.empty() ? 0 : times[times.size() / 2];
+    return true;
+}
+
+bool header_index::find_retarget(retarget_entry& out_last,
+    retarget_entry& out_previous, uint64_t height, uint32_t version) const
+{
+    const auto match = bucket(version);
+    if (match == 0 || height < 2)
+        return false;
+
+    static const retarget_entry none{ 0, 0, 0 };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    if (height - 1 >= timestamps_.size())
+        return false;
+
+    const auto& retargets = retargets_[match];
+    const auto below = std::lower_bound(retargets.begin(), retargets.end(),
+        height, [](const retarget_entry& entry, uint64_t value)
+        {
+            return entry.height < value;
+        });
+
+    // Entries of the version older than the window may be the ones needed.
+    const auto count = static_cast<size_t>(below - retargets.begin());
+    if (count < 2 && retargets.size() != heights_[match].size())
+        return false;
+
+    // Height zero (genesis) is never a retarget input.
+    out_last = count > 0 ? *(below - 1) : none;
+    out_previous = count > 1 ? *(below - 2) : none;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_index::get_work(u256& out_work, uint64_t height) const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    const auto size = timestamps_.size();
+    const auto base = size - work_.size();
+    if (height > size || height < base || work_.empty())
+        return false;
+
+    if (height == size)
+    {
+        out_work = 0;
+        return true;
+    }
+
+    // The work below the window is unknown, unless the window starts at
+    // genesis.
+    if (height == base && base != 0)
+        return false;
+
+    out_work = height == 0 ? work_.back() :
+        u256(work_.back() - work_[height - base - 1]);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -47,6 +47,22 @@ using namespace bc::config;
 
 #define NAME "organizer"
 
+static auto& block_store_time = *metrics::instance().make_histogram(
+    "mvs_chain_block_store_seconds",
+    "Time spent writing a validated block to the database.");
+static auto& blocks_connected = *metrics::instance().make_counter(
+    "mvs_chain_blocks_connected_total",
+    "Blocks pushed onto the main chain.");
+static auto& blocks_disconnected = *metrics::instance().make_counter(
+    "mvs_chain_blocks_disconnected_total",
+    "Blocks popped from the main chain by reorganizations.");
+static auto& reorganizations = *metrics::instance().make_counter(
+    "mvs_chain_reorganizations_total",
+    "Chain reorganizations that popped at least one block.");
+static auto& chain_height = *metrics::instance().make_gauge(
+    "mvs_chain_height",
+    "Height of the main chain top block.");
+
 organizer::organizer(threadpool& pool, block_chain_impl& chain,
     const settings& settings)
   : stopped_(true),
@@ -432,6 +448,8 @@ organizer::replace_chain(uint64_t fork_index, block_detail::list& orphan_chain)
     if (!released_blocks.empty()) {
         num_of_poped_blocks = released_blocks.size();
         current_block_height = released_blocks.front()->actual()->header.number - 1;
+        reorganizations.increment();
+        blocks_disconnected.increment(num_of_poped_blocks);
         if (!pop_all_success) {
             log::warning(LOG_BLOCKCHAIN)
                 << " not all blocks poped out successfully from " << begin_index
@@ -456,7 +474,7 @@ organizer::replace_chain(uint64_t fork_index, block_detail::list& orphan_chain)
     auto arrival_index = fork_index;
 
     block_detail::list pushed_blocks;
-    for (const auto arrival_block: orphan_chain)
+    for (const auto& arrival_block: orphan_chain)
     {
         orphan_pool_.remove(arrival_block);
 
@@ -464,7 +482,11 @@ organizer::replace_chain(uint64_t fork_index, block_detail::list& orphan_chain)
         arrival_block->set_height(++arrival_index);
 
         // THIS IS THE DATABASE BLOCK WRITE AND INDEX OPERATION.
-        if(chain_.push(arrival_block) == false)
+        const auto start = metrics::scoped_timer::clock::now();
+        const auto pushed = chain_.push(arrival_block);
+        block_store_time.record(metrics::since(start));
+
+        if (pushed == false)
         {
             log::warning(LOG_BLOCKCHAIN)
                 << " push block height:" << arrival_block->actual()->header.number
@@ -485,9 +507,11 @@ organizer::replace_chain(uint64_t fork_index, block_detail::list& orphan_chain)
     }
 
     num_of_pushed_blocks = pushed_blocks.size();
+    blocks_connected.increment(num_of_pushed_blocks);
+    chain_height.set(current_block_height);
 
     // Add the old blocks back to the pool (as processed with orphan height).
-    for (const auto replaced_block: released_blocks)
+    for (const auto& replaced_block: released_blocks)
     {
         replaced_block->set_processed();
         orphan_pool_.add(replaced_block);
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/pool_validations.hpp>
+
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::chain;
+
+// Validations.
+// ----------------------------------------------------------------------------
+
+bool pool_validations::find(validation& out_validation,
+    const hash_digest& tx_hash, const hash_digest& tip) const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    const auto it = validations_.find(tx_hash);
+    if (it == validations_.end() || it->second.tip != tip)
+        return false;
+
+    out_validation = it->second;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void pool_validations::store(const hash_digest& tx_hash,
+    const validation& result)
+{
+    if (result.tip == null_hash)
+        return;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+    validations_[tx_hash] = result;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void pool_validations::retain(const hash_digest& tip)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    for (auto it = validations_.begin(); it != validations_.end();)
+        if (it->second.tip != tip)
+            it = validations_.erase(it);
+        else
+            ++it;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t pool_validations::size() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+    return validations_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Block checks.
+// ----------------------------------------------------------------------------
+
+bool pooled_connect::connect(const transaction& tx,
+    const pool_validations::validation& validation)
+{
+    // Pool parents must precede it in the block.
+    for (const auto index: validation.unconfirmed)
+        if (index >= tx.inputs.size() || preceding_.find(
+            tx.inputs[index].previous_output.hash) == preceding_.end())
+            return false;
+
+    // The full validation of the others checks their spends against every
+    // transaction of the block, so these are only checked against each other.
+    for (const auto& input: tx.inputs)
+        if (!spent_.insert(static_cast<const point&>(
+            input.previous_output)).second)
+            return false;
+
+    preceding_.insert(tx.hash());
+    return true;
+}
+
+void pooled_connect::add(const transaction& tx)
+{
+    preceding_.insert(tx.hash());
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -0,0 +1,226 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/stake_candidates.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace libbitcoin {
+namespace blockchain {
+
+// private, call under exclusive lock.
+stake_candidates::address_candidates* stake_candidates::find(
+    const wallet::payment_address& address)
+{
+    for (auto& entry: addresses_)
+        if (entry.address == address)
+            return &entry;
+
+    return nullptr;
+}
+
+// private, call under lock.
+const stake_candidates::address_candidates* stake_candidates::find(
+    const wallet::payment_address& address) const
+{
+    for (const auto& entry: addresses_)
+        if (entry.address == address)
+            return &entry;
+
+    return nullptr;
+}
+
+// private, call under exclusive lock.
+void stake_candidates::insert(address_candidates& entry, candidate&& item)
+{
+    const chain::point& point = item.info.point;
+    if (entry.points.find(point) != entry.points.end())
+        return;
+
+    entry.points.emplace(point, std::make_pair(item.ready_height, item.small));
+    auto& target = item.small ? entry.smalls : entry.stakes;
+    target.emplace(key{ item.ready_height, point }, std::move(item));
+}
+
+// private, call under exclusive lock.
+void stake_candidates::remove(address_candidates& entry,
+    const chain::point& point)
+{
+    if (entry.status == state::loading)
+        entry.spent.insert(point);
+
+    const auto it = entry.points.find(point);
+    if (it == entry.points.end())
+        return;
+
+    auto& target = it->second.second ? entry.smalls : entry.stakes;
+    target.erase(key{ it->second.first, point });
+    entry.points.erase(it);
+}
+
+// private, call under exclusive lock.
+void stake_candidates::clear(address_candidates& entry)
+{
+    entry.stakes.clear();
+    entry.smalls.clear();
+    entry.points.clear();
+    entry.spent.clear();
+}
+
+void stake_candidates::load(const wallet::payment_address& address,
+    loader load)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    auto entry = find(address);
+    if (entry != nullptr && entry->status != state::invalid)
+    {
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    if (entry == nullptr)
+    {
+        addresses_.push_back({ address, state::invalid, {}, {}, {}, {} });
+        entry = &addresses_.back();
+    }
+
+    clear(*entry);
+    entry->status = state::loading;
+    const auto epoch = epoch_;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The loader reads the store, which may be waiting on a block write that
+    // is itself waiting to connect here, so it must not run under the lock.
+    auto candidates = load();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    // Invalidated by a reorganization while loading, reload on next use.
+    entry = find(address);
+    if (entry == nullptr || entry->status != state::loading || epoch != epoch_)
+        return;
+
+    // Blocks connected meanwhile are already applied, which is idempotent
+    // for outputs the load also saw, so only their spends need excluding.
+    for (auto& item: candidates)
+        if (entry->spent.find(item.info.point) == entry->spent.end())
+            insert(*entry, std::move(item));
+
+    entry->spent.clear();
+    entry->status = state::valid;
+    const auto stakes = entry->stakes.size();
+    const auto smalls = entry->smalls.size();
+    lock.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    log::debug(LOG_BLOCKCHAIN)
+        << "Loaded " << stakes << " stake and " << smalls
+        << " small outputs of " << address.encoded();
+}
+
+void stake_candidates::connect(const chain::block& block, uint64_t height,
+    maker make)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    if (addresses_.empty())
+        return;
+
+    for (const auto& tx: block.transactions)
+    {
+        if (!tx.is_coinbase())
+            for (const auto& input: tx.inputs)
+                for (auto& entry: addresses_)
+                    if (entry.status != state::invalid)
+                        remove(entry, input.previous_output);
+
+        for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+        {
+            const auto& output = tx.outputs[index];
+            if (output.value == 0 || !output.is_etp())
+                continue;
+
+            const auto address = wallet::payment_address::extract(
+                output.script);
+            auto entry = find(address);
+            if (entry == nullptr || entry->status == state::invalid)
+                continue;
+
+            candidate item;
+            if (make(item, tx, index, height))
+                insert(*entry, std::move(item));
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void stake_candidates::invalidate()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    ++epoch_;
+    for (auto& entry: addresses_)
+    {
+        entry.status = state::invalid;
+        clear(entry);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void stake_candidates::visit(const wallet::payment_address& address,
+    uint64_t height, visitor stake, visitor collect) const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    const auto entry = find(address);
+    if (entry == nullptr)
+        return;
+
+    // Both schedules are ordered by ready height, stop at the first that
+    // is not ready yet.
+    for (const auto& item: entry->stakes)
+        if (item.first.first > height || !stake(item.second))
+            break;
+
+    if (collect)
+        for (const auto& item: entry->smalls)
+            if (item.first.first > height || !collect(item.second))
+                break;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
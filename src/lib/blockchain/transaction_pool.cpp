@@ -40,6 +40,19 @@ using namespace std::placeholders;
 
 using string = std::string;
 
+static auto& pool_size = *metrics::instance().make_gauge(
+    "mvs_mempool_transactions",
+    "Transactions currently held in the memory pool.");
+static auto& validate_time = *metrics::instance().make_histogram(
+    "mvs_mempool_validate_seconds",
+    "Time to validate a transaction offered to the memory pool.");
+static auto& accepted = *metrics::instance().make_counter(
+    "mvs_mempool_accepted_total",
+    "Transactions that passed memory pool validation.");
+static auto& rejected = *metrics::instance().make_counter(
+    "mvs_mempool_rejected_total",
+    "Transactions that failed memory pool validation.");
+
 transaction_pool::transaction_pool(threadpool& pool, block_chain& chain,
                                    const settings& settings)
     : stopped_(true),
@@ -113,13 +126,34 @@ void transaction_pool::do_validate(transaction_ptr tx,
     const auto validate = std::make_shared<validate_transaction>(
                               blockchain_, *tx, *this, dispatch_);
 
-    validate->start(
+    const auto start = metrics::scoped_timer::clock::now();
+    const auto timed = [handler, start](const code& ec, transaction_ptr tx,
+                                        const indexes& unconfirmed)
+    {
+        validate_time.record(metrics::since(start));
+        (ec ? rejected : accepted).increment();
+        handler(ec, tx, unconfirmed);
+    };
+
+    auto handle_validated =
         dispatch_.ordered_delegate(&transaction_pool::handle_validated,
-                                   this, _1, _2, _3, handler));
+                                   this, _1, _2, _3, _4, timed);
+
+    // The validation invokes its handler, so it is alive to collect the
+    // result from, but must not be retained by it.
+    const std::weak_ptr<validate_transaction> weak(validate);
+    validate->start([weak, handle_validated](const code& ec,
+        transaction_ptr tx, const indexes& unconfirmed) mutable
+    {
+        const auto validated = weak.lock();
+        handle_validated(ec, tx, unconfirmed,
+            validated ? validated->result() : validation{ null_hash, 0, 0, {} });
+    });
 }
 
 void transaction_pool::handle_validated(const code& ec, transaction_ptr tx,
-                                        const indexes& unconfirmed, validate_handler handler)
+                                        const indexes& unconfirmed, const validation& result,
+                                        validate_handler handler)
 {
     if (stopped())
     {
@@ -154,6 +188,7 @@ void transaction_pool::handle_validated(const code& ec, transaction_ptr tx,
         return;
     }
 
+    validations_.store(tx->hash(), result);
     handler(error::success, tx, unconfirmed);
 }
 
@@ -380,6 +415,7 @@ void transaction_pool::delete_tx(const hash_digest& tx_hash)
             {
                 log::debug(LOG_BLOCKCHAIN) << " delete_tx hash:" << libbitcoin::encode_hash(tx_hash) << " success";
                 buffer_.erase(item);
+                pool_size.set(buffer_.size());
                 break;
             }
         }
@@ -531,6 +567,7 @@ void transaction_pool::add(transaction_ptr tx, confirm_handler handler)
         delete_package(error::pool_filled);
 
     buffer_.push_back({ tx, handler });
+    pool_size.set(buffer_.size());
 }
 
 // There has been a reorg, clear the memory pool using the given reason code.
@@ -540,6 +577,8 @@ void transaction_pool::clear(const code& ec)
         entry.handle_confirm(ec, entry.tx);
 
     buffer_.clear();
+    pool_size.set(0);
+    validations_.retain(null_hash);
 }
 
 // Delete memory pool txs that are obsoleted by a new block acceptance.
@@ -551,6 +590,10 @@ void transaction_pool::remove(const block_list& blocks)
     // Delete by spent sets a double-spend error.
     if (maintain_consistency_)
         delete_spent_in_blocks(blocks);
+
+    // Only validations against the new tip can be reused by the next block.
+    if (!blocks.empty())
+        validations_.retain(blocks.back()->header.hash());
 }
 
 // Consistency methods.
@@ -562,7 +605,7 @@ void transaction_pool::delete_confirmed_in_blocks(const block_list& blocks)
     if (stopped() || buffer_.empty())
         return;
 
-    for (const auto block : blocks)
+    for (const auto& block : blocks)
         for (const auto& tx : block->transactions)
             delete_single(tx.hash(), error::success);
 }
@@ -573,7 +616,7 @@ void transaction_pool::delete_spent_in_blocks(const block_list& blocks)
     if (stopped() || buffer_.empty())
         return;
 
-    for (const auto block : blocks)
+    for (const auto& block : blocks)
         for (const auto& tx : block->transactions)
             for (const auto& input : tx.inputs)
                 delete_dependencies(input.previous_output,
@@ -676,9 +719,19 @@ bool transaction_pool::delete_single(const hash_digest& tx_hash, const code& ec)
         buffer_.erase(it);
     }
 
+    pool_size.set(buffer_.size());
     return true;
 }
 
+// Validation reuse.
+// ----------------------------------------------------------------------------
+
+bool transaction_pool::find_validation(validation& out_validation,
+    const hash_digest& tx_hash, const hash_digest& tip) const
+{
+    return validations_.find(out_validation, tx_hash, tip);
+}
+
 bool transaction_pool::find(transaction_ptr& out_tx,
                             const hash_digest& tx_hash) const
 {
@@ -31,6 +31,7 @@
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/block.hpp>
 #include <metaverse/blockchain/block_chain_impl.hpp>
+#include <metaverse/blockchain/pool_validations.hpp>
 #include <metaverse/blockchain/validate_transaction.hpp>
 #include <metaverse/consensus/miner/MinerAux.h>
 #include <metaverse/consensus/libdevcore/BasicType.h>
@@ -55,6 +56,17 @@ static const auto time_stamp_window = asio::seconds(2 * 60 * 60);
 
 static const auto time_stamp_window_future_blocktime_fix = asio::seconds(24);
 
+static metrics::histogram& validation_timer(const std::string& stage)
+{
+    return *metrics::instance().make_histogram("mvs_block_validate_seconds",
+        "Time spent in each block validation stage.",
+        "stage=\"" + stage + "\"");
+}
+
+static auto& pooled_transactions = *metrics::instance().make_counter(
+    "mvs_block_pooled_transactions_total",
+    "Block transactions connected using their memory pool validation.");
+
 // The nullptr option is for backward compatibility only.
 validate_block::validate_block(uint64_t height, const block& block, bool testnet,
                                const config::checkpoint::list& checks, stopped_callback callback)
@@ -236,6 +248,9 @@ code validate_block::check_coinbase(const chain::header& prev_header, bool check
 
 code validate_block::check_block(blockchain::block_chain_impl& chain) const
 {
+    static auto& elapsed = validation_timer("check");
+    const metrics::scoped_timer timed(elapsed);
+
     // These are checks that are independent of the blockchain
     // that can be validated before saving an orphan block.
 
@@ -382,6 +397,9 @@ bool validate_block::check_time_stamp(uint32_t timestamp, const asio::seconds& w
 // BUGBUG: we should confirm block hash doesn't exist.
 code validate_block::accept_block() const
 {
+    static auto& elapsed = validation_timer("accept");
+    const metrics::scoped_timer timed(elapsed);
+
     const auto& header = current_block_.header;
     if (!header.is_proof_of_dpos() && header.bits != work_required(testnet_))
         return error::incorrect_proof_of_work;
@@ -406,9 +424,15 @@ code validate_block::accept_block() const
 u256 validate_block::work_required(bool is_testnet) const
 {
     uint32_t version = current_block_.header.version;
-    chain::header prev_header = fetch_block(height_ - 1);
-    header::ptr last_header = get_last_block_header(prev_header, version);
+    header::ptr last_header;
     header::ptr llast_header;
+    if (get_retarget_headers(last_header, llast_header, version)) {
+        return HeaderAux::calculate_difficulty(
+            current_block_.header, last_header, llast_header);
+    }
+
+    chain::header prev_header = fetch_block(height_ - 1);
+    last_header = get_last_block_header(prev_header, version);
     if (last_header && last_header->number > 2) {
         auto height = last_header->number - 1;
         chain::header prev_last_header = fetch_block(height);
@@ -445,6 +469,9 @@ bool validate_block::is_valid_coinbase_height(uint64_t height, const block& bloc
 
 code validate_block::connect_block(hash_digest& err_tx, blockchain::block_chain_impl& chain) const
 {
+    static auto& elapsed = validation_timer("connect");
+    const metrics::scoped_timer timed(elapsed);
+
     err_tx = null_hash;
     const auto& transactions = current_block_.transactions;
 
@@ -472,6 +499,28 @@ code validate_block::connect_block(hash_digest& err_tx, blockchain::block_chain_
     uint64_t coinage_reward_coinbase_index = !is_pos ? 1 : 2;
     uint64_t get_coinage_reward_tx_count = 0;
 
+    // Transactions accepted into the pool against the parent of this block
+    // keep their input and rule checks, only their interactions with the
+    // rest of the block are checked here.
+    const auto& parent = current_block_.header.previous_block_hash;
+    const auto on_tip = get_fork_index() + 1 == height_;
+    std::vector<bool> pooled(count, false);
+    pooled_connect connector;
+
+    const auto connect_pooled = [&](const transaction& tx,
+        const transaction_pool::validation& validation, uint64_t& value_in)
+    {
+        if (!connector.connect(tx, validation))
+            return false;
+
+        total_sigops += validation.sigops;
+        if (total_sigops > max_block_script_sigops)
+            return false;
+
+        value_in = validation.value_in;
+        return true;
+    };
+
     ////////////// TODO: parallelize. //////////////
     for (uint64_t tx_index = 0; tx_index < count; ++tx_index)
     {
@@ -484,7 +533,10 @@ code validate_block::connect_block(hash_digest& err_tx, blockchain::block_chain_
 
         // Count sigops for coinbase tx, but no other checks.
         if (tx.is_coinbase())
+        {
+            connector.add(tx);
             continue;
+        }
 
         if (version == block_version_pos){
             if (tx_index == 1 && tx.is_coinstake()){
@@ -504,14 +556,35 @@ code validate_block::connect_block(hash_digest& err_tx, blockchain::block_chain_
 
         RETURN_IF_STOPPED();
 
+        transaction_pool::validation validation;
+        pooled[tx_index] = on_tip && !is_coinstake &&
+            chain.pool().find_validation(validation, tx.hash(), parent);
+
+        if (pooled[tx_index])
+        {
+            if (!connect_pooled(tx, validation, value_in))
+            {
+                log::debug(LOG_BLOCKCHAIN) << "connect pooled transaction of block failed. tx hash:"
+                    << encode_hash(tx.hash());
+                err_tx = tx.hash();
+                return error::validate_inputs_failed;
+            }
+
+            pooled_transactions.increment();
+        }
+
         // Consensus checks here.
-        if (!validate_inputs(tx, tx_index, value_in, total_sigops))
+        else if (!validate_inputs(tx, tx_index, value_in, total_sigops))
         {
             log::debug(LOG_BLOCKCHAIN) << "validate inputs of block failed. tx hash:"
                 << encode_hash(tx.hash());
             err_tx = tx.hash();
             return error::validate_inputs_failed;
         }
+        else
+        {
+            connector.add(tx);
+        }
 
         RETURN_IF_STOPPED();
 
@@ -587,14 +660,19 @@ code validate_block::connect_block(hash_digest& err_tx, blockchain::block_chain_
     std::set<string> dids;
     std::set<string> didaddreses;
     code first_tx_ec = error::success;
-    for (const auto& tx : transactions)
+    for (uint64_t tx_index = 0; tx_index < count; ++tx_index)
     {
+        const auto& tx = transactions[tx_index];
+
         RETURN_IF_STOPPED();
 
-        const auto validate_tx = std::make_shared<validate_transaction>(chain, tx, *this);
-        auto ec = validate_tx->check_transaction();
-        if (!ec) {
-            ec = validate_tx->check_transaction_connect_input(current_block_.header.number);
+        code ec = error::success;
+        if (!pooled[tx_index]) {
+            const auto validate_tx = std::make_shared<validate_transaction>(chain, tx, *this);
+            ec = validate_tx->check_transaction();
+            if (!ec) {
+                ec = validate_tx->check_transaction_connect_input(current_block_.header.number);
+            }
         }
 
         for (uint64_t i = 0; (!ec) && (i < tx.outputs.size()); ++i) {
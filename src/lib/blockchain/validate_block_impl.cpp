@@ -238,6 +238,17 @@ chain::header::ptr validate_block_impl::get_last_block_header(const chain::heade
     return get_prev_block_header(parent_header.number, static_cast<chain::block_version>(version));
 }
 
+bool validate_block_impl::get_retarget_headers(chain::header::ptr& out_last,
+    chain::header::ptr& out_previous, uint32_t version) const
+{
+    // Only the main chain is indexed, so the parent must be below the fork.
+    if (height_ > fork_index_ + 1)
+        return false;
+
+    return chain_.get_retarget_headers(out_last, out_previous, height_,
+        version);
+}
+
 bool tx_after_fork(uint64_t tx_height, uint64_t fork_index)
 {
     return tx_height > fork_index;
@@ -523,13 +534,28 @@ bool validate_block_impl::can_use_dpos(uint64_t height) const
 chain::header::ptr validate_block_impl::get_prev_block_header(
     uint64_t height, chain::block_version ver, bool same_version) const
 {
-    auto get_header = [this](chain::header& out_header, uint64_t height) -> bool
-    {
-        out_header = this->fetch_block(height);
-        return true;
-    };
+    // Walk the orphan branch here, the main chain below the fork is indexed.
+    if (height > fork_index_ + 1) {
+        for (auto index = height - 1; index > fork_index_; --index) {
+            if (same_version) {
+                if (ver == chain::block_version_pos && index < pos_enabled_height) {
+                    return nullptr;
+                }
+                else if (ver == chain::block_version_dpos && index < consensus::witness::witness_enable_height) {
+                    return nullptr;
+                }
+            }
+
+            const auto header = fetch_block(index);
+            if ((header.version == ver) == same_version) {
+                return std::make_shared<chain::header>(header);
+            }
+        }
+
+        height = fork_index_ + 1;
+    }
 
-    return chain_.get_prev_block_header_impl(height, ver, same_version, get_header);
+    return chain_.get_prev_block_header(height, ver, same_version);
 }
 
 
@@ -56,7 +56,9 @@ validate_transaction::validate_transaction(block_chain& chain,
       pool_(nullptr),
       dispatch_(nullptr),
       validate_block_(&validate_block),
-      tx_hash_(tx.hash())
+      tx_hash_(tx.hash()),
+      tip_(null_hash),
+      sigops_(0)
 {
 }
 
@@ -67,7 +69,9 @@ validate_transaction::validate_transaction(block_chain& chain,
       pool_(&pool),
       dispatch_(&dispatch),
       validate_block_(nullptr),
-      tx_hash_(tx.hash())
+      tx_hash_(tx.hash()),
+      tip_(null_hash),
+      sigops_(0)
 {
 }
 
@@ -101,6 +105,13 @@ void validate_transaction::start(validate_handler handler)
     BITCOIN_ASSERT(tx_ && pool_ && dispatch_);
 
     handle_validate_ = handler;
+
+    // Validation reads the address and asset indexes.
+    blockchain_.catch_up_indexes();
+
+    // The result can be reused only if the tip is the same when done.
+    tip_ = top_hash();
+
     const auto ec = basic_checks();
 
     if (ec) {
@@ -123,6 +134,22 @@ void validate_transaction::start(validate_handler handler)
                                       shared_from_this(), _1));
 }
 
+transaction_pool::validation validate_transaction::result() const
+{
+    return { tip_, value_in_, sigops_, unconfirmed_ };
+}
+
+hash_digest validate_transaction::top_hash() const
+{
+    uint64_t height;
+    chain::header header;
+    if (!blockchain_.get_last_height(height) ||
+        !blockchain_.get_header(header, height))
+        return null_hash;
+
+    return header.hash();
+}
+
 code validate_transaction::basic_checks() const
 {
     if (tx_->is_coinbase()) {
@@ -181,6 +208,7 @@ void validate_transaction::reset(uint64_t last_height)
     // Used for checking coinbase maturity
     last_block_height_ = last_height;
     current_input_ = 0;
+    sigops_ = 0;
     value_in_ = 0;
     asset_amount_in_ = 0;
     asset_certs_in_.clear();
@@ -197,39 +225,18 @@ void validate_transaction::set_last_height(const code& ec, uint64_t last_height)
 
     reset(last_height);
 
-    // Begin looping through the inputs, fetching the previous tx.
-    if (!tx_->inputs.empty())
-        next_previous_transaction();
-}
-
-void validate_transaction::next_previous_transaction()
-{
-    BITCOIN_ASSERT(current_input_ < tx_->inputs.size());
-
-    // First we fetch the parent block height for a transaction.
-    // Needed for checking the coinbase maturity.
-    blockchain_.fetch_transaction_index(
-        tx_->inputs[current_input_].previous_output.hash,
-        dispatch_->unordered_delegate(
-            &validate_transaction::previous_tx_index,
-            shared_from_this(), _1, _2));
-}
-
-void validate_transaction::previous_tx_index(const code& ec,
-        uint64_t parent_height)
-{
-    if (ec) {
-        search_pool_previous_tx();
+    if (tx_->inputs.empty())
         return;
-    }
 
-    BITCOIN_ASSERT(current_input_ < tx_->inputs.size());
-    const auto& prev_tx_hash = tx_->inputs[current_input_].previous_output.hash;
+    chain::point::list points;
+    points.reserve(tx_->inputs.size());
+    for (const auto& input: tx_->inputs)
+        points.push_back(input.previous_output);
 
-    // Now fetch actual transaction body
-    blockchain_.fetch_transaction(prev_tx_hash,
-                                  dispatch_->unordered_delegate(&validate_transaction::handle_previous_tx,
-                                          shared_from_this(), _1, _2, parent_height));
+    // Resolve all previous outputs in one read, falling back to the pool.
+    blockchain_.fetch_prevouts(points, pool_,
+        dispatch_->unordered_delegate(&validate_transaction::handle_prevouts,
+            shared_from_this(), _1, _2));
 }
 
 bool validate_transaction::get_previous_tx(chain::transaction& prev_tx,
@@ -255,76 +262,70 @@ bool validate_transaction::get_previous_tx(chain::transaction& prev_tx,
     return false; // failed
 }
 
-void validate_transaction::search_pool_previous_tx()
-{
-    transaction previous_tx;
-    const auto& current_input = tx_->inputs[current_input_];
-
-    if (!pool_->find(previous_tx, current_input.previous_output.hash))
-    {
-        log::debug(LOG_BLOCKCHAIN) << "search_pool_previous_tx failed: prev hash"
-                                   << encode_hash(current_input.previous_output.hash);
-        const auto list = point::indexes{ current_input_ };
-        handle_validate_(error::input_not_found, tx_, list);
-        return;
-    }
-
-    // parent_height ignored here as mempool transactions cannot be coinbase.
-    BITCOIN_ASSERT(!previous_tx.is_coinbase());
-    static constexpr uint64_t parent_height = 0;
-    handle_previous_tx(error::success, previous_tx, parent_height);
-    unconfirmed_.push_back(current_input_);
-}
-
-void validate_transaction::handle_previous_tx(const code& ec,
-        const transaction& previous_tx, uint64_t parent_height)
+void validate_transaction::handle_prevouts(const code& ec,
+    const block_chain_impl::prevout::list& prevouts)
 {
     if (ec) {
-        log::debug(LOG_BLOCKCHAIN) << "handle_previous_tx failed: error: "
-                                   << std::to_string(ec.value()) << ", prev hash: "
-                                   << encode_hash(previous_tx.hash());
-        const auto list = point::indexes{ current_input_ };
-        handle_validate_(error::input_not_found, tx_, list);
+        handle_validate_(ec, tx_, {});
         return;
     }
 
-    ///////////////////////////////////////////////////////////////////////////
-    // HACK: this assumes that the mempool is operating at min block version 4.
-    ///////////////////////////////////////////////////////////////////////////
+    BITCOIN_ASSERT(prevouts.size() == tx_->inputs.size());
 
-    // Should check if inputs are standard here...
-    if (!connect_input(previous_tx, parent_height))
+    for (current_input_ = 0; current_input_ < tx_->inputs.size();
+        ++current_input_)
     {
-        log::debug(LOG_BLOCKCHAIN) << "connect_input of transaction failed. prev tx hash:"
-            << encode_hash(previous_tx.hash());
-        const auto list = point::indexes{ current_input_ };
-        handle_validate_(error::validate_inputs_failed, tx_, list);
-        return;
-    }
+        const auto& prevout = prevouts[current_input_];
+        const auto& previous_hash =
+            tx_->inputs[current_input_].previous_output.hash;
+
+        if (!prevout.found) {
+            log::debug(LOG_BLOCKCHAIN) << "previous output not found: prev hash"
+                                       << encode_hash(previous_hash);
+            const auto list = point::indexes{ current_input_ };
+            handle_validate_(error::input_not_found, tx_, list);
+            return;
+        }
 
-    // Search for double spends...
-    blockchain_.fetch_spend(tx_->inputs[current_input_].previous_output,
-                            dispatch_->unordered_delegate(&validate_transaction::check_double_spend,
-                                    shared_from_this(), _1, _2));
-}
+        ///////////////////////////////////////////////////////////////////////
+        // HACK: this assumes that the mempool is operating at min block version 4.
+        ///////////////////////////////////////////////////////////////////////
 
-void validate_transaction::check_double_spend(const code& ec,
-        const chain::input_point&)
-{
-    if (ec.value() != error::unspent_output)
-    {
-        handle_validate_(error::double_spend, tx_, {});
-        return;
-    }
+        // Should check if inputs are standard here...
+        if (!prevout.valid ||
+            !connect_input(prevout.output, prevout.coinbase, prevout.height))
+        {
+            log::debug(LOG_BLOCKCHAIN) << "connect_input of transaction failed. prev tx hash:"
+                << encode_hash(previous_hash);
+            const auto list = point::indexes{ current_input_ };
+            handle_validate_(error::validate_inputs_failed, tx_, list);
+            return;
+        }
 
-    // End of connect_input checks.
-    ++current_input_;
-    if (current_input_ < tx_->inputs.size())
-    {
-        next_previous_transaction();
-        return;
+        // The pool checked for spends in the pool, this is for the store.
+        if (prevout.spent)
+        {
+            handle_validate_(error::double_spend, tx_, {});
+            return;
+        }
+
+        // Mempool transactions cannot be coinbase, so their height is unused.
+        if (!prevout.confirmed)
+            unconfirmed_.push_back(current_input_);
+
+        // Counted for the block limit, which a block checks itself if the
+        // script cannot be parsed here.
+        uint64_t sigops;
+        if (validate_block::script_hash_signature_operations_count(sigops,
+            prevout.output.script, tx_->inputs[current_input_].script))
+            sigops_ += sigops;
+        else
+            tip_ = null_hash;
     }
 
+    if (top_hash() != tip_)
+        tip_ = null_hash;
+
     // current_input_ will be invalid on last pass.
     check_fees();
 }
@@ -1777,7 +1778,13 @@ bool validate_transaction::connect_input( const transaction& previous_tx, uint64
         return false;
     }
 
-    const auto& previous_output = previous_tx.outputs[previous_outpoint.index];
+    return connect_input(previous_tx.outputs[previous_outpoint.index],
+        previous_tx.is_coinbase(), parent_height);
+}
+
+bool validate_transaction::connect_input(const chain::output& previous_output,
+    bool coinbase, uint64_t parent_height)
+{
     const auto output_value = previous_output.value;
     if (output_value > max_money()) {
         log::debug(LOG_BLOCKCHAIN) << "output etp value exceeds max amount!";
@@ -1818,7 +1825,7 @@ bool validate_transaction::connect_input( const transaction& previous_tx, uint64
         }
     }
 
-    if (previous_tx.is_coinbase()) {
+    if (coinbase) {
         if (coinbase_maturity > blockchain_.calc_number_of_blocks(parent_height, last_block_height_)) {
             log::debug(LOG_BLOCKCHAIN)
                 << "coinbase not maturity from "
@@ -1,5 +1,7 @@
 
 #include <metaverse/consensus/miner/MinerAux.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <array>
 #include <thread>
@@ -36,13 +38,99 @@ MinerAux* MinerAux::get()
     return s_this;
 }
 
-LightType MinerAux::get_light(h256& _seedHash)
+// Light caches retained for reuse: the previous, current and next epochs.
+static constexpr size_t max_lights = 3;
+
+// The distance before an epoch boundary at which the next cache is built.
+static constexpr uint64_t light_warmup_blocks = ETHASH_EPOCH_LENGTH / 10;
+
+MinerAux::LightFuture MinerAux::find_light(h256& _seedHash, LightPromise& _build)
 {
-    UpgradableGuard l(get()->x_lights);
-    if (get()->m_lights.count(_seedHash))
-        return get()->m_lights.at(_seedHash);
+    auto self = get();
+    UpgradableGuard l(self->x_lights);
+    auto it = self->m_lights.find(_seedHash);
+    if (it != self->m_lights.end())
+    {
+        _build = it->second.build;
+        return it->second.future;
+    }
+
+    // The cache is built outside of the lock, concurrent callers for the
+    // same seed wait on the future and other seeds are not blocked.
     UpgradeGuard l2(l);
-    return (get()->m_lights[_seedHash] = make_shared<LightAllocation>(_seedHash));
+    _build = std::make_shared<LightBuild>();
+    LightFuture future = _build->promise.get_future().share();
+    self->m_lights[_seedHash] = { future, _build };
+    self->m_lightOrder.push_back(_seedHash);
+
+    // Evicted caches stay alive while referenced by a verifying thread.
+    while (self->m_lightOrder.size() > max_lights)
+    {
+        self->m_lights.erase(self->m_lightOrder.front());
+        self->m_lightOrder.erase(self->m_lightOrder.begin());
+    }
+
+    return future;
+}
+
+void MinerAux::build_light(h256 _seedHash, LightPromise _build)
+{
+    if (_build->claimed.exchange(true))
+        return;
+
+    try {
+        _build->promise.set_value(make_shared<LightAllocation>(_seedHash));
+    }
+    catch (...) {
+        // Forget the seed so that a later call may try again.
+        auto self = get();
+        DEV_WRITE_GUARDED(self->x_lights)
+        {
+            self->m_lights.erase(_seedHash);
+            auto& order = self->m_lightOrder;
+            order.erase(std::remove(order.begin(), order.end(), _seedHash), order.end());
+        }
+        _build->promise.set_exception(std::current_exception());
+    }
+}
+
+LightType MinerAux::get_light(h256& _seedHash)
+{
+    LightPromise build;
+    auto future = find_light(_seedHash, build);
+    build_light(_seedHash, build);
+    return future.get();
+}
+
+void MinerAux::attach(threadpool* pool)
+{
+    DEV_GUARDED(get()->x_pool)
+    get()->m_pool = pool;
+}
+
+void MinerAux::prepare_light(uint64_t height)
+{
+    if (height % ETHASH_EPOCH_LENGTH < ETHASH_EPOCH_LENGTH - light_warmup_blocks)
+        return;
+
+    chain::header next;
+    next.number = (height / ETHASH_EPOCH_LENGTH + 1) * ETHASH_EPOCH_LENGTH;
+    h256 seed = HeaderAux::seedHash(next);
+
+    LightPromise build;
+    find_light(seed, build);
+    if (build->claimed.load())
+        return;
+
+    // The posted job is dropped if the pool is stopped first, the build then
+    // remains unclaimed for the first verifier of the epoch.
+    auto self = get();
+    DEV_GUARDED(self->x_pool)
+    if (self->m_pool != nullptr)
+        self->m_pool->service().post([seed, build]()
+        {
+            build_light(seed, build);
+        });
 }
 
 //static std::function<int(unsigned)> s_dagCallback;
@@ -130,22 +218,21 @@ bool MinerAux::verify_work(const libbitcoin::chain::header& header, const libbit
     h256 headerHash  = HeaderAux::hashHead(header);
     Nonce nonce = (Nonce)header.nonce;
 
+    // Only the lookup is guarded, computation runs concurrently.
+    FullType dag;
     DEV_GUARDED(get()->x_fulls)
-    if (FullType dag = get()->m_fulls[seedHash].lock()) {
-        result = dag->compute(headerHash, nonce);
+    dag = get()->m_fulls[seedHash].lock();
 
-        if (result.value <= HeaderAux::boundary(header)
-            && (result.mixHash).hex() == ((h256)header.mixhash).hex()) {
-            //log::debug(LOG_MINER) << header.number <<" block has been verified (Full)\n";
-            return true;
-        }
-        return false;
+    if (dag) {
+        result = dag->compute(headerHash, nonce);
+    }
+    else {
+        prepare_light(header.number);
+        result = get_light(seedHash)->compute(headerHash, nonce);
     }
 
-    result = get()->get_light(seedHash)->compute(headerHash, nonce);
     if (result.value <= HeaderAux::boundary(header)
-        && (result.mixHash).hex() == ((h256)header.mixhash).hex()) {
-        //log::debug(LOG_MINER) << header.number <<" block has been verified (Light)\n";
+        && result.mixHash == (h256)header.mixhash) {
         return true;
     }
 
@@ -153,6 +240,61 @@ bool MinerAux::verify_work(const libbitcoin::chain::header& header, const libbit
     return false;
 }
 
+void MinerAux::verify_work(threadpool& pool, header_list_ptr headers,
+    verify_handler handler)
+{
+    struct batch
+    {
+        batch(size_t count, size_t jobs, verify_handler&& handler)
+          : next(0), failed(count), remaining(jobs), handler(std::move(handler))
+        {
+        }
+
+        std::atomic<size_t> next;
+        std::atomic<size_t> failed;
+        std::atomic<size_t> remaining;
+        const verify_handler handler;
+    };
+
+    const auto count = headers->size();
+    if (count == 0)
+    {
+        handler(count);
+        return;
+    }
+
+    prepare_light(headers->back().number);
+
+    // Jobs beyond the number of pool threads find the list exhausted.
+    const auto threads = std::max<size_t>(1, pool.size());
+    const auto jobs = std::min(threads, count);
+    const auto state = std::make_shared<batch>(count, jobs, std::move(handler));
+
+    const auto verify = [headers, state, count]()
+    {
+        for (auto index = state->next++; index < count; index = state->next++)
+        {
+            // Headers above a known failure need not be verified.
+            if (index > state->failed.load())
+                break;
+
+            const auto& header = (*headers)[index];
+            if (!header.is_proof_of_work() || verify_work(header, nullptr))
+                continue;
+
+            auto lowest = state->failed.load();
+            while (index < lowest && !state->failed.compare_exchange_weak(lowest, index));
+        }
+
+        // The last job to finish reports the batch.
+        if (--state->remaining == 0)
+            state->handler(state->failed.load());
+    };
+
+    for (size_t job = 0; job < jobs; ++job)
+        pool.service().post(verify);
+}
+
 bool MinerAux::verify_stake(const chain::header& header, const chain::output_info& stake_output)
 {
     // Base target
@@ -912,7 +912,8 @@ miner::block_ptr miner::create_new_block_pos(
         return nullptr;
     }
 
-    // Check deposited stake
+    // Check deposited stake, which is read from the address history.
+    block_chain.catch_up_indexes();
     if (!block_chain.check_pos_capability(last_height, pay_address)) {
         log::error(LOG_HEADER) << "no enough pos stake is locked at address " << pay_address;
         sleep_for_mseconds(10 * 1000);
@@ -1056,9 +1057,15 @@ miner::block_ptr miner::create_new_block_pos(
 u256 miner::get_next_target_required(const chain::header& header, const chain::header& prev_header)
 {
     blockchain::block_chain_impl& block_chain = node_.chain_impl();
-    chain::header::ptr last_header = block_chain.get_last_block_header(prev_header, header.version);
+    chain::header::ptr last_header;
     chain::header::ptr llast_header;
 
+    if (block_chain.get_retarget_headers(last_header, llast_header,
+        prev_header.number + 1, header.version)) {
+        return HeaderAux::calculate_difficulty(header, last_header, llast_header);
+    }
+
+    last_header = block_chain.get_last_block_header(prev_header, header.version);
     if (last_header && last_header->number > 2) {
         auto height = last_header->number - 1;
         chain::header prev_last_header;
@@ -1530,7 +1537,12 @@ void miner::get_state(uint64_t &height, uint64_t &rate, std::string& difficulty,
     u256 pos_bits = (u256)HeaderAux::get_minimum_difficulty(height, chain::block_version_pos);
     auto version = get_accept_block_version();
     if (version == chain::block_version_pow || version == chain::block_version_pos) {
-        auto header = block_chain.get_prev_block_header(height + 1, version, true);
+        chain::header::ptr header;
+        chain::header::ptr unused;
+        if (!block_chain.get_retarget_headers(header, unused, height + 1, version)) {
+            header = block_chain.get_prev_block_header(height + 1, version, true);
+        }
+
         if (header) {
             difficulty = to_string((u256)header->bits);
             if (version == chain::block_version_pos) {
@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/address_key.hpp>
+
+#include <string>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+short_hash address_key::from_address(const wallet::payment_address& address)
+{
+    // The version is included as an address hash may be both a key hash and
+    // a script hash.
+    const auto& hash = address.hash();
+    data_chunk data;
+    data.reserve(1 + hash.size());
+    data.push_back(address.version());
+    extend_data(data, hash);
+    return ripemd160_hash(data);
+}
+
+short_hash address_key::from_string(const std::string& address)
+{
+    const wallet::payment_address decoded(address);
+    return decoded ? from_address(decoded) : null_short_hash;
+}
+
+short_hash address_key::legacy(const wallet::payment_address& address)
+{
+    const auto encoded = address.encoded();
+    return ripemd160_hash(data_chunk(encoded.begin(), encoded.end()));
+}
+
+} // namespace database
+} // namespace libbitcoin
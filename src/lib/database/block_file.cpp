@@ -0,0 +1,443 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/block_file.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::chain;
+
+static constexpr uint32_t file_magic = 0x4253564d; // "MVSB"
+static constexpr uint32_t file_version = 1;
+
+// Blocks are parsed in batches, a few of which may wait to be stored.
+static constexpr size_t batch_size = 256;
+static constexpr size_t queued_batches = 4;
+static constexpr size_t sync_interval = 10000;
+static constexpr uint32_t max_block_size = 64 * 1024 * 1024;
+
+static void write_4_bytes(std::ostream& stream, uint32_t value)
+{
+    const auto bytes = to_little_endian(value);
+    stream.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+static bool read_4_bytes(std::istream& stream, uint32_t& out)
+{
+    byte_array<sizeof(uint32_t)> bytes;
+    stream.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+    out = from_little_endian_unsafe<uint32_t>(bytes.begin());
+    return static_cast<bool>(stream);
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+static bool read_block(block& out, const data_base& database, size_t height)
+{
+    const auto result = database.blocks.get(height);
+    if (!result)
+        return false;
+
+    out.header = result.header();
+    out.header.transaction_count = result.transaction_count();
+
+    if (out.header.is_proof_of_stake() || out.header.is_proof_of_dpos())
+        out.blocksig = result.blocksig();
+
+    if (out.header.is_proof_of_dpos())
+        out.public_key = result.public_key();
+
+    hash_list hashes;
+    hashes.reserve(result.transaction_count());
+    for (size_t index = 0; index < result.transaction_count(); ++index)
+        hashes.push_back(result.transaction_hash(index));
+
+    if (database.transactions.get_block(out.transactions, hashes, height))
+        return true;
+
+    out.transactions.clear();
+    for (const auto& hash: hashes)
+    {
+        const auto tx_result = database.transactions.get(hash);
+        if (!tx_result)
+            return false;
+
+        out.transactions.push_back(tx_result.transaction());
+    }
+
+    return true;
+}
+
+bool block_file::export_blocks(const settings& settings, const path& file)
+{
+    data_base database(settings);
+    if (!database.start())
+    {
+        log::error(LOG_DATABASE)
+            << "Failed to open the database, is the node running?";
+        return false;
+    }
+
+    size_t top;
+    if (!database.blocks.top(top))
+        return database.stop();
+
+    bc::ofstream stream(file.string(), std::ofstream::binary);
+    write_4_bytes(stream, file_magic);
+    write_4_bytes(stream, file_version);
+
+    log::info(LOG_DATABASE)
+        << "Exporting blocks 0 to " << top << " to " << file;
+
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t bytes = 0;
+
+    for (size_t height = 0; height <= top && stream; ++height)
+    {
+        block block;
+        if (!read_block(block, database, height))
+        {
+            log::error(LOG_DATABASE)
+                << "Failed to read block " << height << " from the store.";
+            return false;
+        }
+
+        const auto data = block.to_data();
+        write_4_bytes(stream, static_cast<uint32_t>(height));
+        write_4_bytes(stream, static_cast<uint32_t>(data.size()));
+        stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+        bytes += data.size();
+
+        if (height % sync_interval == 0)
+            log::info(LOG_DATABASE)
+                << "Exporting blocks, height " << height << " of " << top;
+    }
+
+    stream.flush();
+    if (!stream)
+    {
+        log::error(LOG_DATABASE) << "Failed to write " << file;
+        return false;
+    }
+
+    log::info(LOG_DATABASE)
+        << "Exported " << top + 1 << " blocks (" << bytes << " bytes) in "
+        << seconds_since(start) << "s.";
+
+    return database.stop();
+}
+
+// Import pipeline.
+// ----------------------------------------------------------------------------
+
+namespace {
+
+struct batch
+{
+    std::vector<uint32_t> heights;
+    std::vector<data_chunk> frames;
+    block::list blocks;
+    std::string error;
+};
+
+// Reads the file and parses each batch across threads while the previous
+// batches are stored, in order, by the caller.
+class block_loader
+{
+public:
+    block_loader(std::istream& stream, size_t threads)
+      : stream_(stream), threads_(threads), stopped_(false), done_(false)
+    {
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ~block_loader()
+    {
+        stop();
+        thread_.join();
+    }
+
+    // False when the file is exhausted.
+    bool next(batch& out)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this]() { return !batches_.empty() || done_; });
+
+        if (batches_.empty())
+            return false;
+
+        out = std::move(batches_.front());
+        batches_.pop_front();
+        space_.notify_one();
+        return true;
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        space_.notify_all();
+    }
+
+private:
+    bool read(batch& out)
+    {
+        uint32_t height;
+        uint32_t size;
+        while (out.frames.size() < batch_size && read_4_bytes(stream_, height))
+        {
+            if (!read_4_bytes(stream_, size) || size > max_block_size)
+            {
+                out.error = "truncated or corrupt frame";
+                return true;
+            }
+
+            data_chunk frame(size);
+            stream_.read(reinterpret_cast<char*>(frame.data()), size);
+            if (!stream_)
+            {
+                out.error = "truncated block";
+                return true;
+            }
+
+            out.heights.push_back(height);
+            out.frames.push_back(std::move(frame));
+        }
+
+        return !out.frames.empty();
+    }
+
+    // Context free checks, which also cache the transaction hashes.
+    static bool check(block& out, const data_chunk& frame)
+    {
+        return out.from_data(frame) &&
+            out.header.transaction_count == out.transactions.size() &&
+            block::generate_merkle_root(out.transactions) == out.header.merkle;
+    }
+
+    void parse(batch& out)
+    {
+        const auto count = out.frames.size();
+        out.blocks.resize(count);
+        std::vector<uint8_t> valid(count, 0);
+        std::atomic<size_t> next(0);
+
+        const auto work = [&]()
+        {
+            for (auto index = next++; index < count; index = next++)
+                valid[index] = check(out.blocks[index], out.frames[index]);
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t thread = 1; thread < threads_; ++thread)
+            workers.emplace_back(work);
+
+        work();
+        for (auto& worker: workers)
+            worker.join();
+
+        out.frames.clear();
+
+        // Keep the blocks before the first invalid one.
+        const auto invalid = std::find(valid.begin(), valid.end(), 0);
+        if (invalid == valid.end())
+            return;
+
+        const auto size = static_cast<size_t>(invalid - valid.begin());
+        out.blocks.resize(size);
+        out.heights.resize(size);
+        out.error = "invalid block";
+    }
+
+    void run()
+    {
+        while (true)
+        {
+            batch next;
+            const auto more = read(next);
+            if (more)
+                parse(next);
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            space_.wait(lock, [this]()
+            {
+                return stopped_ || batches_.size() < queued_batches;
+            });
+
+            if (stopped_ || !more)
+                break;
+
+            const auto failed = !next.error.empty();
+            batches_.push_back(std::move(next));
+            ready_.notify_one();
+
+            if (failed)
+                break;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+        ready_.notify_all();
+    }
+
+    std::istream& stream_;
+    const size_t threads_;
+
+    // These are protected by mutex.
+    std::deque<batch> batches_;
+    bool stopped_;
+    bool done_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable space_;
+
+    std::thread thread_;
+};
+
+} // namespace
+
+bool block_file::import_blocks(const settings& settings, const path& file)
+{
+    bc::ifstream stream(file.string(), std::ifstream::binary);
+
+    uint32_t magic;
+    uint32_t version;
+    if (!read_4_bytes(stream, magic) || !read_4_bytes(stream, version) ||
+        magic != file_magic || version != file_version)
+    {
+        log::error(LOG_DATABASE) << file << " is not a block file.";
+        return false;
+    }
+
+    data_base database(settings);
+    if (!database.start())
+    {
+        log::error(LOG_DATABASE)
+            << "Failed to open the database, is the node running?";
+        return false;
+    }
+
+    size_t top;
+    if (!database.blocks.top(top))
+    {
+        log::error(LOG_DATABASE) << "The database is not initialized.";
+        return false;
+    }
+
+    auto previous = database.blocks.get(top).header().hash();
+    auto next_height = static_cast<uint64_t>(top) + 1;
+    const auto first_height = next_height;
+
+    log::info(LOG_DATABASE)
+        << "Importing blocks from " << file << " above height " << top;
+
+    const auto threads = std::max(1u, std::thread::hardware_concurrency());
+    const auto start = std::chrono::steady_clock::now();
+    auto success = true;
+
+    {
+        block_loader loader(stream, threads);
+        batch next;
+
+        while (success && loader.next(next))
+        {
+            for (size_t index = 0; index < next.blocks.size(); ++index)
+            {
+                const auto height = next.heights[index];
+                const auto& block = next.blocks[index];
+                const auto hash = block.header.hash();
+
+                // Blocks already stored must be those of the file.
+                if (height < next_height)
+                {
+                    if (database.blocks.get(height).header().hash() != hash)
+                    {
+                        log::error(LOG_DATABASE)
+                            << "Block " << height << " differs from the store.";
+                        success = false;
+                        break;
+                    }
+
+                    continue;
+                }
+
+                if (height != next_height ||
+                    block.header.previous_block_hash != previous)
+                {
+                    log::error(LOG_DATABASE)
+                        << "Block " << height << " does not link to the store.";
+                    success = false;
+                    break;
+                }
+
+                database.push_unindexed(block, height);
+                previous = hash;
+                ++next_height;
+
+                if (next_height % sync_interval == 0)
+                {
+                    database.synchronize();
+                    log::info(LOG_DATABASE)
+                        << "Imported blocks to height " << height;
+                }
+            }
+
+            if (success && !next.error.empty())
+            {
+                log::error(LOG_DATABASE)
+                    << "Failed to import block " << next_height << ", "
+                    << next.error << ".";
+                success = false;
+            }
+        }
+    }
+
+    // Blocks stored before a failure are kept and indexed.
+    database.synchronize();
+    const auto imported = next_height - first_height;
+
+    log::info(LOG_DATABASE)
+        << "Imported " << imported << " blocks in " << seconds_since(start)
+        << "s, top is now " << next_height - 1;
+
+    return database.build_indexes() && database.stop() && success;
+}
+
+} // namespace database
+} // namespace libbitcoin
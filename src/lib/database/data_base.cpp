@@ -20,15 +20,18 @@
  */
 #include <metaverse/database/data_base.hpp>
 
+#include <chrono>
 #include <cstdint>
 #include <cstddef>
 #include <memory>
 #include <stdexcept>
 #include <algorithm>
+#include <unordered_set>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/bitcoin/utility/path.hpp>
 #include <metaverse/bitcoin/config/base16.hpp>  // used by db_metadata and push_attachment
+#include <metaverse/database/address_key.hpp>
 #include <metaverse/database/memory/memory_map.hpp>
 #include <metaverse/database/settings.hpp>
 #include <metaverse/database/version.hpp>
@@ -75,6 +78,11 @@ bool data_base::initialize(const path& prefix, const chain::block& genesis)
     auto metadata_path = prefix / db_metadata::file_name;
     auto metadata = db_metadata(db_metadata::current_version);
     data_base::write_metadata(metadata_path, metadata);
+
+    // The address tables of a new database are keyed by address_key.
+    if (!touch_file(paths.address_keys))
+        return false;
+
     instance.push(genesis);
     return instance.stop();
 }
@@ -171,6 +179,156 @@ bool data_base::initialize_witness_profiles(const path& prefix)
     return instance.stop();
 }
 
+bool data_base::initialize_address_balances(const path& prefix,
+    size_t history_height)
+{
+    const store paths(prefix);
+
+    // The build sentinel remains if a previous build was interrupted.
+    if (paths.address_balances_exist() &&
+        !boost::filesystem::exists(paths.address_balances_build))
+        return true;
+
+    if (!touch_file(paths.address_balances_build) ||
+        !paths.touch_address_balances())
+        return false;
+
+    {
+        data_base instance(prefix, 0, 0);
+        if (!instance.create_address_balances() || !instance.stop())
+            return false;
+    }
+
+    log::info(LOG_DATABASE)
+        << "Building address balance table, this may take a while...";
+
+    data_base instance(prefix, history_height, 0);
+    if (!instance.start() || !instance.build_address_balances())
+        return false;
+
+    if (!instance.stop())
+        return false;
+
+    boost::filesystem::remove(paths.address_balances_build);
+
+    log::info(LOG_DATABASE)
+        << "Upgrading address balance table is complete.";
+
+    return true;
+}
+
+bool data_base::initialize_address_locks(const path& prefix,
+    size_t history_height)
+{
+    const store paths(prefix);
+
+    // The build sentinel remains if a previous build was interrupted.
+    if (paths.address_locks_exist() &&
+        !boost::filesystem::exists(paths.address_locks_build))
+        return true;
+
+    if (!touch_file(paths.address_locks_build) ||
+        !paths.touch_address_locks())
+        return false;
+
+    {
+        data_base instance(prefix, 0, 0);
+        if (!instance.create_address_locks() || !instance.stop())
+            return false;
+    }
+
+    log::info(LOG_DATABASE)
+        << "Building address lock table, this may take a while...";
+
+    data_base instance(prefix, history_height, 0);
+    if (!instance.start() || !instance.build_address_locks())
+        return false;
+
+    if (!instance.stop())
+        return false;
+
+    boost::filesystem::remove(paths.address_locks_build);
+
+    log::info(LOG_DATABASE)
+        << "Upgrading address lock table is complete.";
+
+    return true;
+}
+
+bool data_base::initialize_address_keys(const path& prefix)
+{
+    const store paths(prefix);
+
+    // The marker is written once all address tables are rekeyed.
+    if (boost::filesystem::exists(paths.address_keys))
+        return true;
+
+    log::info(LOG_DATABASE)
+        << "Rekeying address tables, this may take a while...";
+
+    data_base instance(prefix, 0, 0);
+    if (!instance.start() || !instance.rekey_addresses())
+        return false;
+
+    if (!instance.stop() || !touch_file(paths.address_keys))
+        return false;
+
+    log::info(LOG_DATABASE)
+        << "Upgrading address keys is complete.";
+
+    return true;
+}
+
+bool data_base::initialize_stealth(const path& prefix)
+{
+    const store paths(prefix);
+
+    // The build sentinel remains if a previous build was interrupted.
+    if (paths.stealth_exist() &&
+        !boost::filesystem::exists(paths.stealth_build))
+        return true;
+
+    if (!touch_file(paths.stealth_build) ||
+        !paths.touch_stealth())
+        return false;
+
+    stealth_database stealth(paths.stealth_prefixes, paths.stealth_payloads);
+    if (!stealth.create())
+        return false;
+
+    if (boost::filesystem::exists(paths.stealth_rows))
+    {
+        log::info(LOG_DATABASE)
+            << "Converting stealth table, this may take a while...";
+
+        transaction_database transactions(paths.transactions_lookup);
+        if (!transactions.start())
+            return false;
+
+        const auto confirmed = [&transactions](uint32_t height,
+            const hash_digest& tx_hash)
+        {
+            const auto result = transactions.get(tx_hash);
+            return result && result.height() == height;
+        };
+
+        if (!stealth.import(paths.stealth_rows, confirmed) ||
+            !transactions.close())
+            return false;
+    }
+
+    if (!stealth.close())
+        return false;
+
+    boost::filesystem::remove(paths.stealth_rows);
+    boost::filesystem::remove(paths.stealth_build);
+
+    log::info(LOG_DATABASE)
+        << "Upgrading stealth table is complete.";
+
+    return true;
+}
+
 bool data_base::upgrade_version_63(const path& prefix)
 {
     auto metadata_path = prefix / db_metadata::file_name;
@@ -243,6 +401,186 @@ bool data_base::upgrade_version_64(const path& prefix)
     return true;
 }
 
+bool data_base::upgrade_version_65(const path& prefix, size_t history_height)
+{
+    auto metadata_path = prefix / db_metadata::file_name;
+    if (!boost::filesystem::exists(metadata_path))
+        return false;
+
+    data_base::db_metadata metadata;
+    data_base::read_metadata(metadata_path, metadata);
+    if (metadata.version_.empty()) {
+        return false; // no version before, initialize all instead of upgrade.
+    }
+
+    if (!initialize_address_balances(prefix, history_height)) {
+        log::error(LOG_DATABASE)
+            << "Failed to upgrade address balance database.";
+        return false;
+    }
+
+    if (metadata.version_ != db_metadata::current_version) {
+        // write new db version to metadata
+        metadata = db_metadata(db_metadata::current_version);
+        data_base::write_metadata(metadata_path, metadata);
+    }
+
+    return true;
+}
+
+bool data_base::upgrade_version_66(const path& prefix, size_t history_height)
+{
+    auto metadata_path = prefix / db_metadata::file_name;
+    if (!boost::filesystem::exists(metadata_path))
+        return false;
+
+    data_base::db_metadata metadata;
+    data_base::read_metadata(metadata_path, metadata);
+    if (metadata.version_.empty()) {
+        return false; // no version before, initialize all instead of upgrade.
+    }
+
+    if (!initialize_address_locks(prefix, history_height)) {
+        log::error(LOG_DATABASE)
+            << "Failed to upgrade address lock database.";
+        return false;
+    }
+
+    if (metadata.version_ != db_metadata::current_version) {
+        // write new db version to metadata
+        metadata = db_metadata(db_metadata::current_version);
+        data_base::write_metadata(metadata_path, metadata);
+    }
+
+    return true;
+}
+
+bool data_base::upgrade_version_67(const path& prefix)
+{
+    auto metadata_path = prefix / db_metadata::file_name;
+    if (!boost::filesystem::exists(metadata_path))
+        return false;
+
+    data_base::db_metadata metadata;
+    data_base::read_metadata(metadata_path, metadata);
+    if (metadata.version_.empty()) {
+        return false; // no version before, initialize all instead of upgrade.
+    }
+
+    if (!initialize_address_keys(prefix)) {
+        log::error(LOG_DATABASE)
+            << "Failed to upgrade address keys.";
+        return false;
+    }
+
+    if (metadata.version_ != db_metadata::current_version) {
+        // write new db version to metadata
+        metadata = db_metadata(db_metadata::current_version);
+        data_base::write_metadata(metadata_path, metadata);
+    }
+
+    return true;
+}
+
+bool data_base::upgrade_version_68(const path& prefix)
+{
+    auto metadata_path = prefix / db_metadata::file_name;
+    if (!boost::filesystem::exists(metadata_path))
+        return false;
+
+    data_base::db_metadata metadata;
+    data_base::read_metadata(metadata_path, metadata);
+    if (metadata.version_.empty()) {
+        return false; // no version before, initialize all instead of upgrade.
+    }
+
+    if (!initialize_stealth(prefix)) {
+        log::error(LOG_DATABASE)
+            << "Failed to upgrade stealth database.";
+        return false;
+    }
+
+    if (metadata.version_ != db_metadata::current_version) {
+        // write new db version to metadata
+        metadata = db_metadata(db_metadata::current_version);
+        data_base::write_metadata(metadata_path, metadata);
+    }
+
+    return true;
+}
+
+bool data_base::convert_transactions(const path& prefix, bool compact)
+{
+    const store paths(prefix);
+    const path target = paths.transactions_lookup.string() + ".convert";
+
+    // A partial table remains if a previous conversion was interrupted.
+    boost::filesystem::remove(target);
+    if (!touch_file(target))
+        return false;
+
+    log::info(LOG_DATABASE)
+        << "Converting transaction table to "
+        << (compact ? "compact" : "full") << " form, this may take a while...";
+
+    const auto start = std::chrono::steady_clock::now();
+    file_offset before;
+    file_offset after;
+
+    {
+        data_base instance(prefix, 0, 0);
+        transaction_database converted(target, nullptr, compact);
+        if (!instance.start() || !converted.create())
+            return false;
+
+        // Store in chain order so that the transactions of each block remain
+        // contiguous for sequential reads.
+        size_t top;
+        const auto empty = !instance.blocks.top(top);
+
+        for (size_t height = 0; !empty && height <= top; ++height)
+        {
+            const auto block_result = instance.blocks.get(height);
+            if (!block_result)
+                return false;
+
+            const auto count = block_result.transaction_count();
+            for (size_t index = 0; index < count; ++index)
+            {
+                const auto tx_hash = block_result.transaction_hash(index);
+                const auto tx_result = instance.transactions.get(tx_hash);
+                if (!tx_result)
+                    return false;
+
+                converted.store(height, index, tx_result.transaction());
+            }
+
+            if (height % 10000 == 0)
+                log::info(LOG_DATABASE)
+                    << "Converting transaction table, height " << height
+                    << " of " << top;
+        }
+
+        converted.sync();
+        before = instance.transactions.size();
+        after = converted.size();
+
+        if (!converted.stop() || !instance.stop())
+            return false;
+    }
+
+    boost::filesystem::rename(target, paths.transactions_lookup);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now() - start);
+
+    log::info(LOG_DATABASE)
+        << "Converting transaction table is complete, " << before
+        << " bytes to " << after << " bytes in " << elapsed.count() << "s.";
+
+    return true;
+}
+
 void data_base::set_admin(const std::string& name, const std::string& passwd)
 {
     accounts.set_admin(name, passwd);
@@ -254,8 +592,7 @@ void data_base::set_blackhole_did()
     const std::string& did_address = wallet::payment_address::blackhole_address;
     did_detail diddetail(did_symbol, did_address);
 
-    data_chunk data(did_address.begin(), did_address.end());
-    short_hash hash = ripemd160_hash(data);
+    const auto hash = address_key::from_string(did_address);
 
     output_point outpoint = { null_hash, max_uint32 };
     uint32_t output_height = max_uint32;
@@ -293,12 +630,23 @@ data_base::store::store(const path& prefix)
     mit_history_lookup = prefix / "mit_history_table"; // for blockchain
     mit_history_rows = prefix / "mit_history_row"; // for blockchain
     witness_profiles_lookup = prefix / "witness_profile_table";   // for blockchain witness profiles
+    address_balances_lookup = prefix / "address_balance_table"; // for blockchain
+    address_balances_rows = prefix / "address_balance_row"; // for blockchain
+    address_balances_build = prefix / "address_balance_build";
+    address_locks_lookup = prefix / "address_lock_table"; // for blockchain
+    address_locks_rows = prefix / "address_lock_row"; // for blockchain
+    address_locks_build = prefix / "address_lock_build";
+    address_keys = prefix / "address_keys";
+    index_height = prefix / "index_height";
 
     // Height-based (reverse) lookup.
     blocks_index = prefix / "block_index";
 
     // One (address) to many (rows).
     history_rows = prefix / "history_rows";
+    stealth_prefixes = prefix / "stealth_prefixes";
+    stealth_payloads = prefix / "stealth_payloads";
+    stealth_build = prefix / "stealth_build";
     stealth_rows = prefix / "stealth_rows";
 
     // Exclusive database access reserved by this process.
@@ -313,7 +661,7 @@ bool data_base::store::touch_all() const
         touch_file(blocks_index) &&
         touch_file(history_lookup) &&
         touch_file(history_rows) &&
-        touch_file(stealth_rows) &&
+        touch_stealth() &&
         touch_file(spends_lookup) &&
         touch_file(transactions_lookup) &&
         /* begin database for account, asset, address_asset relationship */
@@ -336,7 +684,11 @@ bool data_base::store::touch_all() const
         touch_file(address_mits_rows) &&
         touch_file(mit_history_lookup) &&
         touch_file(mit_history_rows) &&
-        touch_file(witness_profiles_lookup);
+        touch_file(witness_profiles_lookup) &&
+        touch_file(address_balances_lookup) &&
+        touch_file(address_balances_rows) &&
+        touch_file(address_locks_lookup) &&
+        touch_file(address_locks_rows);
 }
 
 bool data_base::store::dids_exist() const
@@ -405,6 +757,48 @@ bool data_base::store::touch_witness_profiles() const
     return touch_file(witness_profiles_lookup);
 }
 
+bool data_base::store::address_balances_exist() const
+{
+    return
+        boost::filesystem::exists(address_balances_lookup) ||
+        boost::filesystem::exists(address_balances_rows);
+}
+
+bool data_base::store::touch_address_balances() const
+{
+    return
+        touch_file(address_balances_lookup) &&
+        touch_file(address_balances_rows);
+}
+
+bool data_base::store::address_locks_exist() const
+{
+    return
+        boost::filesystem::exists(address_locks_lookup) ||
+        boost::filesystem::exists(address_locks_rows);
+}
+
+bool data_base::store::touch_address_locks() const
+{
+    return
+        touch_file(address_locks_lookup) &&
+        touch_file(address_locks_rows);
+}
+
+bool data_base::store::stealth_exist() const
+{
+    return
+        boost::filesystem::exists(stealth_prefixes) ||
+        boost::filesystem::exists(stealth_payloads);
+}
+
+bool data_base::store::touch_stealth() const
+{
+    return
+        touch_file(stealth_prefixes) &&
+        touch_file(stealth_payloads);
+}
+
 data_base::db_metadata::db_metadata():version_("")
 {
 }
@@ -528,30 +922,41 @@ void data_base::uninitialize_lock(const path& lock)
     boost::filesystem::remove(lock);
 }
 
+// The file is only present while some stored blocks are not indexed.
+static uint64_t read_index_height(const path& file_path)
+{
+    uint64_t height;
+    bc::ifstream file(file_path.string());
+    return file && (file >> height) ? height : max_uint64;
+}
+
 data_base::data_base(const settings& settings)
   : data_base(settings.directory, settings.history_start_height,
-        settings.stealth_start_height)
+        settings.stealth_start_height, settings.compress_transactions)
 {
 }
 
 data_base::data_base(const path& prefix, size_t history_height,
-    size_t stealth_height)
-  : data_base(store(prefix), history_height, stealth_height)
+    size_t stealth_height, bool compress_transactions)
+  : data_base(store(prefix), history_height, stealth_height,
+        compress_transactions)
 {
 }
 
 data_base::data_base(const store& paths, size_t history_height,
-    size_t stealth_height)
+    size_t stealth_height, bool compress_transactions)
   : lock_file_path_(paths.database_lock),
     history_height_(history_height),
     stealth_height_(stealth_height),
+    index_height_path_(paths.index_height),
+    index_height_(read_index_height(paths.index_height)),
     sequential_lock_(0),
     mutex_(std::make_shared<shared_mutex>()),
     blocks(paths.blocks_lookup, paths.blocks_index, mutex_),
     history(paths.history_lookup, paths.history_rows, mutex_),
-    stealth(paths.stealth_rows, mutex_),
+    stealth(paths.stealth_prefixes, paths.stealth_payloads, mutex_),
     spends(paths.spends_lookup, mutex_),
-    transactions(paths.transactions_lookup, mutex_),
+    transactions(paths.transactions_lookup, mutex_, compress_transactions),
     /* begin database for account, asset, address_asset, did relationship */
     accounts(paths.accounts_lookup, mutex_),
     assets(paths.assets_lookup, mutex_),
@@ -566,7 +971,11 @@ data_base::data_base(const store& paths, size_t history_height,
     mits(paths.mits_lookup, mutex_),
     address_mits(paths.address_mits_lookup, paths.address_mits_rows, mutex_),
     mit_history(paths.mit_history_lookup, paths.mit_history_rows, mutex_),
-    witness_profiles(paths.witness_profiles_lookup, mutex_)
+    witness_profiles(paths.witness_profiles_lookup, mutex_),
+    address_balances(paths.address_balances_lookup,
+        paths.address_balances_rows, mutex_),
+    address_locks(paths.address_locks_lookup, paths.address_locks_rows,
+        mutex_)
 {
 }
 
@@ -628,7 +1037,9 @@ bool data_base::create()
         mits.create() &&
         address_mits.create() &&
         mit_history.create() &&
-        witness_profiles.create()
+        witness_profiles.create() &&
+        address_balances.create() &&
+        address_locks.create()
         ;
 }
 
@@ -665,6 +1076,18 @@ bool data_base::create_witness_profiles()
         witness_profiles.create();
 }
 
+bool data_base::create_address_balances()
+{
+    return
+        address_balances.create();
+}
+
+bool data_base::create_address_locks()
+{
+    return
+        address_locks.create();
+}
+
 // Start must be called before performing queries.
 // Start may be called after stop and/or after close in order to restart.
 bool data_base::start()
@@ -704,7 +1127,9 @@ bool data_base::start()
         mits.start() &&
         address_mits.start() &&
         mit_history.start() &&
-        witness_profiles.start()
+        witness_profiles.start() &&
+        address_balances.start() &&
+        address_locks.start()
         ;
     const auto end_exclusive = end_write();
 
@@ -736,6 +1161,8 @@ bool data_base::stop()
     const auto address_mits_stop = address_mits.stop();
     const auto mit_history_stop = mit_history.stop();
     const auto witness_profiles_stop = witness_profiles.stop();
+    const auto address_balances_stop = address_balances.stop();
+    const auto address_locks_stop = address_locks.stop();
     const auto end_exclusive = end_write();
 
     // This should remove the lock file. This is not important for locking
@@ -766,6 +1193,8 @@ bool data_base::stop()
         address_mits_stop &&
         mit_history_stop &&
         witness_profiles_stop &&
+        address_balances_stop &&
+        address_locks_stop &&
         end_exclusive;
 }
 
@@ -792,6 +1221,8 @@ bool data_base::close()
     const auto address_mits_close = address_mits.close();
     const auto mit_history_close = mit_history.close();
     const auto witness_profiles_close = witness_profiles.close();
+    const auto address_balances_close = address_balances.close();
+    const auto address_locks_close = address_locks.close();
 
     // Return the cumulative result of the database closes.
     return
@@ -814,7 +1245,9 @@ bool data_base::close()
         mits_close &&
         address_mits_close &&
         mit_history_close &&
-        witness_profiles_close
+        witness_profiles_close &&
+        address_balances_close &&
+        address_locks_close
         ;
 }
 
@@ -855,6 +1288,51 @@ bool data_base::end_write()
 // Query engines.
 // ----------------------------------------------------------------------------
 
+// Memory residency.
+// ----------------------------------------------------------------------------
+
+void data_base::warm_up()
+{
+    const auto start = std::chrono::steady_clock::now();
+    log::info(LOG_DATABASE)
+        << "Warming up the database indexes...";
+
+    const auto bytes =
+        blocks.warm_up() +
+        transactions.warm_up() +
+        spends.warm_up() +
+        history.warm_up();
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now() - start);
+    log::info(LOG_DATABASE)
+        << "Warmed up " << (bytes >> 20) << " MiB in " << elapsed.count()
+        << " seconds.";
+}
+
+void data_base::report_residency() const
+{
+    auto files = blocks.residency();
+    for (auto&& list: { transactions.residency(), spends.residency(),
+        history.residency(), stealth.residency() })
+        files.insert(files.end(), list.begin(), list.end());
+
+    for (const auto& file: files)
+    {
+        const auto name = file.file.filename().string();
+        const auto labels = "file=\"" + name + "\"";
+        metrics::instance().make_gauge("mvs_database_mapped_bytes",
+            "Mapped size of a database file.", labels)->set(file.mapped);
+        metrics::instance().make_gauge("mvs_database_resident_bytes",
+            "Page cache resident size of a database file.", labels)->set(
+                file.resident);
+
+        log::info(LOG_DATABASE)
+            << "Resident: " << name << " " << (file.resident >> 20)
+            << " of " << (file.mapped >> 20) << " MiB";
+    }
+}
+
 static size_t get_next_height(const block_database& blocks)
 {
     size_t current_height;
@@ -891,6 +1369,8 @@ void data_base::synchronize()
     mit_history.sync();
     blocks.sync();
     witness_profiles.sync();
+    address_balances.sync();
+    address_locks.sync();
 }
 
 void data_base::synchronize_dids()
@@ -921,14 +1401,327 @@ void data_base::synchronize_witness_profiles()
     witness_profiles.sync();
 }
 
+void data_base::synchronize_address_balances()
+{
+    address_balances.sync();
+}
+
+void data_base::synchronize_address_locks()
+{
+    address_locks.sync();
+}
+
+void data_base::synchronize_address_keys()
+{
+    address_assets.sync();
+    address_dids.sync();
+    address_mits.sync();
+    address_balances.sync();
+    address_locks.sync();
+}
+
+// Address balances.
+// ----------------------------------------------------------------------------
+
+// The locked part of these depends on the height being queried.
+static bool is_encumbered(const output& output)
+{
+    const auto& ops = output.script.operations;
+    return operation::is_pay_key_hash_with_attenuation_model_pattern(ops) ||
+        operation::is_pay_key_hash_with_sequence_lock_pattern(ops);
+}
+
+void data_base::update_balance(const output& output, bool credit)
+{
+    if (!output.is_asset())
+        return;
+
+    const auto address = payment_address::extract(output.script);
+    if (!address)
+        return;
+
+    const auto key = address_key::from_address(address);
+    const auto symbol = output.get_asset_symbol();
+    const auto quantity = output.get_asset_amount();
+    const auto encumbered = is_encumbered(output);
+
+    if (credit)
+        address_balances.credit(key, symbol, quantity, encumbered);
+    else
+        address_balances.debit(key, symbol, quantity, encumbered);
+}
+
+// The spent output is counted, and its lock kept, under the address of its
+// own script, which need not be the address extracted from the spending input.
+void data_base::update_previous(const output_point& previous, bool spent)
+{
+    output prevout;
+
+    {
+        const auto result = transactions.get(previous.hash);
+
+        // Outputs below the history height were never counted.
+        if (!result || result.height() < history_height_)
+            return;
+
+        const auto tx = result.transaction();
+        if (previous.index >= tx.outputs.size())
+            return;
+
+        prevout = tx.outputs[previous.index];
+    }
+
+    update_balance(prevout, !spent);
+    spend_lock(prevout, previous, spent);
+}
+
+// Visit every confirmed output in chain order, to build a new table. Blocks
+// below the history height are skipped, as they are when pushed.
+bool data_base::scan_outputs(const std::string& table, output_visitor visitor)
+{
+    size_t top;
+    if (!blocks.top(top))
+        return true;
+
+    for (size_t height = history_height_; height <= top; ++height)
+    {
+        const auto block_result = blocks.get(height);
+        if (!block_result)
+            return false;
+
+        const auto count = block_result.transaction_count();
+        for (size_t index = 0; index < count; ++index)
+        {
+            const auto tx_hash = block_result.transaction_hash(index);
+            const auto tx_result = transactions.get(tx_hash);
+            if (!tx_result)
+                return false;
+
+            const auto tx = tx_result.transaction();
+            for (uint32_t output = 0; output < tx.outputs.size(); ++output)
+                visitor(tx.outputs[output], { tx_hash, output }, height);
+        }
+
+        if (height % 10000 == 0)
+            log::info(LOG_DATABASE)
+                << "Building " << table << " table, height " << height
+                << " of " << top;
+    }
+
+    return true;
+}
+
+// Credit the unspent asset outputs of the whole chain.
+bool data_base::build_address_balances()
+{
+    const auto credit = [this](const output& output,
+        const output_point& point, size_t)
+    {
+        if (output.is_asset() && !spends.get(point).valid)
+            update_balance(output, true);
+    };
+
+    if (!scan_outputs("address balance", credit))
+        return false;
+
+    synchronize_address_balances();
+    return true;
+}
+
+// Address keys.
+// ----------------------------------------------------------------------------
+
+// Move the rows of every address of the chain from the key of its encoded
+// form to the key of its version and hash. The rows stay in place, only the
+// lookup entries change, so this is safe to repeat if interrupted.
+// Stopping does not persist the lookup record counts, so they are written
+// after each address, otherwise a repeat would allocate over the new keys.
+bool data_base::rekey_addresses()
+{
+    std::unordered_set<payment_address> addresses;
+    addresses.emplace(payment_address::blackhole_address);
+
+    const auto collect = [&addresses](const payment_address& address)
+    {
+        if (address)
+            addresses.insert(address);
+    };
+
+    size_t top;
+    const auto empty = !blocks.top(top);
+
+    for (size_t height = 0; !empty && height <= top; ++height)
+    {
+        const auto block_result = blocks.get(height);
+        if (!block_result)
+            return false;
+
+        const auto count = block_result.transaction_count();
+        for (size_t index = 0; index < count; ++index)
+        {
+            const auto tx_result = transactions.get(
+                block_result.transaction_hash(index));
+            if (!tx_result)
+                return false;
+
+            const auto tx = tx_result.transaction();
+            for (const auto& input: tx.inputs)
+                collect(payment_address::extract(input.script));
+
+            for (const auto& output: tx.outputs)
+            {
+                collect(payment_address::extract(output.script));
+
+                // Did and mit rows are keyed by the address of the attachment,
+                // which need not be the one the output pays.
+                if (output.is_did())
+                    collect(payment_address(output.get_did_address()));
+                else if (output.is_asset_mit())
+                    collect(payment_address(
+                        output.get_asset_mit().get_address()));
+                else if (output.is_asset_cert())
+                    collect(payment_address(
+                        output.get_asset_cert().get_address()));
+                else if (output.is_asset_issue())
+                    collect(payment_address(
+                        output.get_asset_detail().get_address()));
+            }
+        }
+
+        if (height % 10000 == 0)
+            log::info(LOG_DATABASE)
+                << "Collecting addresses, height " << height << " of " << top;
+    }
+
+    size_t moved = 0;
+    for (const auto& address: addresses)
+    {
+        const auto from = address_key::legacy(address);
+        const auto to = address_key::from_address(address);
+
+        // Not all of these, as an address is in a table only if it held one
+        // of its kind of outputs.
+        auto rekeyed = address_assets.rekey(from, to);
+        rekeyed = address_dids.rekey(from, to) || rekeyed;
+        rekeyed = address_mits.rekey(from, to) || rekeyed;
+        rekeyed = address_balances.rekey(from, to) || rekeyed;
+        rekeyed = address_locks.rekey(from, to) || rekeyed;
+
+        if (!rekeyed)
+            continue;
+
+        synchronize_address_keys();
+
+        if (++moved % 100000 == 0)
+        {
+            log::info(LOG_DATABASE)
+                << "Rekeyed " << moved << " of " << addresses.size()
+                << " addresses";
+        }
+    }
+
+    synchronize();
+    log::info(LOG_DATABASE)
+        << "Rekeyed " << moved << " of " << addresses.size() << " addresses";
+
+    return true;
+}
+
+// Address locks.
+// ----------------------------------------------------------------------------
+
+bool data_base::push_lock(const output& output, const output_point& point,
+    size_t height)
+{
+    if (!operation::is_pay_key_hash_with_sequence_lock_pattern(
+        output.script.operations))
+        return false;
+
+    const auto address = payment_address::extract(output.script);
+    if (!address)
+        return false;
+
+    const address_lock lock
+    {
+        point,
+        static_cast<uint32_t>(height),
+        output.get_lock_sequence(),
+        output.value,
+        output.is_etp(),
+        output.is_asset()
+    };
+
+    address_locks.store(address_key::from_address(address), lock);
+    return true;
+}
+
+bool data_base::spend_lock(const output& output, const output_point& point,
+    bool spent)
+{
+    if (!operation::is_pay_key_hash_with_sequence_lock_pattern(
+        output.script.operations))
+        return false;
+
+    const auto address = payment_address::extract(output.script);
+    return address &&
+        address_locks.spend(address_key::from_address(address), point, spent);
+}
+
+// Store every locked output of the chain, marking the spent ones, so that
+// the rows are as if pushed block by block.
+bool data_base::build_address_locks()
+{
+    const auto store = [this](const output& output,
+        const output_point& point, size_t height)
+    {
+        if (push_lock(output, point, height) && spends.get(point).valid)
+            spend_lock(output, point, true);
+    };
+
+    if (!scan_outputs("address lock", store))
+        return false;
+
+    synchronize_address_locks();
+    return true;
+}
+
 void data_base::push(const block& block)
 {
     // Height is unsafe unless database locked.
     push(block, get_next_height(blocks));
 }
 
+static metrics::histogram& write_timer(const std::string& table)
+{
+    return *metrics::instance().make_histogram("mvs_database_write_seconds",
+        "Time spent writing one block, per table group.",
+        "table=\"" + table + "\"");
+}
+
 void data_base::push(const block& block, uint64_t height)
 {
+    static auto& inputs_time = write_timer("inputs");
+    static auto& outputs_time = write_timer("outputs");
+    static auto& stealth_time = write_timer("stealth");
+    static auto& transactions_time = write_timer("transactions");
+    static auto& blocks_time = write_timer("blocks");
+    static auto& sync_time = write_timer("sync");
+
+    // Per table time is summed over the block and recorded once.
+    uint64_t inputs_elapsed = 0;
+    uint64_t outputs_elapsed = 0;
+    uint64_t stealth_elapsed = 0;
+    uint64_t transactions_elapsed = 0;
+    auto start = metrics::scoped_timer::clock::now();
+    const auto lap = [&start]()
+    {
+        const auto now = metrics::scoped_timer::clock::now();
+        const auto elapsed = std::chrono::duration_cast<
+            std::chrono::microseconds>(now - start).count();
+        start = now;
+        return static_cast<uint64_t>(elapsed);
+    };
+
     for (size_t index = 0; index < block.transactions.size(); ++index)
     {
         // Skip BIP30 allowed duplicates (coinbase txs of excepted blocks).
@@ -942,51 +1735,96 @@ void data_base::push(const block& block, uint64_t height)
         timestamp_ = block.header.timestamp; // for address_asset_database store_input/store_output used only
 
         // Add inputs
+        lap();
         if (!tx.is_coinbase())
+        {
+            push_spends(tx_hash, tx.inputs);
             push_inputs(tx_hash, height, tx.inputs);
+        }
+        inputs_elapsed += lap();
 
         // Add outputs
         push_outputs(tx_hash, height, tx.outputs);
+        outputs_elapsed += lap();
 
         // Add stealth outputs
         push_stealth(tx_hash, height, tx.outputs);
+        stealth_elapsed += lap();
 
         // Add transaction
         transactions.store(height, index, tx);
+        transactions_elapsed += lap();
     }
 
+    inputs_time.record(inputs_elapsed);
+    outputs_time.record(outputs_elapsed);
+    stealth_time.record(stealth_elapsed);
+    transactions_time.record(transactions_elapsed);
+
     // Add block itself.
+    lap();
     blocks.store(block, height);
+    blocks_time.record(lap());
 
     // Synchronise everything that was added.
     synchronize();
+    sync_time.record(lap());
+}
+
+void data_base::push_unindexed(const block& block, uint64_t height)
+{
+    if (height < index_height_)
+        set_index_height(height);
+
+    for (size_t index = 0; index < block.transactions.size(); ++index)
+    {
+        if (index == 0 && is_allowed_duplicate(block.header, height))
+            continue;
+
+        const auto& tx = block.transactions[index];
+        const auto tx_hash = tx.hash();
+
+        if (!tx.is_coinbase())
+            push_spends(tx_hash, tx.inputs);
+
+        transactions.store(height, index, tx);
+    }
+
+    blocks.store(block, height);
+}
+
+void data_base::push_spends(const hash_digest& tx_hash,
+    const input::list& inputs)
+{
+    for (uint32_t index = 0; index < inputs.size(); ++index)
+        spends.store(inputs[index].previous_output, { tx_hash, index });
 }
 
 void data_base::push_inputs(const hash_digest& tx_hash, size_t height,
     const input::list& inputs)
 {
+    if (height < history_height_)
+        return;
+
     for (uint32_t index = 0; index < inputs.size(); ++index)
     {
-        // We also push spends in the inputs loop.
         const auto& input = inputs[index];
         const chain::input_point point{ tx_hash, index };
-        spends.store(input.previous_output, point);
+        const auto& previous = input.previous_output;
 
-        if (height < history_height_)
-            continue;
+        // Whatever the input script, the spent output leaves the balance and
+        // the locks of its own address.
+        update_previous(previous, true);
 
         // Try to extract an address.
         const auto address = payment_address::extract(input.script);
         if (!address)
             continue;
 
-        const auto& previous = input.previous_output;
         history.add_input(address.hash(), point, height, previous);
 
         /* begin added for asset issue/transfer */
-        auto address_str = address.encoded();
-        data_chunk data(address_str.begin(), address_str.end());
-        short_hash key = ripemd160_hash(data);
+        const auto key = address_key::from_address(address);
         address_assets.store_input(key, point, height, previous, timestamp_);
         address_assets.sync();
         /* end added for asset issue/transfer */
@@ -1013,6 +1851,8 @@ void data_base::push_outputs(const hash_digest& tx_hash, size_t height,
         history.add_output(address.hash(), point, height, value);
 
         push_attachment(output.attach_data, address, point, height, value);
+        update_balance(output, true);
+        push_lock(output, point, height);
     }
 }
 
@@ -1086,23 +1926,37 @@ bool data_base::pop(chain::block& block)
             return false;
         }
 
-        // TODO: the deserialization should cache the hash on the tx.
-        // Deserialize the transaction and move it to the block.
+        // Deserialize the transaction, move it to the block and keep its hash.
         txs.emplace_back(tx_result.transaction());
+        txs.back().set_hash(tx_hash);
     }
 
+    // An unindexed block has only its spends to remove.
+    const auto indexed = height < index_height_;
+
     // Loop txs backwards, the reverse of how they are added.
     // Remove txs, then outputs, then inputs (also reverse order).
     for (auto tx = txs.rbegin(); tx != txs.rend(); ++tx)
     {
         transactions.remove(tx->hash());
-        pop_outputs(tx->outputs, height);
 
-        if (!tx->is_coinbase())
+        if (indexed)
+            pop_outputs(tx->outputs, height);
+
+        if (tx->is_coinbase())
+            continue;
+
+        if (indexed)
             pop_inputs(tx->inputs, height);
+        else
+            for (const auto& input: tx->inputs)
+                spends.remove(input.previous_output);
     }
 
-    // Stealth unlink is not implemented.
+    if (height == index_height_)
+        set_index_height(max_uint64);
+
+    // Truncates the stealth rows of the height, none if unindexed.
     stealth.unlink(height);
     blocks.unlink(height);
     blocks.remove(block.header.hash()); // wdy remove block from block hash table
@@ -1123,15 +1977,16 @@ void data_base::pop_inputs(const input::list& inputs, size_t height)
         if (height < history_height_)
             continue;
 
+        // The previous transaction is not yet popped, restore its output.
+        update_previous(input->previous_output, false);
+
         // Try to extract an address.
         const auto address = payment_address::extract(input->script);
 
         if (address) {
             history.delete_last_row(address.hash());
             // delete address asset record
-            auto address_str = address.encoded();
-            data_chunk data(address_str.begin(), address_str.end());
-            short_hash hash = ripemd160_hash(data);
+            const auto hash = address_key::from_address(address);
             address_assets.delete_last_row(hash);
         }
     }
@@ -1151,9 +2006,7 @@ void data_base::pop_outputs(const output::list& outputs, size_t height)
         if (address) {
             history.delete_last_row(address.hash());
             // delete address asset record
-            auto address_str = address.encoded();
-            data_chunk data(address_str.begin(), address_str.end());
-            short_hash hash = ripemd160_hash(data);
+            const auto hash = address_key::from_address(address);
             bc::chain::output op = *output;
             // NOTICE: pop only the pushed row, at present did and mit is
             // not stored in address_asset, but stored separately
@@ -1161,6 +2014,11 @@ void data_base::pop_outputs(const output::list& outputs, size_t height)
             if (!op.is_did() && !op.is_asset_mit()) {
                 address_assets.delete_last_row(hash);
             }
+            update_balance(op, false);
+            if (operation::is_pay_key_hash_with_sequence_lock_pattern(
+                op.script.operations)) {
+                address_locks.delete_last_row(hash);
+            }
             // remove asset or did from database
             if (op.is_asset_issue() || op.is_asset_secondaryissue()) {
                 auto symbol = op.get_asset_symbol();
@@ -1187,9 +2045,8 @@ void data_base::pop_outputs(const output::list& outputs, size_t height)
 
                     if(blockchain_did_)
                     {
-                        auto old_address = blockchain_did_->get_did().get_address();
-                        data_chunk data_old(old_address.begin(), old_address.end());
-                        short_hash old_hash = ripemd160_hash(data_old);
+                        const auto old_hash = address_key::from_string(
+                            blockchain_did_->get_did().get_address());
 
                         address_dids.delete_last_row(old_hash);
                         address_dids.delete_last_row(hash);
@@ -1235,6 +2092,126 @@ void data_base::pop_outputs(const output::list& outputs, size_t height)
     }
 }
 
+// Deferred indexes.
+// ----------------------------------------------------------------------------
+
+void data_base::set_index_height(uint64_t height)
+{
+    index_height_ = height;
+
+    if (height == max_uint64)
+    {
+        boost::filesystem::remove(index_height_path_);
+        return;
+    }
+
+    bc::ofstream file(index_height_path_.string(), std::ofstream::out);
+    file << height << std::flush;
+}
+
+bool data_base::unindexed_height(uint64_t& out_height) const
+{
+    out_height = index_height_;
+    return out_height != max_uint64;
+}
+
+// private, the block at height must be stored and its predecessors indexed.
+bool data_base::index_block(uint64_t height)
+{
+    const auto block_result = blocks.get(height);
+    if (!block_result)
+        return false;
+
+    const auto head = block_result.header();
+    const auto count = block_result.transaction_count();
+    timestamp_ = head.timestamp;
+
+    // As push, the transactions of the block are already stored.
+    for (size_t index = 0; index < count; ++index)
+    {
+        if (index == 0 && is_allowed_duplicate(head, height))
+            continue;
+
+        const auto tx_hash = block_result.transaction_hash(index);
+        const auto tx_result = transactions.get(tx_hash);
+        if (!tx_result)
+            return false;
+
+        const auto tx = tx_result.transaction();
+        if (!tx.is_coinbase())
+            push_inputs(tx_hash, height, tx.inputs);
+
+        push_outputs(tx_hash, height, tx.outputs);
+        push_stealth(tx_hash, height, tx.outputs);
+    }
+
+    return true;
+}
+
+bool data_base::index_next()
+{
+    const uint64_t height = index_height_;
+    if (height == max_uint64)
+        return true;
+
+    size_t top;
+    if (!blocks.top(top) || height > top)
+    {
+        set_index_height(max_uint64);
+        return true;
+    }
+
+    if (!index_block(height))
+        return false;
+
+    // Advance the mark only once the indexes it covers are synchronised.
+    synchronize();
+    set_index_height(height == top ? max_uint64 : height + 1);
+    return true;
+}
+
+bool data_base::build_indexes()
+{
+    const uint64_t start = index_height_;
+    if (start == max_uint64)
+        return true;
+
+    size_t top;
+    if (!blocks.top(top) || start > top)
+    {
+        set_index_height(max_uint64);
+        return true;
+    }
+
+    log::info(LOG_DATABASE)
+        << "Building indexes from height " << start << " to " << top
+        << ", this may take a while...";
+
+    for (auto height = start; height <= top; ++height)
+    {
+        if (!index_block(height))
+            return false;
+
+        // Persist progress only once the indexes it covers are synchronised.
+        if ((height + 1) % 10000 == 0)
+        {
+            synchronize();
+            set_index_height(height + 1);
+
+            log::info(LOG_DATABASE)
+                << "Building indexes, height " << height << " of " << top;
+        }
+    }
+
+    synchronize();
+    set_index_height(max_uint64);
+
+    log::info(LOG_DATABASE)
+        << "Building indexes is complete.";
+
+    return true;
+}
+
 /* begin store asset related info into database */
 #include <metaverse/bitcoin/config/base16.hpp>
 using namespace libbitcoin::config;
@@ -1242,11 +2219,8 @@ using namespace libbitcoin::config;
 void data_base::push_attachment(const attachment& attach, const payment_address& address,
     const output_point& outpoint, uint32_t output_height, uint64_t value)
 {
-    auto address_str = address.encoded();
-    log::trace(LOG_DATABASE) << "push_attachment address_str=" << address_str;
     log::trace(LOG_DATABASE) << "push_attachment address hash=" << base16(address.hash());
-    data_chunk data(address_str.begin(), address_str.end());
-    short_hash hash = ripemd160_hash(data);
+    const auto hash = address_key::from_address(address);
     auto visitor = attachment_visitor(this, hash, outpoint, output_height, value,
         attach.get_from_did(), attach.get_to_did());
     boost::apply_visitor(visitor, const_cast<attachment&>(attach).get_attach());
@@ -26,6 +26,7 @@
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/bitcoin/chain/output_point.hpp>
+#include <metaverse/database/address_key.hpp>
 #include <metaverse/database/memory/memory.hpp>
 #include <metaverse/database/primitives/record_multimap_iterable.hpp>
 #include <metaverse/database/primitives/record_multimap_iterator.hpp>
@@ -213,8 +214,7 @@ std::shared_ptr<business_record::list> address_asset_database::get(
     const std::string& address, const std::string& symbol,
     size_t start_height, size_t end_height, uint64_t limit, uint64_t page_number) const
 {
-    data_chunk addr_data(address.begin(), address.end());
-    auto key = ripemd160_hash(addr_data);
+    const auto key = address_key::from_string(address);
 
     // Read the height value from the row.
     const auto read_height = [](uint8_t* data)
@@ -315,8 +315,7 @@ std::shared_ptr<business_record::list> address_asset_database::get(
 std::shared_ptr<business_record::list> address_asset_database::get(const std::string& address, size_t start_height,
     size_t end_height) const
 {
-    data_chunk addr_data(address.begin(), address.end());
-    auto key = ripemd160_hash(addr_data);
+    const auto key = address_key::from_string(address);
 
     // Read the height value from the row.
     const auto read_height = [](uint8_t* data)
@@ -531,8 +530,7 @@ business_history::list address_asset_database::get_business_history(const short_
 std::shared_ptr<business_history::list> address_asset_database::get_address_business_history(
     const std::string& address, size_t from_height) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     auto unspent = std::make_shared<business_history::list>();
 
@@ -560,8 +558,7 @@ std::shared_ptr<business_history::list> address_asset_database::get_address_busi
 business_history::list address_asset_database::get_business_history(const std::string& address,
     size_t from_height, business_kind kind, uint8_t status) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     business_history::list unspent;
 
@@ -598,8 +595,7 @@ business_history::list address_asset_database::get_business_history(const std::s
 business_history::list address_asset_database::get_business_history(const std::string& address,
     size_t from_height, business_kind kind, uint32_t time_begin, uint32_t time_end) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     business_history::list unspent;
 
@@ -644,8 +640,7 @@ business_address_asset::list address_asset_database::get_assets(const std::strin
 business_address_asset::list address_asset_database::get_assets(const std::string& address,
     size_t from_height, business_kind kind) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     business_address_asset::list unspent;
 
@@ -703,8 +698,7 @@ business_address_asset::list address_asset_database::get_assets(const std::strin
 business_address_message::list address_asset_database::get_messages(const std::string& address,
     size_t from_height) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     business_address_message::list unspent;
     for (const auto& row: result)
@@ -735,8 +729,7 @@ business_address_message::list address_asset_database::get_messages(const std::s
 business_address_asset_cert::list address_asset_database::get_asset_certs(const std::string& address,
     const std::string& symbol, asset_cert_type cert_type, size_t from_height) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     business_address_asset_cert::list unspent;
     for (const auto& row: result)
@@ -784,8 +777,7 @@ business_history::list address_asset_database::get_asset_certs_history(const std
         const std::string& symbol, asset_cert_type cert_type,
         size_t from_height) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     business_history::list unspent(result.size());
 
@@ -814,6 +806,11 @@ business_history::list address_asset_database::get_asset_certs_history(const std
 }
 
 
+bool address_asset_database::rekey(const short_hash& from, const short_hash& to)
+{
+    return rows_multimap_.rekey(from, to);
+}
+
 void address_asset_database::sync()
 {
     lookup_manager_.sync();
@@ -0,0 +1,298 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/databases/address_balance_database.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/chain/attachment/asset/asset_detail.hpp>
+#include <metaverse/database/memory/memory.hpp>
+#include <metaverse/database/primitives/record_multimap_iterable.hpp>
+#include <metaverse/database/primitives/record_multimap_iterator.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace boost::filesystem;
+using namespace bc::chain;
+
+BC_CONSTEXPR size_t number_buckets = 999983;
+BC_CONSTEXPR size_t header_size = record_hash_table_header_size(number_buckets);
+BC_CONSTEXPR size_t initial_lookup_file_size = header_size + minimum_records_size;
+
+BC_CONSTEXPR size_t record_size = hash_table_multimap_record_size<short_hash>();
+
+BC_CONSTEXPR size_t symbol_size = ASSET_DETAIL_SYMBOL_FIX_SIZE;
+BC_CONSTEXPR size_t quantity_position = symbol_size;
+BC_CONSTEXPR size_t encumbered_position = quantity_position + 8;
+BC_CONSTEXPR size_t count_position = encumbered_position + 8;
+BC_CONSTEXPR size_t outputs_position = count_position + 4;
+BC_CONSTEXPR size_t value_size = outputs_position + 4;
+BC_CONSTEXPR size_t row_record_size = hash_table_record_size<hash_digest>(value_size);
+
+address_balance_database::address_balance_database(const path& lookup_filename,
+    const path& rows_filename, std::shared_ptr<shared_mutex> mutex)
+  : lookup_file_(lookup_filename, mutex),
+    lookup_header_(lookup_file_, number_buckets),
+    lookup_manager_(lookup_file_, header_size, record_size),
+    lookup_map_(lookup_header_, lookup_manager_),
+    rows_file_(rows_filename, mutex),
+    rows_manager_(rows_file_, 0, row_record_size),
+    rows_list_(rows_manager_),
+    rows_multimap_(lookup_map_, rows_list_)
+{
+}
+
+// Close does not call stop because there is no way to detect thread join.
+address_balance_database::~address_balance_database()
+{
+    close();
+}
+
+// Create.
+// ----------------------------------------------------------------------------
+
+// Initialize files and start.
+bool address_balance_database::create()
+{
+    // Resize and create require a started file.
+    if (!lookup_file_.start() ||
+        !rows_file_.start())
+        return false;
+
+    // These will throw if insufficient disk space.
+    lookup_file_.resize(initial_lookup_file_size);
+    rows_file_.resize(minimum_records_size);
+
+    if (!lookup_header_.create() ||
+        !lookup_manager_.create() ||
+        !rows_manager_.create())
+        return false;
+
+    // Should not call start after create, already started.
+    return
+        lookup_header_.start() &&
+        lookup_manager_.start() &&
+        rows_manager_.start();
+}
+
+// Startup and shutdown.
+// ----------------------------------------------------------------------------
+
+bool address_balance_database::start()
+{
+    return
+        lookup_file_.start() &&
+        rows_file_.start() &&
+        lookup_header_.start() &&
+        lookup_manager_.start() &&
+        rows_manager_.start();
+}
+
+bool address_balance_database::stop()
+{
+    return
+        lookup_file_.stop() &&
+        rows_file_.stop();
+}
+
+bool address_balance_database::close()
+{
+    return
+        lookup_file_.close() &&
+        rows_file_.close();
+}
+
+// ----------------------------------------------------------------------------
+
+static bool symbol_equal(const uint8_t* data, const std::string& symbol)
+{
+    const auto size = std::min(symbol.size(), symbol_size);
+    return std::memcmp(data, symbol.data(), size) == 0
+        && (size == symbol_size || data[size] == 0);
+}
+
+static address_balance read_balance(const uint8_t* data)
+{
+    auto deserial = make_deserializer_unsafe(data);
+    address_balance balance;
+    balance.symbol = deserial.read_fixed_string(symbol_size);
+    balance.quantity = deserial.read_8_bytes_little_endian();
+    balance.encumbered_quantity = deserial.read_8_bytes_little_endian();
+    balance.encumbered_count = deserial.read_4_bytes_little_endian();
+    balance.output_count = deserial.read_4_bytes_little_endian();
+    return balance;
+}
+
+// private
+memory_ptr address_balance_database::find(const short_hash& key,
+    const std::string& symbol) const
+{
+    const auto start = rows_multimap_.lookup(key);
+    const auto records = record_multimap_iterable(rows_list_, start);
+
+    for (const auto index: records)
+    {
+        // This obtains a remap safe address pointer against the rows file.
+        const auto record = rows_list_.get(index);
+        if (symbol_equal(REMAP_ADDRESS(record), symbol))
+            return record;
+    }
+
+    return nullptr;
+}
+
+// private
+void address_balance_database::update(const short_hash& key,
+    const std::string& symbol, uint64_t quantity, bool encumbered,
+    bool credit)
+{
+    const auto record = find(key, symbol);
+
+    if (!record)
+    {
+        // Every debited output was credited under its own key, so this is an
+        // inconsistent table, not a symbol never held.
+        if (!credit)
+        {
+            log::warning(LOG_DATABASE)
+                << "Debit of " << symbol << " without a balance for ["
+                << encode_base16(key) << "]";
+            return;
+        }
+
+        const auto write = [&](memory_ptr data)
+        {
+            auto serial = make_serializer(REMAP_ADDRESS(data));
+            serial.write_fixed_string(symbol, symbol_size);
+            serial.write_8_bytes_little_endian(quantity);
+            serial.write_8_bytes_little_endian(encumbered ? quantity : 0);
+            serial.write_4_bytes_little_endian(encumbered ? 1 : 0);
+            serial.write_4_bytes_little_endian(1);
+        };
+        rows_multimap_.add_row(key, write);
+        return;
+    }
+
+    const auto address = REMAP_ADDRESS(record);
+    auto balance = read_balance(address);
+
+    const auto apply = [credit](uint64_t value, uint64_t delta)
+    {
+        return credit ? value + delta : value - std::min(value, delta);
+    };
+
+    balance.quantity = apply(balance.quantity, quantity);
+    balance.output_count = static_cast<uint32_t>(
+        apply(balance.output_count, 1));
+
+    if (encumbered)
+    {
+        balance.encumbered_quantity = apply(balance.encumbered_quantity,
+            quantity);
+        balance.encumbered_count = static_cast<uint32_t>(
+            apply(balance.encumbered_count, 1));
+    }
+
+    // The symbol is unchanged, rewrite only the amounts.
+    auto serial = make_serializer(address + quantity_position);
+    serial.write_8_bytes_little_endian(balance.quantity);
+    serial.write_8_bytes_little_endian(balance.encumbered_quantity);
+    serial.write_4_bytes_little_endian(balance.encumbered_count);
+    serial.write_4_bytes_little_endian(balance.output_count);
+}
+
+void address_balance_database::credit(const short_hash& key,
+    const std::string& symbol, uint64_t quantity, bool encumbered)
+{
+    update(key, symbol, quantity, encumbered, true);
+}
+
+void address_balance_database::debit(const short_hash& key,
+    const std::string& symbol, uint64_t quantity, bool encumbered)
+{
+    update(key, symbol, quantity, encumbered, false);
+}
+
+bool address_balance_database::contains(const short_hash& key) const
+{
+    return rows_multimap_.lookup(key) != record_list::empty;
+}
+
+address_balance::list address_balance_database::get(
+    const short_hash& key) const
+{
+    address_balance::list result;
+    const auto start = rows_multimap_.lookup(key);
+    const auto records = record_multimap_iterable(rows_list_, start);
+
+    for (const auto index: records)
+    {
+        // This obtains a remap safe address pointer against the rows file.
+        const auto record = rows_list_.get(index);
+        auto balance = read_balance(REMAP_ADDRESS(record));
+
+        // Skip symbols no longer held, an unspent output of zero quantity
+        // still holds its symbol.
+        if (balance.output_count != 0)
+            result.emplace_back(std::move(balance));
+    }
+
+    return result;
+}
+
+address_balance address_balance_database::get(const short_hash& key,
+    const std::string& symbol) const
+{
+    const auto record = find(key, symbol);
+    if (!record)
+        return{ symbol, 0, 0, 0, 0 };
+
+    return read_balance(REMAP_ADDRESS(record));
+}
+
+bool address_balance_database::rekey(const short_hash& from, const short_hash& to)
+{
+    return rows_multimap_.rekey(from, to);
+}
+
+void address_balance_database::sync()
+{
+    lookup_manager_.sync();
+    rows_manager_.sync();
+}
+
+address_balance_statinfo address_balance_database::statinfo() const
+{
+    return
+    {
+        lookup_header_.size(),
+        lookup_manager_.count(),
+        rows_manager_.count()
+    };
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -25,6 +25,7 @@
 #include <memory>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/database/address_key.hpp>
 #include <metaverse/database/memory/memory.hpp>
 #include <metaverse/database/primitives/record_multimap_iterable.hpp>
 #include <metaverse/database/primitives/record_multimap_iterator.hpp>
@@ -214,8 +215,7 @@ business_record::list address_did_database::get(const short_hash& key,
 std::shared_ptr<std::vector<business_record>> address_did_database::get(const std::string& address, const std::string& symbol,
     size_t start_height, size_t end_height, uint64_t limit, uint64_t page_number) const
 {
-    data_chunk addr_data(address.begin(), address.end());
-    auto key = ripemd160_hash(addr_data);
+    const auto key = address_key::from_string(address);
 
     // Read the height value from the row.
     const auto read_height = [](uint8_t* data)
@@ -308,8 +308,7 @@ std::shared_ptr<std::vector<business_record>> address_did_database::get(const st
 std::shared_ptr<std::vector<business_record>> address_did_database::get(const std::string& address, size_t start_height,
     size_t end_height) const
 {
-    data_chunk addr_data(address.begin(), address.end());
-    auto key = ripemd160_hash(addr_data);
+    const auto key = address_key::from_string(address);
 
     // Read the height value from the row.
     const auto read_height = [](uint8_t* data)
@@ -526,8 +525,7 @@ business_history::list address_did_database::get_business_history(const short_ha
 std::shared_ptr<std::vector<business_history>> address_did_database::get_address_business_history(const std::string& address,
     size_t from_height) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     auto unspent = std::make_shared<std::vector<business_history>>();
 
@@ -556,8 +554,7 @@ std::shared_ptr<std::vector<business_history>> address_did_database::get_address
 business_history::list address_did_database::get_business_history(const std::string& address,
     size_t from_height, business_kind kind, uint8_t status) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     business_history::list unspent;
     // did type check
@@ -592,8 +589,7 @@ business_history::list address_did_database::get_business_history(const std::str
 business_history::list address_did_database::get_business_history(const std::string& address,
     size_t from_height, business_kind kind, uint32_t time_begin, uint32_t time_end) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     business_history::list unspent;
     // did type check
@@ -629,8 +625,7 @@ business_history::list address_did_database::get_business_history(const std::str
 business_address_did::list address_did_database::get_dids(const std::string& address,
     size_t from_height, business_kind kind) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     business_address_did::list unspent;
     // did type check
@@ -675,8 +670,7 @@ business_address_did::list address_did_database::get_dids(const std::string& add
 business_address_did::list address_did_database::get_dids(const std::string& address,
     size_t from_height, size_t to_height) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     business_address_did::list unspent;
     for (const auto& row: result)
@@ -723,8 +717,7 @@ business_address_did::list address_did_database::get_dids(const std::string& add
 business_address_message::list address_did_database::get_messages(const std::string& address,
     size_t from_height) const
 {
-    data_chunk data(address.begin(), address.end());
-    auto key = ripemd160_hash(data);
+    const auto key = address_key::from_string(address);
     business_history::list result = get_business_history(key, from_height);
     business_address_message::list unspent;
     for (const auto& row: result)
@@ -751,6 +744,11 @@ business_address_message::list address_did_database::get_messages(const std::str
     return unspent;
 
 }
+bool address_did_database::rekey(const short_hash& from, const short_hash& to)
+{
+    return rows_multimap_.rekey(from, to);
+}
+
 void address_did_database::sync()
 {
     lookup_manager_.sync();
@@ -0,0 +1,246 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/databases/address_lock_database.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory.hpp>
+#include <metaverse/database/primitives/record_multimap_iterable.hpp>
+#include <metaverse/database/primitives/record_multimap_iterator.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace boost::filesystem;
+using namespace bc::chain;
+
+BC_CONSTEXPR size_t number_buckets = 99991;
+BC_CONSTEXPR size_t header_size = record_hash_table_header_size(number_buckets);
+BC_CONSTEXPR size_t initial_lookup_file_size = header_size + minimum_records_size;
+
+BC_CONSTEXPR size_t record_size = hash_table_multimap_record_size<short_hash>();
+
+// point (36), height (4), sequence (4), value (8), flags (1), spent (1).
+BC_CONSTEXPR size_t spent_position = 36 + 4 + 4 + 8 + 1;
+BC_CONSTEXPR size_t value_size = spent_position + 1;
+BC_CONSTEXPR size_t row_record_size = hash_table_record_size<hash_digest>(value_size);
+
+BC_CONSTEXPR uint8_t etp_flag = 1;
+BC_CONSTEXPR uint8_t asset_flag = 2;
+
+uint64_t address_lock::expiration() const
+{
+    return static_cast<uint64_t>(height) +
+        get_relative_locktime_locked_heights(sequence);
+}
+
+bool address_lock::is_locked(uint64_t top_height) const
+{
+    return expiration() > top_height;
+}
+
+address_lock_database::address_lock_database(const path& lookup_filename,
+    const path& rows_filename, std::shared_ptr<shared_mutex> mutex)
+  : lookup_file_(lookup_filename, mutex),
+    lookup_header_(lookup_file_, number_buckets),
+    lookup_manager_(lookup_file_, header_size, record_size),
+    lookup_map_(lookup_header_, lookup_manager_),
+    rows_file_(rows_filename, mutex),
+    rows_manager_(rows_file_, 0, row_record_size),
+    rows_list_(rows_manager_),
+    rows_multimap_(lookup_map_, rows_list_)
+{
+}
+
+// Close does not call stop because there is no way to detect thread join.
+address_lock_database::~address_lock_database()
+{
+    close();
+}
+
+// Create.
+// ----------------------------------------------------------------------------
+
+// Initialize files and start.
+bool address_lock_database::create()
+{
+    // Resize and create require a started file.
+    if (!lookup_file_.start() ||
+        !rows_file_.start())
+        return false;
+
+    // These will throw if insufficient disk space.
+    lookup_file_.resize(initial_lookup_file_size);
+    rows_file_.resize(minimum_records_size);
+
+    if (!lookup_header_.create() ||
+        !lookup_manager_.create() ||
+        !rows_manager_.create())
+        return false;
+
+    // Should not call start after create, already started.
+    return
+        lookup_header_.start() &&
+        lookup_manager_.start() &&
+        rows_manager_.start();
+}
+
+// Startup and shutdown.
+// ----------------------------------------------------------------------------
+
+bool address_lock_database::start()
+{
+    return
+        lookup_file_.start() &&
+        rows_file_.start() &&
+        lookup_header_.start() &&
+        lookup_manager_.start() &&
+        rows_manager_.start();
+}
+
+bool address_lock_database::stop()
+{
+    return
+        lookup_file_.stop() &&
+        rows_file_.stop();
+}
+
+bool address_lock_database::close()
+{
+    return
+        lookup_file_.close() &&
+        rows_file_.close();
+}
+
+// ----------------------------------------------------------------------------
+
+void address_lock_database::store(const short_hash& key,
+    const address_lock& lock)
+{
+    auto write = [&](memory_ptr data)
+    {
+        auto serial = make_serializer(REMAP_ADDRESS(data));
+        serial.write_data(lock.point.to_data());
+        serial.write_4_bytes_little_endian(lock.height);
+        serial.write_4_bytes_little_endian(lock.sequence);
+        serial.write_8_bytes_little_endian(lock.value);
+        serial.write_byte((lock.is_etp ? etp_flag : 0) |
+            (lock.is_asset ? asset_flag : 0));
+        serial.write_byte(0);
+    };
+    rows_multimap_.add_row(key, write);
+}
+
+bool address_lock_database::spend(const short_hash& key,
+    const output_point& point, bool spent)
+{
+    const auto start = rows_multimap_.lookup(key);
+    const auto records = record_multimap_iterable(rows_list_, start);
+
+    for (const auto index: records)
+    {
+        // This obtains a remap safe address pointer against the rows file.
+        const auto record = rows_list_.get(index);
+        const auto address = REMAP_ADDRESS(record);
+        auto deserial = make_deserializer_unsafe(address);
+        if (point::factory_from_data(deserial) != point)
+            continue;
+
+        address[spent_position] = spent ? 1 : 0;
+        return true;
+    }
+
+    return false;
+}
+
+void address_lock_database::delete_last_row(const short_hash& key)
+{
+    rows_multimap_.delete_last_row(key);
+}
+
+bool address_lock_database::contains(const short_hash& key) const
+{
+    return rows_multimap_.lookup(key) != record_list::empty;
+}
+
+address_lock::list address_lock_database::get(const short_hash& key) const
+{
+    address_lock::list result;
+    const auto start = rows_multimap_.lookup(key);
+    const auto records = record_multimap_iterable(rows_list_, start);
+
+    for (const auto index: records)
+    {
+        // This obtains a remap safe address pointer against the rows file.
+        const auto record = rows_list_.get(index);
+        const auto address = REMAP_ADDRESS(record);
+        if (address[spent_position] != 0)
+            continue;
+
+        auto deserial = make_deserializer_unsafe(address);
+        address_lock lock;
+        lock.point = point::factory_from_data(deserial);
+        lock.height = deserial.read_4_bytes_little_endian();
+        lock.sequence = deserial.read_4_bytes_little_endian();
+        lock.value = deserial.read_8_bytes_little_endian();
+        const auto flags = deserial.read_byte();
+        lock.is_etp = (flags & etp_flag) != 0;
+        lock.is_asset = (flags & asset_flag) != 0;
+        result.push_back(std::move(lock));
+    }
+
+    const auto earlier = [](const address_lock& left,
+        const address_lock& right)
+    {
+        return left.expiration() < right.expiration();
+    };
+
+    std::stable_sort(result.begin(), result.end(), earlier);
+    return result;
+}
+
+bool address_lock_database::rekey(const short_hash& from, const short_hash& to)
+{
+    return rows_multimap_.rekey(from, to);
+}
+
+void address_lock_database::sync()
+{
+    lookup_manager_.sync();
+    rows_manager_.sync();
+}
+
+address_lock_statinfo address_lock_database::statinfo() const
+{
+    return
+    {
+        lookup_header_.size(),
+        lookup_manager_.count(),
+        rows_manager_.count()
+    };
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -60,6 +60,8 @@ block_database::block_database(const path& map_filename,
     index_file_(index_filename, mutex),
     index_manager_(index_file_, 0, sizeof(file_offset))
 {
+    lookup_file_.set_access(memory_map::access_pattern::random, header_size);
+    index_file_.set_access(memory_map::access_pattern::sequential);
 }
 
 // Close does not call stop because there is no way to detect thread join.
@@ -211,6 +213,16 @@ void block_database::sync()
     index_manager_.sync();
 }
 
+size_t block_database::warm_up()
+{
+    return lookup_file_.warm_up();
+}
+
+memory_map::residency::list block_database::residency() const
+{
+    return { lookup_file_.get_residency(), index_file_.get_residency() };
+}
+
 // This is necessary for parallel import, as gaps are created.
 void block_database::zeroize(array_index first, array_index count)
 {
@@ -55,6 +55,8 @@ history_database::history_database(const path& lookup_filename,
     rows_list_(rows_manager_),
     rows_multimap_(lookup_map_, rows_list_)
 {
+    lookup_file_.set_access(memory_map::access_pattern::random, header_size);
+    rows_file_.set_access(memory_map::access_pattern::normal);
 }
 
 // Close does not call stop because there is no way to detect thread join.
@@ -213,6 +215,16 @@ void history_database::sync()
     rows_manager_.sync();
 }
 
+size_t history_database::warm_up()
+{
+    return lookup_file_.warm_up();
+}
+
+memory_map::residency::list history_database::residency() const
+{
+    return { lookup_file_.get_residency(), rows_file_.get_residency() };
+}
+
 history_statinfo history_database::statinfo() const
 {
     return
@@ -48,6 +48,7 @@ spend_database::spend_database(const path& filename,
     lookup_manager_(lookup_file_, header_size, record_size),
     lookup_map_(lookup_header_, lookup_manager_)
 {
+    lookup_file_.set_access(memory_map::access_pattern::random, header_size);
 }
 
 // Close does not call stop because there is no way to detect thread join.
@@ -143,6 +144,16 @@ void spend_database::sync()
     lookup_manager_.sync();
 }
 
+size_t spend_database::warm_up()
+{
+    return lookup_file_.warm_up();
+}
+
+memory_map::residency::list spend_database::residency() const
+{
+    return { lookup_file_.get_residency() };
+}
+
 spend_statinfo spend_database::statinfo() const
 {
     return
@@ -20,13 +20,22 @@
  */
 #include <metaverse/database/databases/stealth_database.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <tuple>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/memory/memory.hpp>
 
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif
+
 namespace libbitcoin {
 namespace database {
 
@@ -36,16 +45,96 @@ using namespace bc::chain;
 constexpr size_t height_size = sizeof(uint32_t);
 constexpr size_t prefix_size = sizeof(uint32_t);
 
+// [ prefix_bitfield:4 ]
+constexpr size_t prefix_row_size = prefix_size;
+
 // ephemkey is without sign byte and address is without version byte.
-// [ prefix_bitfield:4 ][ height:32 ][ ephemkey:32 ][ address:20 ][ tx_id:32 ]
-constexpr size_t row_size = prefix_size + height_size + hash_size +
+// [ height:4 ][ ephemkey:32 ][ address:20 ][ tx_id:32 ]
+constexpr size_t payload_row_size = height_size + hash_size +
     short_hash_size + hash_size;
 
-stealth_database::stealth_database(const path& rows_filename,
-    std::shared_ptr<shared_mutex> mutex)
-  : rows_file_(rows_filename, mutex),
-    rows_manager_(rows_file_, 0, row_size)
+// The previous form, both columns in one row.
+// [ prefix_bitfield:4 ][ height:4 ][ ephemkey:32 ][ address:20 ][ tx_id:32 ]
+constexpr size_t legacy_row_size = prefix_size + payload_row_size;
+
+// The filter is compared to the little endian prefix bytes, most significant
+// bit first, so it is a mask and value over the prefix as stored. Returns
+// false if the filter is longer than the prefix and cannot match any.
+static bool to_prefix_mask(uint32_t& out_mask, uint32_t& out_value,
+    const binary& filter)
 {
+    constexpr size_t bits_per_byte = 8;
+    std::array<uint8_t, prefix_size> mask{ { 0 } };
+    std::array<uint8_t, prefix_size> value{ { 0 } };
+
+    for (binary::size_type bit = 0; bit < filter.size(); ++bit)
+    {
+        // A prefix is padded with zeros beyond its 32 bits.
+        if (bit >= prefix_size * bits_per_byte)
+        {
+            if (filter[bit])
+                return false;
+
+            continue;
+        }
+
+        const uint8_t flag = 0x80 >> (bit % bits_per_byte);
+        mask[bit / bits_per_byte] |= flag;
+
+        if (filter[bit])
+            value[bit / bits_per_byte] |= flag;
+    }
+
+    std::memcpy(&out_mask, mask.data(), prefix_size);
+    std::memcpy(&out_value, value.data(), prefix_size);
+    return true;
+}
+
+// Collect the offsets of the prefixes of the column that match the value
+// under the mask, comparing four at a time where SSE2 is available.
+static void match_prefixes(std::vector<array_index>& out,
+    const uint8_t* column, array_index count, uint32_t mask, uint32_t value)
+{
+    array_index index = 0;
+
+#ifdef __SSE2__
+    const auto masks = _mm_set1_epi32(static_cast<int>(mask));
+    const auto values = _mm_set1_epi32(static_cast<int>(value));
+
+    for (; index + 4 <= count; index += 4)
+    {
+        const auto prefixes = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(column + index * prefix_size));
+        const auto matched = _mm_cmpeq_epi32(_mm_and_si128(prefixes, masks),
+            values);
+        const auto lanes = _mm_movemask_ps(_mm_castsi128_ps(matched));
+
+        for (array_index lane = 0; lanes != 0 && lane < 4; ++lane)
+            if ((lanes & (1 << lane)) != 0)
+                out.push_back(index + lane);
+    }
+#endif
+
+    for (; index < count; ++index)
+    {
+        uint32_t prefix;
+        std::memcpy(&prefix, column + index * prefix_size, prefix_size);
+
+        if ((prefix & mask) == value)
+            out.push_back(index);
+    }
+}
+
+stealth_database::stealth_database(const path& prefixes_filename,
+    const path& payloads_filename, std::shared_ptr<shared_mutex> mutex)
+  : prefixes_file_(prefixes_filename, mutex),
+    prefixes_manager_(prefixes_file_, 0, prefix_row_size),
+    payloads_file_(payloads_filename, mutex),
+    payloads_manager_(payloads_file_, 0, payload_row_size)
+{
+    // Scans read the prefix column through, payloads are only read on match.
+    prefixes_file_.set_access(memory_map::access_pattern::sequential);
+    payloads_file_.set_access(memory_map::access_pattern::random);
 }
 
 // Close does not call stop because there is no way to detect thread join.
@@ -61,17 +150,22 @@ stealth_database::~stealth_database()
 bool stealth_database::create()
 {
     // Resize and create require a started file.
-    if (!rows_file_.start())
+    if (!prefixes_file_.start() ||
+        !payloads_file_.start())
         return false;
 
     // This will throw if insufficient disk space.
-    rows_file_.resize(minimum_records_size);
+    prefixes_file_.resize(minimum_records_size);
+    payloads_file_.resize(minimum_records_size);
 
-    if (!rows_manager_.create())
+    if (!prefixes_manager_.create() ||
+        !payloads_manager_.create())
         return false;
 
     // Should not call start after create, already started.
-    return rows_manager_.start();
+    return
+        prefixes_manager_.start() &&
+        payloads_manager_.start();
 }
 
 // Startup and shutdown.
@@ -79,48 +173,99 @@ bool stealth_database::create()
 
 bool stealth_database::start()
 {
-    return
-        rows_file_.start() &&
-        rows_manager_.start();
+    if (!prefixes_file_.start() ||
+        !payloads_file_.start() ||
+        !prefixes_manager_.start() ||
+        !payloads_manager_.start())
+        return false;
+
+    // A row is written to both columns before either count is synchronized,
+    // but drop any row that is only in one of them.
+    const auto rows = count();
+    prefixes_manager_.set_count(rows);
+    payloads_manager_.set_count(rows);
+    return true;
 }
 
 bool stealth_database::stop()
 {
-    return rows_file_.stop();
+    const auto prefixes_stop = prefixes_file_.stop();
+    const auto payloads_stop = payloads_file_.stop();
+    return prefixes_stop && payloads_stop;
 }
 
 bool stealth_database::close()
 {
-    return rows_file_.close();
+    const auto prefixes_close = prefixes_file_.close();
+    const auto payloads_close = payloads_file_.close();
+    return prefixes_close && payloads_close;
 }
 
 // ----------------------------------------------------------------------------
 
+array_index stealth_database::count() const
+{
+    return std::min(prefixes_manager_.count(), payloads_manager_.count());
+}
+
+// The first row at or above the height, count if none.
+array_index stealth_database::first_row(size_t from_height,
+    array_index count) const
+{
+    array_index low = 0;
+    array_index high = count;
+
+    while (low < high)
+    {
+        const auto middle = low + (high - low) / 2;
+        const auto memory = payloads_manager_.get(middle);
+        const auto height = from_little_endian_unsafe<uint32_t>(
+            REMAP_ADDRESS(memory));
+
+        if (height < from_height)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
 // The prefix is fixed at 32 bits, but the filter is 0-32 bits, so the records
-// cannot be indexed using a hash table. We also do not index by height.
+// cannot be indexed using a hash table. Instead the prefix column of the rows
+// from the height on is compared in one pass.
 stealth_compact::list stealth_database::scan(const binary& filter,
     size_t from_height) const
 {
     stealth_compact::list result;
 
-    for (array_index row = 0; row < rows_manager_.count(); ++row)
+    uint32_t mask;
+    uint32_t value;
+    if (!to_prefix_mask(mask, value, filter))
+        return result;
+
+    const auto rows = count();
+    const auto first = first_row(from_height, rows);
+    if (first == rows)
+        return result;
+
+    std::vector<array_index> matches;
+
     {
-        const auto memory = rows_manager_.get(row);
-        auto record = REMAP_ADDRESS(memory);
+        // Rows are contiguous, the column is read through one pointer.
+        const auto memory = prefixes_manager_.get(first);
+        match_prefixes(matches, REMAP_ADDRESS(memory), rows - first, mask,
+            value);
+    }
 
-        // Skip if prefix doesn't match.
-        const auto field = from_little_endian_unsafe<uint32_t>(record);
-        if (!filter.is_prefix_of(field))
-            continue;
+    result.reserve(matches.size());
 
-        // Skip if height is too low.
-        record += prefix_size;
-        const auto height = from_little_endian_unsafe<uint32_t>(record);
-        if (height < from_height)
-            continue;
+    for (const auto match: matches)
+    {
+        const auto memory = payloads_manager_.get(first + match);
+        auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory) +
+            height_size);
 
-        // Add row to results.
-        auto deserial = make_deserializer_unsafe(record + height_size);
         result.push_back(
         {
             deserial.read_hash(),
@@ -129,23 +274,27 @@ stealth_compact::list stealth_database::scan(const binary& filter,
         });
     }
 
-    // TODO: we could sort result here.
     return result;
 }
 
 void stealth_database::store(uint32_t prefix, uint32_t height,
     const stealth_compact& row)
 {
-    // Allocate new row.
-    const auto index = rows_manager_.new_records(1);
-    const auto memory = rows_manager_.get(index);
-    const auto data = REMAP_ADDRESS(memory);
+    BITCOIN_ASSERT(count() == 0 || from_little_endian_unsafe<uint32_t>(
+        REMAP_ADDRESS(payloads_manager_.get(count() - 1))) <= height);
 
-    // Write data.
-    auto serial = make_serializer(data);
+    {
+        // Allocate and write the prefix.
+        const auto index = prefixes_manager_.new_records(1);
+        const auto memory = prefixes_manager_.get(index);
+        auto serial = make_serializer(REMAP_ADDRESS(memory));
+        serial.write_4_bytes_little_endian(prefix);
+    }
 
-    // Dual key.
-    serial.write_4_bytes_little_endian(prefix);
+    // Allocate and write the payload.
+    const auto index = payloads_manager_.new_records(1);
+    const auto memory = payloads_manager_.get(index);
+    auto serial = make_serializer(REMAP_ADDRESS(memory));
     serial.write_4_bytes_little_endian(height);
 
     // Stealth data.
@@ -154,14 +303,74 @@ void stealth_database::store(uint32_t prefix, uint32_t height,
     serial.write_hash(row.transaction_hash);
 }
 
-void stealth_database::unlink(size_t /* from_height */)
+void stealth_database::unlink(size_t from_height)
+{
+    // Truncate both columns at the partition of the height.
+    const auto first = first_row(from_height, count());
+    prefixes_manager_.set_count(first);
+    payloads_manager_.set_count(first);
+}
+
+bool stealth_database::import(const path& rows_filename,
+    confirm_function confirmed)
 {
-    // TODO: scan by height and mark as deleted.
+    typedef std::tuple<uint32_t, hash_digest, hash_digest, short_hash,
+        uint32_t> legacy_row;
+
+    std::vector<legacy_row> rows;
+
+    {
+        memory_map file(rows_filename);
+        record_manager manager(file, 0, legacy_row_size);
+
+        if (!file.start() || !manager.start())
+            return false;
+
+        for (array_index row = 0; row < manager.count(); ++row)
+        {
+            const auto memory = manager.get(row);
+            auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(memory));
+            const auto prefix = deserial.read_4_bytes_little_endian();
+            const auto height = deserial.read_4_bytes_little_endian();
+            const auto ephemeral_key = deserial.read_hash();
+            const auto address = deserial.read_short_hash();
+            const auto tx_hash = deserial.read_hash();
+
+            // Rows of reorganized blocks were never removed.
+            if (confirmed(height, tx_hash))
+                rows.emplace_back(height, tx_hash, ephemeral_key, address,
+                    prefix);
+        }
+
+        if (!file.close())
+            return false;
+    }
+
+    // A transaction confirmed again at the same height left a duplicate.
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    for (const auto& row: rows)
+        store(std::get<4>(row), std::get<0>(row),
+        {
+            std::get<2>(row),
+            std::get<3>(row),
+            std::get<1>(row)
+        });
+
+    sync();
+    return true;
 }
 
 void stealth_database::sync()
 {
-    rows_manager_.sync();
+    prefixes_manager_.sync();
+    payloads_manager_.sync();
+}
+
+memory_map::residency::list stealth_database::residency() const
+{
+    return { prefixes_file_.get_residency(), payloads_file_.get_residency() };
 }
 
 } // namespace database
@@ -20,12 +20,14 @@
  */
 #include <metaverse/database/databases/transaction_database.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/memory/memory.hpp>
+#include <metaverse/database/primitives/compact_transaction.hpp>
 #include <metaverse/database/result/transaction_result.hpp>
 
 namespace libbitcoin {
@@ -37,13 +39,18 @@ BC_CONSTEXPR size_t number_buckets = 100000000;
 BC_CONSTEXPR size_t header_size = slab_hash_table_header_size(number_buckets);
 BC_CONSTEXPR size_t initial_map_file_size = header_size + minimum_slabs_size;
 
+// Each slab is the key, the next position, then the height and index.
+BC_CONSTEXPR size_t slab_prefix_size = hash_size + sizeof(file_offset) + 4 + 4;
+
 transaction_database::transaction_database(const path& map_filename,
-    std::shared_ptr<shared_mutex> mutex)
+    std::shared_ptr<shared_mutex> mutex, bool compact)
   : lookup_file_(map_filename, mutex),
     lookup_header_(lookup_file_, number_buckets),
     lookup_manager_(lookup_file_, header_size),
-    lookup_map_(lookup_header_, lookup_manager_)
+    lookup_map_(lookup_header_, lookup_manager_),
+    compact_(compact)
 {
+    lookup_file_.set_access(memory_map::access_pattern::random, header_size);
 }
 
 // Close does not call stop because there is no way to detect thread join.
@@ -107,28 +114,81 @@ transaction_result transaction_database::get(const hash_digest& hash) const
     return transaction_result(memory);
 }
 
+bool transaction_database::get_block(chain::transaction::list& out_transactions,
+    const hash_list& hashes, size_t height) const
+{
+    out_transactions.clear();
+    if (hashes.empty())
+        return true;
+
+    auto position = lookup_map_.find_position(hashes.front());
+    if (position == slab_hash_table_header::empty)
+        return false;
+
+    const auto end = lookup_manager_.payload_size();
+    out_transactions.reserve(hashes.size());
+
+    for (size_t index = 0; index < hashes.size(); ++index)
+    {
+        if (position + slab_prefix_size > end)
+            return false;
+
+        // Each slab must be the expected transaction of this block, as a
+        // reorganization or a skipped duplicate breaks the sequence.
+        const auto memory = lookup_manager_.get(position);
+        const auto slab = REMAP_ADDRESS(memory);
+        const auto& hash = hashes[index];
+        if (!std::equal(hash.begin(), hash.end(), slab))
+            return false;
+
+        auto deserial = make_deserializer_unsafe(slab + hash_size +
+            sizeof(file_offset));
+        if (deserial.read_4_bytes_little_endian() != height)
+            return false;
+
+        const auto stored_index = deserial.read_4_bytes_little_endian();
+        if ((stored_index & ~compact_transaction_flag) != index)
+            return false;
+
+        chain::transaction tx;
+        const auto compact = (stored_index & compact_transaction_flag) != 0;
+        if (compact ? !compact_transaction::from_data(tx, deserial) :
+            !tx.from_data(deserial))
+            return false;
+
+        tx.set_hash(hash);
+        position += deserial.iterator() - slab;
+        out_transactions.push_back(std::move(tx));
+    }
+
+    return true;
+}
+
 void transaction_database::store(size_t height, size_t index,
     const chain::transaction& tx)
 {
     // Write block data.
     const auto key = tx.hash();
-    const auto tx_size = tx.serialized_size();
+    const auto tx_data = compact_ ? compact_transaction::to_data(tx) :
+        tx.to_data();
+    const auto tx_size = tx_data.size();
 
     BITCOIN_ASSERT(height <= max_uint32);
     const auto hight32 = static_cast<size_t>(height);
 
-    BITCOIN_ASSERT(index <= max_uint32);
-    const auto index32 = static_cast<size_t>(index);
+    BITCOIN_ASSERT(index < compact_transaction_flag);
+    const auto index32 = static_cast<uint32_t>(index) |
+        (compact_ ? compact_transaction_flag : 0);
 
     BITCOIN_ASSERT(tx_size <= max_size_t - 4 - 4);
     const auto value_size = 4 + 4 + static_cast<size_t>(tx_size);
 
-    auto write = [&hight32, &index32, &tx](memory_ptr data)
+    auto write = [&hight32, &index32, &tx_data](memory_ptr data)
     {
         auto serial = make_serializer(REMAP_ADDRESS(data));
         serial.write_4_bytes_little_endian(hight32);
         serial.write_4_bytes_little_endian(index32);
-        serial.write_data(tx.to_data());
+        serial.write_data(tx_data);
     };
     lookup_map_.store(key, write, value_size);
 }
@@ -144,5 +204,20 @@ void transaction_database::sync()
     lookup_manager_.sync();
 }
 
+size_t transaction_database::warm_up()
+{
+    return lookup_file_.warm_up();
+}
+
+memory_map::residency::list transaction_database::residency() const
+{
+    return { lookup_file_.get_residency() };
+}
+
+file_offset transaction_database::size() const
+{
+    return lookup_manager_.payload_size();
+}
+
 } // namespace database
 } // namespace libbitcoin
@@ -32,12 +32,14 @@
     #include <sys/mman.h>
     #define FILE_OPEN_PERMISSIONS S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH
 #endif
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <fcntl.h>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <boost/filesystem.hpp>
@@ -60,6 +62,12 @@ using boost::filesystem::path;
 #define EXPANSION_NUMERATOR 150
 #define EXPANSION_DENOMINATOR 100
 
+#ifdef RESERVED_MAPPING
+// The address space reserved for each file, which bounds its size. This is
+// only virtual, pages are neither committed nor counted until mapped.
+#define RESERVATION_SIZE (size_t(1) << 40)
+#endif
+
 size_t memory_map::file_size(int file_handle)
 {
     if (file_handle == -1)
@@ -137,6 +145,8 @@ void memory_map::log_unmapped()
 memory_map::memory_map(const path& filename)
   : file_handle_(open_file(filename)),
     filename_(filename),
+    pattern_(access_pattern::random),
+    hot_size_(0),
     data_(nullptr),
     file_size_(file_size(file_handle_)),
     logical_size_(file_size_),
@@ -182,7 +192,7 @@ bool memory_map::start()
     // Initialize data_.
     if (!map(file_size_))
         error_name = "map";
-    else if (madvise(data_, 0, MADV_RANDOM) == -1)
+    else if (!advise())
         error_name = "madvise";
     else
     {
@@ -249,7 +259,7 @@ bool memory_map::close()
 
     if (msync(data_, logical_size_, MS_SYNC) == -1)
         error_name = "msync";
-    else if (munmap(data_, file_size_) == -1)
+    else if (munmap(data_, mapped_size()) == -1)
         error_name = "munmap";
     else if (ftruncate(file_handle_, logical_size_) == -1)
         error_name = "ftruncate";
@@ -279,6 +289,85 @@ bool memory_map::stopped() const
     ///////////////////////////////////////////////////////////////////////////
 }
 
+// Access policy.
+// ----------------------------------------------------------------------------
+
+void memory_map::set_access(access_pattern pattern, size_t hot_size)
+{
+    // Critical Section (internal/unconditional)
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    pattern_ = pattern;
+    hot_size_ = hot_size;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t memory_map::warm_up()
+{
+    size_t hot;
+    uint8_t sum = 0;
+
+    // Critical Section (internal/unconditional)
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (closed_)
+        return 0;
+
+    hot = std::min(hot_size_, file_size_);
+    if (hot == 0)
+        return 0;
+
+    // Start the read ahead of the whole region, then fault each page in so
+    // that it is resident on return.
+    madvise(data_, hot, MADV_WILLNEED);
+    const auto step = std::max<size_t>(page(), 1);
+
+    for (size_t offset = 0; offset < hot; offset += step)
+        sum ^= static_cast<const volatile uint8_t*>(data_)[offset];
+    ///////////////////////////////////////////////////////////////////////////
+
+    log::debug(LOG_DATABASE)
+        << "Warmed up: " << filename_ << " [" << hot << "] (" << int(sum)
+        << ")";
+    return hot;
+}
+
+memory_map::residency memory_map::get_residency() const
+{
+    residency out{ filename_, 0, 0 };
+
+    // Critical Section (internal/unconditional)
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (closed_)
+        return out;
+
+    out.mapped = file_size_;
+
+#ifndef _WIN32
+#ifdef __APPLE__
+    typedef char page_state;
+#else
+    typedef unsigned char page_state;
+#endif
+    const auto step = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    std::vector<page_state> pages((file_size_ + step - 1) / step);
+
+    if (mincore(data_, file_size_, pages.data()) == -1)
+        return out;
+
+    for (const auto state: pages)
+        if ((state & 1) != 0)
+            out.resident += step;
+#endif
+
+    return out;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 // Operations.
 // ----------------------------------------------------------------------------
 
@@ -286,13 +375,19 @@ size_t memory_map::size() const
 {
     // Critical Section (internal)
     ///////////////////////////////////////////////////////////////////////////
+#ifdef RESERVED_MAPPING
+    shared_lock lock(mutex_);
+#else
     REMAP_READ(mutex_);
+#endif
 
     return file_size_;
     ///////////////////////////////////////////////////////////////////////////
 }
 
 // throws runtime_error
+// With a reserved mapping the base never moves, so this neither allocates nor
+// locks, and the pointer remains valid until close.
 memory_ptr memory_map::access()
 {
     return REMAP_ACCESSOR(data_, mutex_);
@@ -324,12 +419,20 @@ memory_ptr memory_map::reserve(size_t size, size_t expansion)
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
+#ifdef RESERVED_MAPPING
+    mutex_.lock_upgrade();
+#else
     const auto memory = REMAP_ALLOCATOR(mutex_);
+#endif
 
     // The store should only have been closed after all threads terminated.
     if (closed_)
     {
+#ifdef RESERVED_MAPPING
+        mutex_.unlock_upgrade();
+#else
         REMAP_DOWNGRADE(memory, data_);
+#endif
         throw std::runtime_error("Resize failure, store already closed.");
     }
 
@@ -341,9 +444,13 @@ memory_ptr memory_map::reserve(size_t size, size_t expansion)
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
         // TODO: isolate cause and if recoverable (disk size) return nullptr.
-        // All existing database pointers are invalidated by this call.
+        // All existing database pointers are invalidated by this call, unless
+        // the mapping is reserved.
         if (!truncate_mapped(target))
         {
+#ifdef RESERVED_MAPPING
+            mutex_.unlock();
+#endif
             handle_error("resize", filename_);
             throw std::runtime_error("Resize failure, disk space may be low.");
         }
@@ -353,11 +460,20 @@ memory_ptr memory_map::reserve(size_t size, size_t expansion)
     }
 
     logical_size_ = size;
+
+#ifdef RESERVED_MAPPING
+    const auto memory = data_;
+    mutex_.unlock_upgrade();
+
+    // The base never moves, so the pointer requires no lock.
+    return memory;
+#else
     REMAP_DOWNGRADE(memory, data_);
 
     // Always return in shared lock state.
     // The critical section does not end until this shared pointer is freed.
     return memory;
+#endif
     ///////////////////////////////////////////////////////////////////////////
 }
 
@@ -383,9 +499,19 @@ size_t memory_map::page()
 #endif
 }
 
+// The size of the address range to unmap, the whole reservation if reserved.
+size_t memory_map::mapped_size() const
+{
+#ifdef RESERVED_MAPPING
+    return RESERVATION_SIZE;
+#else
+    return file_size_;
+#endif
+}
+
 bool memory_map::unmap()
 {
-    const auto success = (munmap(data_, file_size_) != -1);
+    const auto success = (munmap(data_, mapped_size()) != -1);
     file_size_ = 0;
     data_ = nullptr;
     return success;
@@ -396,15 +522,59 @@ bool memory_map::map(size_t size)
     if (size == 0)
         return false;
 
+#ifdef RESERVED_MAPPING
+    if (size > RESERVATION_SIZE)
+        return false;
+
+    // Reserve the address space inaccessible, then map the file over its
+    // start. Growth maps further into the reservation, so data_ is fixed.
+    const auto reservation = mmap(0, RESERVATION_SIZE, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (reservation == MAP_FAILED)
+    {
+        data_ = nullptr;
+        return false;
+    }
+
+    data_ = reinterpret_cast<uint8_t*>(mmap(reservation, size,
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, file_handle_, 0));
+
+    if (data_ == MAP_FAILED)
+        munmap(reservation, RESERVATION_SIZE);
+
+    return validate(size);
+#else
     data_ = reinterpret_cast<uint8_t*>(mmap(0, size, PROT_READ | PROT_WRITE,
         MAP_SHARED, file_handle_, 0));
 
     return validate(size);
+#endif
 }
 
 bool memory_map::remap(size_t size)
 {
-#ifdef MREMAP_MAYMOVE
+#ifdef RESERVED_MAPPING
+    if (size > RESERVATION_SIZE)
+        return false;
+
+    if (size <= file_size_)
+        return true;
+
+    // Map the extension in place from the page holding the old end of file,
+    // which is replaced by the same shared page.
+    const auto step = std::max<size_t>(page(), 1);
+    const auto start = file_size_ / step * step;
+    const auto data = mmap(data_ + start, size - start,
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, file_handle_,
+        static_cast<off_t>(start));
+
+    if (data != data_ + start)
+        return false;
+
+    file_size_ = size;
+    return true;
+#elif defined(MREMAP_MAYMOVE)
     data_ = reinterpret_cast<uint8_t*>(mremap(data_, file_size_, size,
         MREMAP_MAYMOVE));
 
@@ -427,7 +597,7 @@ bool memory_map::truncate_mapped(size_t size)
     ///////////////////////////////////////////////////////////////////////////
     conditional_lock lock(remap_mutex_);
 
-#ifndef MREMAP_MAYMOVE
+#if !defined(RESERVED_MAPPING) && !defined(MREMAP_MAYMOVE)
     if (!unmap())
         return false;
 #endif
@@ -435,14 +605,35 @@ bool memory_map::truncate_mapped(size_t size)
     if (!truncate(size))
         return false;
 
-#ifndef MREMAP_MAYMOVE
-    return map(size);
+#if !defined(RESERVED_MAPPING) && !defined(MREMAP_MAYMOVE)
+    return map(size) && advise();
 #else
-    return remap(size);
+    return remap(size) && advise();
 #endif
     ///////////////////////////////////////////////////////////////////////////
 }
 
+// The hot region is random on any table, as it is a hash table header, and
+// advice ranges must start on a page boundary.
+bool memory_map::advise()
+{
+    const auto step = std::max<size_t>(page(), 1);
+    const auto hot = std::min(file_size_,
+        (std::min(hot_size_, file_size_) + step - 1) / step * step);
+
+    if (hot != 0 && madvise(data_, hot, MADV_RANDOM) == -1)
+        return false;
+
+    if (hot == file_size_)
+        return true;
+
+    const auto advice =
+        pattern_ == access_pattern::random ? MADV_RANDOM :
+        pattern_ == access_pattern::sequential ? MADV_SEQUENTIAL : MADV_NORMAL;
+
+    return madvise(data_ + hot, file_size_ - hot, advice) != -1;
+}
+
 bool memory_map::validate(size_t size)
 {
     if (data_ == MAP_FAILED)
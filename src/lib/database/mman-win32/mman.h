@@ -37,6 +37,9 @@ extern "C" {
 
 /* Flags for madvise (stub). */
 #define MADV_RANDOM     0
+#define MADV_NORMAL     1
+#define MADV_SEQUENTIAL 2
+#define MADV_WILLNEED   3
 
 void* mmap(void* addr, size_t len, int prot, int flags, int fildes, oft__ off);
 int munmap(void* addr, size_t len);
@@ -0,0 +1,194 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/primitives/compact_transaction.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace bc::chain;
+
+// Output script forms, the templated ones store only the script hash.
+enum script_form : uint8_t
+{
+    raw_script = 0,
+    pay_key_hash = 1,
+    pay_script_hash = 2
+};
+
+// OP_DUP OP_HASH160 [20] ... OP_EQUALVERIFY OP_CHECKSIG
+static constexpr size_t pay_key_hash_size = 25;
+static const data_chunk pay_key_hash_prefix{ 0x76, 0xa9, 0x14 };
+static const data_chunk pay_key_hash_suffix{ 0x88, 0xac };
+
+// OP_HASH160 [20] ... OP_EQUAL
+static constexpr size_t pay_script_hash_size = 23;
+static const data_chunk pay_script_hash_prefix{ 0xa9, 0x14 };
+static const data_chunk pay_script_hash_suffix{ 0x87 };
+
+static bool is_form(const data_chunk& script, size_t size,
+    const data_chunk& prefix, const data_chunk& suffix)
+{
+    return script.size() == size &&
+        std::equal(prefix.begin(), prefix.end(), script.begin()) &&
+        std::equal(suffix.begin(), suffix.end(), script.end() - suffix.size());
+}
+
+static void write_script(writer& sink, const script& script)
+{
+    const auto data = script.to_data(false);
+
+    if (is_form(data, pay_key_hash_size, pay_key_hash_prefix,
+        pay_key_hash_suffix))
+    {
+        sink.write_byte(pay_key_hash);
+        sink.write_data(&data[pay_key_hash_prefix.size()], short_hash_size);
+        return;
+    }
+
+    if (is_form(data, pay_script_hash_size, pay_script_hash_prefix,
+        pay_script_hash_suffix))
+    {
+        sink.write_byte(pay_script_hash);
+        sink.write_data(&data[pay_script_hash_prefix.size()], short_hash_size);
+        return;
+    }
+
+    sink.write_byte(raw_script);
+    sink.write_variable_uint_little_endian(data.size());
+    sink.write_data(data);
+}
+
+static bool read_script(reader& source, script& out)
+{
+    const auto form = source.read_byte();
+    data_chunk data;
+
+    switch (form)
+    {
+        case pay_key_hash:
+            data = build_chunk({ pay_key_hash_prefix,
+                source.read_short_hash(), pay_key_hash_suffix });
+            break;
+
+        case pay_script_hash:
+            data = build_chunk({ pay_script_hash_prefix,
+                source.read_short_hash(), pay_script_hash_suffix });
+            break;
+
+        case raw_script:
+            data = source.read_data(source.read_variable_uint_little_endian());
+            break;
+
+        default:
+            return false;
+    }
+
+    return source && out.from_data(data, false,
+        script::parse_mode::raw_data_fallback);
+}
+
+data_chunk compact_transaction::to_data(const transaction& tx)
+{
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+
+    sink.write_variable_uint_little_endian(tx.version);
+    sink.write_variable_uint_little_endian(tx.inputs.size());
+
+    for (const auto& input: tx.inputs)
+    {
+        // The null index and final sequence are the maximum, which wraps
+        // (index) or inverts (sequence) to a one byte zero.
+        const auto& point = input.previous_output;
+        sink.write_hash(point.hash);
+        sink.write_variable_uint_little_endian(uint32_t(point.index + 1));
+        input.script.to_data(sink, true);
+        sink.write_variable_uint_little_endian(uint32_t(~input.sequence));
+    }
+
+    sink.write_variable_uint_little_endian(tx.outputs.size());
+
+    for (const auto& output: tx.outputs)
+    {
+        sink.write_variable_uint_little_endian(output.value);
+        write_script(sink, output.script);
+        output.attach_data.to_data(sink);
+    }
+
+    sink.write_variable_uint_little_endian(tx.locktime);
+    ostream.flush();
+    return data;
+}
+
+bool compact_transaction::from_data(transaction& tx, reader& source)
+{
+    tx.reset();
+    tx.version = static_cast<uint32_t>(
+        source.read_variable_uint_little_endian());
+
+    tx.inputs.resize(source.read_variable_uint_little_endian());
+    if (!source)
+        return false;
+
+    for (auto& input: tx.inputs)
+    {
+        auto& point = input.previous_output;
+        point.hash = source.read_hash();
+        point.index = static_cast<uint32_t>(
+            source.read_variable_uint_little_endian()) - 1;
+
+        const auto mode = point.is_null() ? script::parse_mode::raw_data :
+            script::parse_mode::raw_data_fallback;
+
+        if (!source || !input.script.from_data(source, true, mode))
+            return false;
+
+        input.sequence = ~static_cast<uint32_t>(
+            source.read_variable_uint_little_endian());
+    }
+
+    tx.outputs.resize(source.read_variable_uint_little_endian());
+    if (!source)
+        return false;
+
+    for (auto& output: tx.outputs)
+    {
+        output.value = source.read_variable_uint_little_endian();
+
+        if (!source || !read_script(source, output.script) ||
+            !output.attach_data.from_data(source))
+            return false;
+    }
+
+    tx.locktime = static_cast<uint32_t>(
+        source.read_variable_uint_little_endian());
+
+    return source;
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/memory/memory.hpp>
+#include <metaverse/database/primitives/compact_transaction.hpp>
 
 namespace libbitcoin {
 namespace database {
@@ -34,11 +35,16 @@ static constexpr size_t height_size = sizeof(uint32_t);
 static constexpr size_t index_size = sizeof(uint32_t);
 
 template <typename Iterator>
-chain::transaction deserialize_tx(const Iterator first)
+chain::transaction deserialize_tx(const Iterator first, bool compact)
 {
     chain::transaction tx;
     auto deserial = make_deserializer_unsafe(first);
-    tx.from_data(deserial);
+
+    if (compact)
+        compact_transaction::from_data(tx, deserial);
+    else
+        tx.from_data(deserial);
+
     return tx;
 }
 
@@ -63,14 +69,18 @@ size_t transaction_result::index() const
 {
     BITCOIN_ASSERT(slab_);
     const auto memory = REMAP_ADDRESS(slab_);
-    return from_little_endian_unsafe<uint32_t>(memory + height_size);
+    return from_little_endian_unsafe<uint32_t>(memory + height_size) &
+        ~compact_transaction_flag;
 }
 
 chain::transaction transaction_result::transaction() const
 {
     BITCOIN_ASSERT(slab_);
     const auto memory = REMAP_ADDRESS(slab_);
-    return deserialize_tx(memory + height_size + index_size);
+    const auto index = from_little_endian_unsafe<uint32_t>(memory +
+        height_size);
+    const auto compact = (index & compact_transaction_flag) != 0;
+    return deserialize_tx(memory + height_size + index_size, compact);
     //// return deserialize_tx(memory + 8, size_limit_ - 8);
 }
 } // namespace database
@@ -30,6 +30,9 @@ using namespace boost::filesystem;
 settings::settings()
   : history_start_height(0),
     stealth_start_height(0),
+    compress_transactions(false),
+    deferred_indexes(false),
+    warm_up(false),
     directory("database")
 {
 }
@@ -22,7 +22,9 @@
 #include <metaverse/macros_define.hpp>
 
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 #include <metaverse/explorer/command.hpp>
@@ -82,6 +84,32 @@ static std::ostream& get_command_error(command& command, std::ostream& error)
     return error;
 }
 
+// The request time of every command, resolved once rather than per request.
+static metrics::histogram& request_time(const std::string& name)
+{
+    typedef std::unordered_map<std::string, metrics::histogram::ptr> table;
+    const auto make = [](const std::string& method)
+    {
+        return metrics::instance().make_histogram("mvs_rpc_request_seconds",
+            "Time to execute an RPC command.", "method=\"" + method + "\"");
+    };
+
+    static const auto histograms = [&make]()
+    {
+        table out;
+        std::ostringstream ignored;
+        broadcast([&](std::shared_ptr<command> instance)
+        {
+            const std::string method(instance->name());
+            out.emplace(method, make(method));
+        }, ignored);
+        return out;
+    }();
+
+    const auto it = histograms.find(name);
+    return it == histograms.end() ? *make(name) : *it->second;
+}
+
 console_result dispatch(int argc, const char* argv[],
     std::istream& input, std::ostream& output, std::ostream& error)
 {
@@ -168,6 +196,9 @@ console_result dispatch_command(int argc, const char* argv[],
 
     command->set_api_version(api_version);
 
+    // Only resolved commands are timed, so the label set stays bounded.
+    const metrics::scoped_timer timed(request_time(command->name()));
+
     if (command->category(ctgy_extension))
     {
 #ifndef PRIVATE_CHAIN
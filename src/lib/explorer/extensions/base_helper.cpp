@@ -444,6 +444,32 @@ void sync_fetch_asset_balance(const std::string& address, bool sum_all,
     bc::blockchain::block_chain_impl& blockchain,
     std::shared_ptr<asset_balances::list> sh_asset_vec)
 {
+    // Nothing is locked without encumbered outputs, so the balance table
+    // answers without reading each unspent output.
+    auto balances = blockchain.get_address_asset_balances(address);
+    if (balances) {
+        for (const auto& balance : *balances) {
+            const auto& symbol = balance.symbol;
+            if (bc::wallet::symbol::is_forbidden(symbol)) {
+                // swallow forbidden symbol
+                continue;
+            }
+
+            auto match = [sum_all, &symbol, &address](const asset_balances& elem) {
+                return (symbol == elem.symbol) && (sum_all || (address == elem.address));
+            };
+            auto iter = std::find_if(sh_asset_vec->begin(), sh_asset_vec->end(), match);
+
+            if (iter == sh_asset_vec->end()) { // new item
+                sh_asset_vec->push_back({symbol, address, balance.quantity, 0});
+            }
+            else { // exist just add amount
+                iter->unspent_asset += balance.quantity;
+            }
+        }
+        return;
+    }
+
     auto&& rows = blockchain.get_address_history(wallet::payment_address(address));
 
     chain::transaction tx_temp;
@@ -604,70 +630,69 @@ void sync_fetch_locked_balance(const std::string& address,
         return;
     }
 
-    auto&& rows = blockchain.get_address_history(wallet::payment_address(address));
-
     chain::transaction tx_temp;
     uint64_t tx_height = 0;
 
     uint64_t height = 0;
     blockchain.get_last_height(height);
 
-    for (auto& row: rows)
+    // Only the sequence locked outputs of the address are visited.
+    for (const auto& lock: blockchain.get_address_locks(address))
     {
-        // spend unconfirmed (or no spend attempted)
-        if ((row.spend.hash == null_hash)
-            && blockchain.get_transaction(tx_temp, tx_height, row.output.hash))
-        {
-            BITCOIN_ASSERT(row.output.index < tx_temp.outputs.size());
-            const auto& output = tx_temp.outputs.at(row.output.index);
+        if (is_asset != lock.is_asset) {
+            continue;
+        }
 
-            if (is_asset != output.is_asset()) {
-                continue;
-            }
+        tx_height = lock.height;
+        uint64_t locked_value = lock.value;
 
-            if (is_asset && asset_symbol != output.get_asset_symbol()) {
+        if (is_asset) {
+            if (!blockchain.get_transaction(tx_temp, tx_height, lock.point.hash)) {
                 continue;
             }
 
-            if (!operation::is_pay_key_hash_with_sequence_lock_pattern(output.script.operations)) {
+            BITCOIN_ASSERT(lock.point.index < tx_temp.outputs.size());
+            const auto& output = tx_temp.outputs.at(lock.point.index);
+            if (asset_symbol != output.get_asset_symbol()) {
                 continue;
             }
 
-            uint64_t locked_value = is_asset ? output.get_asset_amount() : row.value;
-            if (locked_value == 0) {
-                continue;
-            }
+            locked_value = output.get_asset_amount();
+        }
 
-            uint64_t locked_height = 0;
-            uint64_t expiration_height = 0;
-
-            auto raw_value = output.get_lock_sequence();
-            auto is_time_locked = is_relative_locktime_time_locked(raw_value);
-            if (is_time_locked) {
-                auto locked_seconds = get_relative_locktime_locked_seconds(raw_value);
-                auto prev_timestamp = blockchain.get_block_timestamp(tx_height);
-                auto curr_timestamp = blockchain.get_block_timestamp(height);
-                if ((prev_timestamp + locked_seconds <= curr_timestamp) ||
-                    (expiration > curr_timestamp && prev_timestamp + locked_seconds <= expiration)) {
-                    continue;
-                }
-                locked_height = locked_seconds;
-                expiration_height = prev_timestamp + locked_seconds;
+        if (locked_value == 0) {
+            continue;
+        }
+
+        uint64_t locked_height = 0;
+        uint64_t expiration_height = 0;
+
+        auto raw_value = lock.sequence;
+        auto is_time_locked = is_relative_locktime_time_locked(raw_value);
+        if (is_time_locked) {
+            auto locked_seconds = get_relative_locktime_locked_seconds(raw_value);
+            auto prev_timestamp = blockchain.get_block_timestamp(tx_height);
+            auto curr_timestamp = blockchain.get_block_timestamp(height);
+            if ((prev_timestamp + locked_seconds <= curr_timestamp) ||
+                (expiration > curr_timestamp && prev_timestamp + locked_seconds <= expiration)) {
+                continue;
             }
-            else {
-                auto locked_heights = get_relative_locktime_locked_heights(raw_value);
-                // use any kind of blocks
-                if ((tx_height + locked_heights <= height) ||
-                    (expiration > height && tx_height + locked_heights <= expiration)) {
-                    continue;
-                }
-                locked_height = locked_heights;
-                expiration_height = tx_height + locked_heights;
+            locked_height = locked_seconds;
+            expiration_height = prev_timestamp + locked_seconds;
+        }
+        else {
+            auto locked_heights = get_relative_locktime_locked_heights(raw_value);
+            // use any kind of blocks
+            if ((tx_height + locked_heights <= height) ||
+                (expiration > height && tx_height + locked_heights <= expiration)) {
+                continue;
             }
-
-            locked_balance locked{address, locked_value, locked_height, expiration_height, tx_height, is_time_locked};
-            sh_vec->emplace_back(locked);
+            locked_height = locked_heights;
+            expiration_height = tx_height + locked_heights;
         }
+
+        locked_balance locked{address, locked_value, locked_height, expiration_height, tx_height, is_time_locked};
+        sh_vec->emplace_back(locked);
     }
 }
 
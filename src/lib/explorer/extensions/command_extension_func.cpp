@@ -34,6 +34,7 @@
 #include <metaverse/explorer/extensions/commands/getinfo.hpp>
 #include <metaverse/explorer/extensions/commands/getheight.hpp>
 #include <metaverse/explorer/extensions/commands/getpeerinfo.hpp>
+#include <metaverse/explorer/extensions/commands/getsyncinfo.hpp>
 #include <metaverse/explorer/extensions/commands/getrandom.hpp>
 #include <metaverse/explorer/extensions/commands/verifyrandom.hpp>
 #include <metaverse/explorer/extensions/commands/getaddressetp.hpp>
@@ -134,6 +135,7 @@ void broadcast_extension(const function<void(shared_ptr<command>)> func, std::os
     func(make_shared<getinfo>());
     func(make_shared<addnode>());
     func(make_shared<getpeerinfo>());
+    func(make_shared<getsyncinfo>());
     func(make_shared<getrandom>());
     func(make_shared<verifyrandom>());
 
@@ -257,6 +259,8 @@ shared_ptr<command> find_extension(const string& symbol)
         return make_shared<addnode>();
     if (symbol == getpeerinfo::symbol())
         return make_shared<getpeerinfo>();
+    if (symbol == getsyncinfo::symbol())
+        return make_shared<getsyncinfo>();
     if (symbol == getrandom::symbol())
         return make_shared<getrandom>();
     if (symbol == verifyrandom::symbol())
@@ -51,6 +51,10 @@ console_result getinfo::invoke(Json::Value& jv_output,
     bool is_solo_mining;
     node.miner().get_state(height, rate, difficulty, is_solo_mining, stake_utxos);
 
+    // The address and asset queries see blocks up to the indexed height.
+    uint64_t indexed_height = 0;
+    blockchain.get_indexed_height(indexed_height);
+
     auto& jv = jv_output;
     if (get_api_version() <= 2) {
         jv["protocol-version"] = node.network_settings().protocol;
@@ -63,6 +67,7 @@ console_result getinfo::invoke(Json::Value& jv_output,
         jv["wallet-account-count"] = static_cast<uint64_t>(blockchain.get_accounts()->size());
 
         jv["height"] = height;
+        jv["indexed-height"] = indexed_height;
         jv["difficulty"] = difficulty;
         jv["is-mining"] = is_solo_mining;
         jv["hash-rate"] = rate;
@@ -78,6 +83,7 @@ console_result getinfo::invoke(Json::Value& jv_output,
         jv["wallet_account_count"] = static_cast<uint64_t>(blockchain.get_accounts()->size());
 
         jv["height"] = height;
+        jv["indexed_height"] = indexed_height;
         jv["difficulty"] = difficulty;
         jv["is_mining"] = is_solo_mining;
         jv["hash_rate"] = rate;
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2016-2020 mvs developers
+ *
+ * This file is part of metaverse-explorer.
+ *
+ * metaverse-explorer is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <metaverse/node/p2p_node.hpp>
+#include <metaverse/explorer/dispatch.hpp>
+#include <metaverse/explorer/extensions/commands/getsyncinfo.hpp>
+#include <metaverse/explorer/extensions/command_extension_func.hpp>
+#include <metaverse/explorer/extensions/command_assistant.hpp>
+#include <metaverse/explorer/extensions/node_method_wrapper.hpp>
+
+namespace libbitcoin {
+namespace explorer {
+namespace commands {
+using namespace bc::explorer::config;
+
+/************************ getsyncinfo *************************/
+
+console_result getsyncinfo::invoke(Json::Value& jv_output,
+                                   libbitcoin::server::server_node& node)
+{
+    administrator_required_checker(node, auth_.name, auth_.auth);
+
+    Json::Value array;
+    for (const auto& flow : node.block_sync_flows()) {
+        Json::Value slot;
+        slot["slot"] = static_cast<uint64_t>(flow.slot);
+        slot["peer"] = flow.peer;
+        slot["window"] = static_cast<uint64_t>(flow.window);
+        slot["in_flight"] = static_cast<uint64_t>(flow.in_flight);
+        slot["remaining"] = static_cast<uint64_t>(flow.remaining);
+        slot["round_trip_ms"] = flow.round_trip / 1000;
+        slot["blocks_per_second"] = flow.rate;
+        slot["reissued"] = static_cast<uint64_t>(flow.reissued);
+        array.append(slot);
+    }
+
+    if (array.isNull())
+        array.resize(0);
+
+    jv_output = array;
+    return console_result::okay;
+}
+
+} // namespace commands
+} // namespace explorer
+} // namespace libbitcoin
+
@@ -126,7 +126,8 @@ void acceptor::accept(accept_handler handler)
         return;
     }
 
-    const auto socket = std::make_shared<network::socket>(pool_);
+    // Each accepted channel is pinned to a shard, when sharding is enabled.
+    const auto socket = std::make_shared<network::socket>(pool_.shard());
     safe_accept(socket, handler);
 
     mutex_.unlock();
@@ -158,7 +159,8 @@ void acceptor::handle_accept(const boost_code& ec, socket::ptr socket,
 
 std::shared_ptr<channel> acceptor::new_channel(socket::ptr socket)
 {
-    return std::make_shared<channel>(pool_, socket, settings_);
+    return std::make_shared<channel>(socket->thread_pool(), socket,
+        settings_);
 }
 
 } // namespace network
@@ -234,8 +234,10 @@ void connector::handle_resolve(const boost_code& ec, asio::iterator iterator,
     auto do_connecting = [this, &handler](asio::iterator resolver_iterator)
     {
         const auto timeout = settings_.connect_timeout();
-        const auto timer = std::make_shared<deadline>(pool_, timeout);
-        const auto socket = std::make_shared<network::socket>(pool_);
+        // Each connected channel is pinned to a shard, when sharding is enabled.
+        auto& pool = pool_.shard();
+        const auto timer = std::make_shared<deadline>(pool, timeout);
+        const auto socket = std::make_shared<network::socket>(pool);
 
         // Retain a socket reference until connected, allowing connect cancelation.
         pending_.store(socket);
@@ -313,7 +315,8 @@ void connector::handle_connect(const boost_code& ec,
 
 std::shared_ptr<channel> connector::new_channel(socket::ptr socket)
 {
-    return std::make_shared<channel>(pool_, socket, settings_);
+    return std::make_shared<channel>(socket->thread_pool(), socket,
+        settings_);
 }
 
 } // namespace network
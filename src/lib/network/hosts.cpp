@@ -26,7 +26,10 @@
 #include <string>
 #include <vector>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/utility/istream_reader.hpp>
+#include <metaverse/bitcoin/utility/ostream_writer.hpp>
 #include <metaverse/bitcoin/utility/path.hpp>
+#include <metaverse/bitcoin/utility/time.hpp>
 #include <metaverse/bitcoin/math/limits.hpp>
 #include <metaverse/network/settings.hpp>
 #include <metaverse/network/channel.hpp>
@@ -36,11 +39,29 @@ namespace network {
 
 uint32_t timer_interval = 60 * 5; // 5 minutes
 
+// The binary hosts file starts with this magic and format version.
+static constexpr uint32_t cache_magic = 0x7374686d; // "mhts"
+static constexpr uint8_t cache_version = 1;
+
+// A tried host is demoted once this many connections in a row fail.
+static constexpr uint16_t tried_failures = 3;
+
+// The number of hosts compared by score when fetching an address.
+static constexpr size_t fetch_sample = 8;
+
+// The weight of a new round trip time in the latency average (1/n).
+static constexpr uint32_t latency_weight = 4;
+
+static uint32_t now_seconds()
+{
+    return static_cast<uint32_t>(unix_millisecond() / 1000);
+}
 
 hosts::hosts(threadpool& pool, const settings& settings)
     : seed_count(settings.seeds.size())
     , host_pool_capacity_(std::max(settings.host_pool_capacity, 1u))
     , buffer_(host_pool_capacity_)
+    , tried_(std::max<size_t>(host_pool_capacity_ / 4, 1))
     , backup_(host_pool_capacity_)
     , inactive_(host_pool_capacity_ * 2)
     , seeds_()
@@ -67,13 +88,56 @@ hosts::iterator hosts::find(list& buffer, const address& host)
     return std::find_if(buffer.begin(), buffer.end(), found);
 }
 
+// private, call under lock.
+hosts::history* hosts::find_history(const address& host)
+{
+    const auto it = history_.find(host);
+    return it == history_.end() ? nullptr : &it->second;
+}
+
+// private, call under lock.
+// Connecting earns the most, then delivered blocks, while failures, bans and
+// a slow round trip count against the host. Unknown hosts score zero.
+int64_t hosts::score(const address& host) const
+{
+    const auto it = history_.find(host);
+    if (it == history_.end())
+        return 0;
+
+    const auto& entry = it->second;
+    int64_t value = entry.last_success == 0 ? 0 : 100;
+    value += std::min<uint32_t>(entry.blocks, 1000) / 10;
+    value -= std::min<uint32_t>(entry.latency, 2000) / 20;
+    value -= int64_t(50) * entry.failures;
+    value -= int64_t(200) * entry.bans;
+    return value;
+}
+
+// private, call under exclusive lock.
+void hosts::insert_tried(const address& host)
+{
+    if (find(tried_, host) != tried_.end())
+        return;
+
+    // Make room by returning the longest tried host to the new table.
+    if (tried_.full())
+    {
+        if (find(tried_.front()) == buffer_.end())
+            buffer_.push_back(tried_.front());
+
+        tried_.pop_front();
+    }
+
+    tried_.push_back(host);
+}
+
 size_t hosts::count() const
 {
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
     shared_lock lock(mutex_);
 
-    return buffer_.size();
+    return buffer_.size() + tried_.size();
     ///////////////////////////////////////////////////////////////////////////
 }
 
@@ -82,9 +146,70 @@ code hosts::fetch_seed(address& out, const config::authority::list& excluded_lis
     return fetch(seeds_, out, excluded_list);
 }
 
+// private, call under lock.
+// Compare a few randomly sampled hosts and pick the best scoring one, this
+// avoids copying the table and favours peers with a good history.
+bool hosts::fetch_scored(const list& buffer, address& out,
+    const config::authority::list& excluded_list) const
+{
+    if (buffer.empty())
+        return false;
+
+    size_t sampled = 0;
+    int64_t best = 0;
+
+    for (size_t attempt = 0; attempt < 4 * fetch_sample &&
+        sampled < fetch_sample; ++attempt)
+    {
+        const auto index = pseudo_random(0, buffer.size() - 1);
+        const auto& host = buffer[static_cast<size_t>(index)];
+        const config::authority authority(host);
+
+        if (channel::blacklisted(authority) ||
+            std::find(excluded_list.begin(), excluded_list.end(),
+                authority) != excluded_list.end())
+            continue;
+
+        const auto value = score(host);
+        if (sampled++ == 0 || value > best)
+        {
+            best = value;
+            out = host;
+        }
+    }
+
+    return sampled != 0;
+}
+
 code hosts::fetch(address& out, const config::authority::list& excluded_list)
 {
-    return fetch(buffer_, out, excluded_list);
+    if (disabled_) {
+        return error::not_found;
+    }
+
+    {
+        // Critical Section
+        shared_lock lock(mutex_);
+
+        if (stopped_) {
+            return error::service_stopped;
+        }
+
+        // Prefer tried hosts, but keep giving new hosts a chance.
+        const auto prefer_tried = !tried_.empty() && pseudo_random(0, 3) != 0;
+        auto& first = prefer_tried ? tried_ : buffer_;
+        auto& second = prefer_tried ? buffer_ : tried_;
+
+        if (fetch_scored(first, out, excluded_list) ||
+            fetch_scored(second, out, excluded_list)) {
+            return error::success;
+        }
+    }
+
+    // Sampling may miss the few hosts not excluded, so scan the tables.
+    const auto ec = fetch(tried_, out, excluded_list);
+    return ec.value() == error::not_found ?
+        fetch(buffer_, out, excluded_list) : ec;
 }
 
 template <typename T>
@@ -139,29 +264,50 @@ hosts::address::list hosts::copy()
 
     shared_lock lock{mutex_};
 
-    if (stopped_ || buffer_.empty())
+    const auto limit = buffer_.size() + tried_.size();
+    if (stopped_ || limit == 0)
         return address::list();
 
     // not copy all, but just 10% ~ 20% , at least one
     const auto out_count = std::max<size_t>(1,
-        std::min<size_t>(1000, buffer_.size()) / pseudo_random(5, 10));
+        std::min<size_t>(1000, limit) / pseudo_random(5, 10));
 
-    const auto limit = buffer_.size();
     auto index = pseudo_random(0, limit - 1);
 
-    address::list copy(out_count);
+    address::list copy;
+    copy.reserve(out_count);
 
-    for (size_t count = 0; count < out_count; ++count)
-        copy.push_back(buffer_[index++ % limit]);
+    for (size_t count = 0; count < out_count; ++count, ++index)
+    {
+        const auto position = static_cast<size_t>(index % limit);
+        copy.push_back(position < tried_.size() ? tried_[position] :
+            buffer_[position - tried_.size()]);
+    }
 
     pseudo_random::shuffle(copy);
     return copy;
 }
 
+// The file is the magic and version followed by the tried and then the new
+// table, each a count and fixed size records of address and history.
 bool hosts::store_cache(bool succeed_clear_buffer)
 {
-    if (!buffer_.empty()) {
-        bc::ofstream file(file_path_.string());
+    // Drop the history of hosts that have left the tables.
+    history_map retained;
+    for (const auto table : { &tried_, &buffer_, &inactive_ }) {
+        for (const auto& entry : *table) {
+            const auto it = history_.find(entry);
+            if (it != history_.end()) {
+                retained.insert(*it);
+            }
+        }
+    }
+
+    history_.swap(retained);
+
+    if (!buffer_.empty() || !tried_.empty()) {
+        bc::ofstream file(file_path_.string(),
+            std::ofstream::out | std::ofstream::binary);
         const auto file_error = file.bad();
 
         if (file_error) {
@@ -172,18 +318,49 @@ bool hosts::store_cache(bool succeed_clear_buffer)
         log::debug(LOG_NETWORK)
                 << "sync hosts to file(" << file_path_.string()
                 << "), inactive size is " << inactive_.size()
+                << ", tried size is " << tried_.size()
                 << ", buffer size is " << buffer_.size();
 
-        for (const auto& entry : buffer_) {
-            // TODO: create full space-delimited network_address serialization.
-            // Use to/from string format as opposed to wire serialization.
-            if (!(channel::blacklisted(entry) || channel::manualbanned(entry))) {
-                file << config::authority(entry) << std::endl;
+        ostream_writer sink(file);
+        sink.write_4_bytes_little_endian(cache_magic);
+        sink.write_byte(cache_version);
+
+        static const history empty{ 0, 0, 0, 0, 0, 0 };
+        std::vector<const address*> entries;
+
+        for (const auto table : { &tried_, &buffer_ }) {
+            entries.clear();
+            for (const auto& entry : *table) {
+                if (!(channel::blacklisted(entry) || channel::manualbanned(entry))) {
+                    entries.push_back(&entry);
+                }
+            }
+
+            sink.write_4_bytes_little_endian(
+                static_cast<uint32_t>(entries.size()));
+
+            for (const auto entry : entries) {
+                const auto it = history_.find(*entry);
+                const auto& record = it == history_.end() ? empty : it->second;
+                entry->to_data(0, sink, false);
+                sink.write_4_bytes_little_endian(record.last_attempt);
+                sink.write_4_bytes_little_endian(record.last_success);
+                sink.write_4_bytes_little_endian(record.latency);
+                sink.write_4_bytes_little_endian(record.blocks);
+                sink.write_2_bytes_little_endian(record.failures);
+                sink.write_2_bytes_little_endian(record.bans);
             }
         }
 
+        if (!file.good()) {
+            log::error(LOG_NETWORK) << "hosts file (" << file_path_.string() << ") write failed" ;
+            return false;
+        }
+
         if (succeed_clear_buffer) {
             buffer_.clear();
+            tried_.clear();
+            history_.clear();
         }
     }
     else {
@@ -244,6 +421,66 @@ code hosts::start()
 
     stopped_ = false;
 
+    if (!load_cache() && !load_legacy_cache()) {
+        log::debug(LOG_NETWORK)
+                << "Failed to load hosts file.";
+        return error::file_system;
+    }
+
+    log::debug(LOG_NETWORK)
+            << "Loaded " << tried_.size() << " tried and " << buffer_.size()
+            << " new hosts.";
+
+    return error::success;
+}
+
+// private, call under exclusive lock.
+// False if the file is not in the binary format, so the caller may fall back
+// to the text format. A truncated file keeps the hosts read before the end.
+bool hosts::load_cache()
+{
+    bc::ifstream file(file_path_.string(),
+        std::ifstream::in | std::ifstream::binary);
+    if (!file.good()) {
+        return false;
+    }
+
+    istream_reader source(file);
+    if (source.read_4_bytes_little_endian() != cache_magic ||
+        source.read_byte() != cache_version || !source) {
+        return false;
+    }
+
+    for (const auto table : { &tried_, &buffer_ }) {
+        const auto count = source.read_4_bytes_little_endian();
+
+        for (uint32_t index = 0; index < count && source; ++index) {
+            address host;
+            history record;
+            const auto valid = host.from_data(0, source, false);
+            record.last_attempt = source.read_4_bytes_little_endian();
+            record.last_success = source.read_4_bytes_little_endian();
+            record.latency = source.read_4_bytes_little_endian();
+            record.blocks = source.read_4_bytes_little_endian();
+            record.failures = source.read_2_bytes_little_endian();
+            record.bans = source.read_2_bytes_little_endian();
+
+            if (!valid || !source || host.port == 0 || !host.is_routable()
+                    || table->full()) {
+                continue;
+            }
+
+            table->push_back(host);
+            history_.emplace(host, record);
+        }
+    }
+
+    return true;
+}
+
+// private, call under exclusive lock.
+bool hosts::load_legacy_cache()
+{
     bc::ifstream file(file_path_.string());
     const auto file_error = file.bad();
     if (!file_error) {
@@ -267,13 +504,7 @@ code hosts::start()
         }
     }
 
-    if (file_error) {
-        log::debug(LOG_NETWORK)
-                << "Failed to save hosts file.";
-        return error::file_system;
-    }
-
-    return error::success;
+    return !file_error;
 }
 
 // load
@@ -397,6 +628,24 @@ code hosts::remove(const address& host)
 
     upgrade_to_unique_lock unq_lock(lock);
 
+    const auto record = find_history(host);
+    if (record != nullptr) {
+        record->last_attempt = now_seconds();
+        if (record->failures < max_uint16) {
+            ++record->failures;
+        }
+    }
+
+    // A tried host is given a few chances before it is made inactive.
+    auto tried = find(tried_, host);
+    if (tried != tried_.end()) {
+        if (record != nullptr && record->failures < tried_failures) {
+            return error::success;
+        }
+
+        tried_.erase(tried);
+    }
+
     auto it = find(host);
     if (it != buffer_.end()) {
         buffer_.erase(it);
@@ -505,7 +754,7 @@ code hosts::store(const address& host)
 
     upgrade_to_unique_lock unq_lock(lock);
 
-    if (find(host) == buffer_.end()) {
+    if (find(host) == buffer_.end() && find(tried_, host) == tried_.end()) {
         buffer_.push_back(host);
     }
 
@@ -571,6 +820,7 @@ void hosts::store(const address::list& hosts, result_handler handler)
 
             // Do not allow duplicates in the host cache.
             if (find(host) == buffer_.end()
+                    && find(tried_, host) == tried_.end()
                     && find(inactive_, host) == inactive_.end()) {
                 ++accepted;
                 buffer_.push_back(host);
@@ -588,5 +838,107 @@ void hosts::store(const address::list& hosts, result_handler handler)
     handler(error::success);
 }
 
+void hosts::connected(const address& host)
+{
+    if (disabled_ || !host.is_routable()) {
+        return;
+    }
+
+    // don't store self address
+    const config::authority authority{host};
+    if (authority == self_ || authority.port() == 0) {
+        return;
+    }
+
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    if (stopped_) {
+        return;
+    }
+
+    auto& record = history_[host];
+    record.last_attempt = record.last_success = now_seconds();
+    record.failures = 0;
+
+    auto it = find(host);
+    if (it != buffer_.end()) {
+        buffer_.erase(it);
+    }
+
+    auto inactive = find(inactive_, host);
+    if (inactive != inactive_.end()) {
+        inactive_.erase(inactive);
+    }
+
+    insert_tried(host);
+}
+
+void hosts::measured(const address& host, uint32_t milliseconds)
+{
+    if (disabled_) {
+        return;
+    }
+
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    // Only hosts connected to are tracked, which excludes inbound peers.
+    const auto record = find_history(host);
+    if (record == nullptr) {
+        return;
+    }
+
+    record->latency = record->latency == 0 ? milliseconds :
+        (record->latency * (latency_weight - 1) + milliseconds) /
+            latency_weight;
+}
+
+void hosts::delivered(const address& host, size_t blocks)
+{
+    if (disabled_) {
+        return;
+    }
+
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    const auto record = find_history(host);
+    if (record == nullptr) {
+        return;
+    }
+
+    record->blocks = static_cast<uint32_t>(std::min<uint64_t>(
+        uint64_t(record->blocks) + blocks, max_uint32));
+}
+
+void hosts::banned(const address& host)
+{
+    if (disabled_) {
+        return;
+    }
+
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    const auto record = find_history(host);
+    if (record == nullptr) {
+        return;
+    }
+
+    if (record->bans < max_uint16) {
+        ++record->bans;
+    }
+
+    // The ban outlives the connection, so stop preferring the host.
+    auto tried = find(tried_, host);
+    if (tried != tried_.end()) {
+        tried_.erase(tried);
+        if (find(host) == buffer_.end()) {
+            buffer_.push_back(host);
+        }
+    }
+}
+
 } // namespace network
 } // namespace libbitcoin
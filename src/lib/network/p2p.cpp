@@ -89,6 +89,7 @@ void p2p::start(result_handler handler)
 
     threadpool_.join();
     threadpool_.spawn(settings_.threads, thread_priority::low);
+    threadpool_.spawn_shards(settings_.thread_shards, thread_priority::low);
 
     stopped_ = false;
     stop_subscriber_->start();
@@ -465,6 +466,26 @@ void p2p::address_count(count_handler handler)
     handler(hosts_->count());
 }
 
+void p2p::connected(const address& address)
+{
+    hosts_->connected(address);
+}
+
+void p2p::measured(const address& address, uint32_t milliseconds)
+{
+    hosts_->measured(address, milliseconds);
+}
+
+void p2p::delivered(const address& address, size_t blocks)
+{
+    hosts_->delivered(address, blocks);
+}
+
+void p2p::banned(const address& address)
+{
+    hosts_->banned(address);
+}
+
 p2p::address::list p2p::address_list()
 {
     return hosts_->copy();
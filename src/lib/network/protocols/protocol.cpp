@@ -30,7 +30,8 @@ namespace network {
 
 protocol::protocol(p2p& network, channel::ptr channel,
     const std::string& name)
-  : pool_(network.thread_pool()),
+  : network_(network),
+    pool_(channel->thread_pool()),
     channel_(channel),
     name_(name)
 {
@@ -79,7 +80,21 @@ void protocol::stop(const code& ec)
 
 bool protocol::misbehaving(int32_t howmuch)
 {
-    return channel_->misbehaving(howmuch);
+    if (!channel_->misbehaving(howmuch))
+        return false;
+
+    network_.banned(authority().to_network_address());
+    return true;
+}
+
+void protocol::report_latency(uint32_t milliseconds)
+{
+    network_.measured(authority().to_network_address(), milliseconds);
+}
+
+void protocol::report_blocks(size_t count)
+{
+    network_.delivered(authority().to_network_address(), count);
 }
 
 } // namespace network
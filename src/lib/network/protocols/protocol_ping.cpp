@@ -76,7 +76,8 @@ void protocol_ping::send_ping(const code& ec)
 
     const auto nonce = pseudo_random();
 
-    SUBSCRIBE3(pong, handle_receive_pong, _1, _2, nonce);
+    SUBSCRIBE4(pong, handle_receive_pong, _1, _2, nonce,
+        asio::steady_clock::now());
     SEND2(ping{ nonce }, handle_send, _1, pong::command);
 }
 
@@ -102,7 +103,7 @@ bool protocol_ping::handle_receive_ping(const code& ec,
 }
 
 bool protocol_ping::handle_receive_pong(const code& ec,
-    message::pong::ptr message, uint64_t nonce)
+    message::pong::ptr message, uint64_t nonce, asio::time_point sent)
 {
     if (stopped(ec))
         return false;
@@ -124,8 +125,12 @@ bool protocol_ping::handle_receive_pong(const code& ec,
         // This could result from message overlap due to a short period,
         // but we assume the response is not as expected and terminate.
         stop(error::bad_stream);
+        return false;
     }
 
+    const auto elapsed = std::chrono::duration_cast<asio::milliseconds>(
+        asio::steady_clock::now() - sent);
+    report_latency(static_cast<uint32_t>(elapsed.count()));
     return false;
 }
 
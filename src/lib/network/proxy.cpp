@@ -80,12 +80,26 @@ std::shared_ptr<traffic> traffic::instance_ = nullptr;
 
 #define NAME "proxy"
 
+static const auto peer_received_metric = "mvs_peer_received_bytes_total";
+static const auto peer_sent_metric = "mvs_peer_sent_bytes_total";
+
+// Distinguishes concurrent channels to the same authority in peer series.
+static std::atomic<uint64_t> proxy_sequence{0};
+
+static auto& total_received = *metrics::instance().make_counter(
+    "mvs_network_received_bytes_total",
+    "Bytes read from all peers.");
+static auto& total_sent = *metrics::instance().make_counter(
+    "mvs_network_sent_bytes_total",
+    "Bytes written to all peers.");
+
 using namespace message;
 using namespace std::placeholders;
 
 proxy::proxy(threadpool& pool, socket::ptr socket, uint32_t protocol_magic,
     uint32_t protocol_version)
-  : protocol_magic_(protocol_magic),
+  : pool_(pool),
+    protocol_magic_(protocol_magic),
     protocol_version_(protocol_version),
     authority_(socket->get_authority()),
     heading_buffer_(heading::maximum_size()),
@@ -97,6 +111,9 @@ proxy::proxy(threadpool& pool, socket::ptr socket, uint32_t protocol_magic,
     message_subscriber_(pool),
     stop_subscriber_(std::make_shared<stop_subscriber>(pool, NAME)),
     has_sent_{true},
+    peer_label_("peer=\"" + authority_.to_string() + "\",channel=\"" +
+        std::to_string(++proxy_sequence) + "\""),
+    exported_(false),
     misbehaving_{0}
 {
 }
@@ -114,6 +131,11 @@ const config::authority& proxy::authority() const
     return authority_;
 }
 
+threadpool& proxy::thread_pool()
+{
+    return pool_;
+}
+
 message::version proxy::version() const
 {
     const auto version = peer_version_message_.load();
@@ -138,6 +160,13 @@ void proxy::start(result_handler handler)
         return;
     }
 
+    // The peer series are exported from start until the first stop.
+    received_ = metrics::instance().make_counter(peer_received_metric,
+        "Bytes read from a connected peer.", peer_label_);
+    sent_ = metrics::instance().make_counter(peer_sent_metric,
+        "Bytes written to a connected peer.", peer_label_);
+    exported_ = true;
+
     stopped_ = false;
     stop_subscriber_->start();
     message_subscriber_.start();
@@ -194,6 +223,9 @@ void proxy::handle_read_heading(const boost_code& ec, size_t)
 #ifndef NDEBUG
     traffic::instance().rx(heading_buffer_.size());
 #endif
+    total_received.increment(heading_buffer_.size());
+    received_->increment(heading_buffer_.size());
+
     const auto head = heading::factory_from_data(heading_buffer_);
 
     if (!head.is_valid())
@@ -266,6 +298,8 @@ void proxy::handle_read_payload(const boost_code& ec, size_t payload_size,
 #ifndef NDEBUG
     traffic::instance().rx(payload_buffer_.size());
 #endif
+    total_received.increment(payload_buffer_.size());
+    received_->increment(payload_buffer_.size());
 
     auto checksum = bitcoin_checksum(payload_buffer_);
     if (head.checksum != checksum)
@@ -418,6 +452,8 @@ void proxy::handle_send(const boost_code& ec, const_buffer buffer,
 #ifndef NDEBUG
         traffic::instance().tx(buffer.size());
 #endif
+        total_sent.increment(buffer.size());
+        sent_->increment(buffer.size());
     }
 
     handler(error);
@@ -457,6 +493,12 @@ void proxy::stop(const code& ec)
 
     stopped_ = true;
 
+    if (exported_.exchange(false))
+    {
+        metrics::instance().remove(peer_received_metric, peer_label_);
+        metrics::instance().remove(peer_sent_metric, peer_label_);
+    }
+
     // Prevent subscription after stop.
     message_subscriber_.stop();
     message_subscriber_.broadcast(error::channel_stopped);
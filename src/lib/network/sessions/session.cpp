@@ -122,6 +122,11 @@ void session::store(const message::network_address& address)
     network_.store(address, [](const code&){});
 }
 
+void session::connected(const message::network_address& address)
+{
+    network_.connected(address);
+}
+
 // Socket creators.
 // ----------------------------------------------------------------------------
 // Must not change context in the stop handlers (must use bind).
@@ -182,7 +182,7 @@ void session_batch::handle_connect(const code& ec, channel::ptr channel,
         return;
     }
 
-    store(host.to_network_address());
+    connected(host.to_network_address());
 
     log::trace(LOG_NETWORK)
         << "Connected to [" << host << "]";
@@ -29,7 +29,8 @@ namespace libbitcoin {
 namespace network {
 
 socket::socket(threadpool& pool)
-  : socket_(pool.service()),
+  : pool_(pool),
+    socket_(pool.service()),
     CONSTRUCT_TRACK(socket)
 {
 }
@@ -41,6 +42,11 @@ config::authority socket::get_authority() const
     return ec ? config::authority() : config::authority(endpoint);
 }
 
+threadpool& socket::thread_pool()
+{
+    return pool_;
+}
+
 locked_socket::ptr socket::get_socket()
 {
     return std::make_shared<locked_socket>(socket_, mutex_);
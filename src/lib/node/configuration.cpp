@@ -30,6 +30,7 @@ namespace node {
 configuration::configuration(bc::settings context)
   : help(false),
     initchain(false),
+    convert_transactions(false),
     settings(false),
     version(false),
     daemon{false},
@@ -46,12 +47,15 @@ configuration::configuration(bc::settings context)
 configuration::configuration(const configuration& other)
   : help(other.help),
     initchain(other.initchain),
+    convert_transactions(other.convert_transactions),
     settings(other.settings),
     version(other.version),
     daemon{other.daemon},
     use_testnet_rules{other.use_testnet_rules},
     upnp_map_port{other.upnp_map_port},
     file(other.file),
+    export_blocks(other.export_blocks),
+    import_blocks(other.import_blocks),
     node(other.node),
     chain(other.chain),
     database(other.database),
@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <functional>
 #include <metaverse/blockchain.hpp>
+#include <metaverse/consensus/miner/MinerAux.h>
 #include <metaverse/node/configuration.hpp>
 #include <metaverse/node/sessions/session_block_sync.hpp>
 #include <metaverse/node/sessions/session_header_sync.hpp>
@@ -46,6 +47,7 @@ p2p_node::p2p_node(const configuration& configuration)
     blockchain_(thread_pool(), configuration.chain, configuration.database),
     settings_(configuration.node)
 {
+    work::set_trace_sample(settings_.work_trace_sample);
 }
 
 p2p_node::~p2p_node()
@@ -72,6 +74,9 @@ void p2p_node::start(result_handler handler)
         return;
     }
 
+    // Light caches of upcoming epochs are built on the node threadpool.
+    MinerAux::attach(&thread_pool());
+
     // This is invoked on the same thread.
     // Stopped is true and no network threads until after this call.
     p2p::start(handler);
@@ -117,6 +122,13 @@ void p2p_node::handle_headers_synchronized(const code& ec,
     // The instance is retained by the stop handler (i.e. until shutdown).
     const auto block_sync = attach_block_sync_session();
 
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    block_sync_mutex_.lock();
+    block_sync_ = block_sync;
+    block_sync_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
     // This is invoked on a new thread.
     block_sync->start(
         std::bind(&p2p_node::handle_running,
@@ -182,7 +194,7 @@ bool p2p_node::handle_reorganized(const code& ec, size_t fork_point,
         return false;
     }
 
-    for (const auto block: outgoing)
+    for (const auto& block: outgoing)
         log::debug(LOG_NODE)
             << "Reorganization discarded block ["
             << encode_hash(block->header.hash()) << "]";
@@ -230,6 +242,8 @@ session_block_sync::ptr p2p_node::attach_block_sync_session()
 
 bool p2p_node::stop()
 {
+    MinerAux::attach(nullptr);
+
     // Suspend new work last so we can use work to clear subscribers.
     return p2p::stop();
 }
@@ -268,6 +282,21 @@ transaction_pool& p2p_node::pool()
     return blockchain_.pool();
 }
 
+std::vector<reservation::flow_statistics> p2p_node::block_sync_flows() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    block_sync_mutex_.lock_shared();
+    const auto block_sync = block_sync_.lock();
+    block_sync_mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (!block_sync)
+        return {};
+
+    return block_sync->flows();
+}
+
 // Subscriptions.
 // ----------------------------------------------------------------------------
 
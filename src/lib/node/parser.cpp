@@ -76,6 +76,22 @@ options_metadata parser::load_options()
             default_value(false)->zero_tokens(),
         "Initialize blockchain in the configured directory."
     )
+    (
+        "convert-transactions",
+        value<bool>(&configured.convert_transactions)->
+            default_value(false)->zero_tokens(),
+        "Rewrite the stored transactions in the form set by database.compress_transactions."
+    )
+    (
+        "export-blocks",
+        value<path>(&configured.export_blocks),
+        "Write all stored blocks to the given block file."
+    )
+    (
+        "import-blocks",
+        value<path>(&configured.import_blocks),
+        "Store the blocks of the given trusted block file above the stored top."
+    )
     (
         BN_SETTINGS_VARIABLE ",s",
         value<bool>(&configured.settings)->
@@ -139,6 +155,11 @@ options_metadata parser::load_settings()
         value<uint32_t>(&configured.network.threads),
         "The number of threads in the application threadpool, defaults to 50."
     )
+    (
+        "network.thread_shards",
+        value<uint32_t>(&configured.network.thread_shards),
+        "The number of single threaded shards that channels are pinned to, defaults to 0 (channels share the threadpool)."
+    )
     (
         "network.protocol",
         value<uint32_t>(&configured.network.protocol),
@@ -286,6 +307,21 @@ options_metadata parser::load_settings()
         value<path>(&configured.database.directory),
         "The blockchain database directory, defaults to 'mainnet'."
     )
+    (
+        "database.compress_transactions",
+        value<bool>(&configured.database.compress_transactions),
+        "Store transactions in compact form, defaults to false."
+    )
+    (
+        "database.deferred_indexes",
+        value<bool>(&configured.database.deferred_indexes),
+        "Index imported blocks in the background, defaults to false."
+    )
+    (
+        "database.warm_up",
+        value<bool>(&configured.database.warm_up),
+        "Read the hash table headers into memory on start, defaults to false."
+    )
 
     /* [blockchain] */
     (
@@ -330,10 +366,25 @@ options_metadata parser::load_settings()
         value<uint32_t>(&configured.node.download_connections),
         "The maximum number of connections for initial block download, defaults to 8."
     )
+    (
+        "node.download_staging_blocks",
+        value<uint32_t>(&configured.node.download_staging_blocks),
+        "The maximum distance in blocks that initial block download may run ahead of import, defaults to 1024."
+    )
+    (
+        "node.download_check_threads",
+        value<uint32_t>(&configured.node.download_check_threads),
+        "The number of threads checking staged blocks during initial block download, defaults to 4."
+    )
     (
         "node.transaction_pool_refresh",
         value<bool>(&configured.node.transaction_pool_refresh),
         "Refresh the transaction pool on reorganization and channel start, defaults to true."
+    )
+    (
+        "node.work_trace_sample",
+        value<uint32_t>(&configured.node.work_trace_sample),
+        "Trace the queue wait and run time of one in this many jobs of each work queue, defaults to 0 (disabled)."
     );
 
     return description;
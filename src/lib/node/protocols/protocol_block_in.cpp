@@ -409,6 +409,8 @@ void protocol_block_in::handle_store_block(const code& ec, block_ptr message)
         return;
     }
 
+    report_blocks(1);
+
     // The block is accepted as an orphan, possibly for immediate acceptance.
     log::trace(LOG_NODE)
         << "Potential block from [" << authority() << "].";
@@ -454,7 +456,7 @@ bool protocol_block_in::handle_reorganized(const code& ec, size_t fork_point,
 
     // Report the blocks that originated from this peer.
     // If originating peer is dropped there will be no report here.
-    for (const auto block: incoming)
+    for (const auto& block: incoming)
         if (block->originator() == nonce())
             log::trace(LOG_NODE)
                 << "Block [" << encode_hash(block->header.hash()) << "] from ["
@@ -44,6 +44,22 @@ using namespace std::placeholders;
 // for the exponential back-off algorithm.
 static constexpr auto locator_allowance = 12u;
 
+// A fetched block sent as a block message, the payload of which is the block
+// itself, so that serving a block does not copy it.
+struct block_reference
+{
+    static constexpr const char* command = "block";
+
+    data_chunk to_data(uint32_t) const
+    {
+        return block.to_data();
+    }
+
+    const chain::block& block;
+};
+
+constexpr const char* block_reference::command;
+
 protocol_block_out::protocol_block_out(p2p& network, channel::ptr channel,
     block_chain& blockchain)
   : protocol_events(network, channel, NAME),
@@ -355,8 +371,7 @@ void protocol_block_out::send_block(const code& ec, chain::block::ptr block,
         return;
     }
 
-    // TODO: eliminate copy.
-    SEND2(block_message(*block), handle_send, _1, block_message::command);
+    SEND2(block_reference{ *block }, handle_send, _1, block_message::command);
 }
 
 // TODO: move filtered_block to derived class protocol_block_out_70001.
@@ -422,7 +437,7 @@ bool protocol_block_out::handle_reorganized(const code& ec, size_t fork_point,
     {
         headers announcement;
 
-        for (const auto block: incoming)
+        for (const auto& block: incoming)
             if (block->originator() != nonce())
                 announcement.elements.push_back(block->header);
 
@@ -445,7 +460,7 @@ bool protocol_block_out::handle_reorganized(const code& ec, size_t fork_point,
     static const auto id = inventory::type_id::block;
     inventory announcement;
 
-    for (const auto block: incoming)
+    for (const auto& block: incoming)
         if (block->originator() != nonce())
             announcement.inventories.push_back( { id, block->header.hash() });
 
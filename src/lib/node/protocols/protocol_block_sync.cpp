@@ -55,6 +55,7 @@ protocol_block_sync::protocol_block_sync(p2p& network, channel::ptr channel,
 
 void protocol_block_sync::start(event_handler handler)
 {
+    reservation_->set_peer(authority());
     auto complete = synchronize(BIND2(blocks_complete, _1, handler), 1, NAME);
     protocol_timer::start(expiry_interval, BIND2(handle_event, _1, complete));
 
@@ -129,6 +130,7 @@ bool protocol_block_sync::handle_receive(const code& ec, block_ptr message,
 
     // Add the block to the blockchain store.
     reservation_->import(message);
+    report_blocks(1);
 
     if (reservation_->toggle_partitioned())
     {
@@ -185,6 +187,16 @@ void protocol_block_sync::handle_event(const code& ec, event_handler complete)
         complete(error::channel_timeout);
         return;
     }
+
+    // Request hashes that have since entered the import staging window,
+    // after moving those this peer failed to deliver in time to another.
+    if (ec.value() == error::channel_timeout)
+    {
+        reservation_->reissue_stalled();
+        send_get_blocks(complete, false);
+        return;
+    }
+
     complete(ec);
 }
 
@@ -24,6 +24,7 @@
 #include <cstddef>
 #include <functional>
 #include <metaverse/network.hpp>
+#include <metaverse/consensus/miner/MinerAux.h>
 #include <metaverse/node/p2p_node.hpp>
 #include <metaverse/node/utility/header_queue.hpp>
 
@@ -49,6 +50,7 @@ protocol_header_sync::protocol_header_sync(p2p& network,
     channel::ptr channel, header_queue& hashes, uint32_t minimum_rate,
     const checkpoint& last)
   : protocol_timer(network, channel, true, NAME),
+    verify_pool_(network.thread_pool()),
     hashes_(hashes),
     current_second_(0),
     minimum_rate_(minimum_rate),
@@ -133,13 +135,39 @@ bool protocol_header_sync::handle_receive(const code& ec, headers_ptr message,
         return false;
     }
 
+    // Proof of work is verified across the node threadpool, so that the
+    // channel thread is not held for the batch. Batches must be merged in
+    // the order received, so any other headers message is dropped until
+    // this one is merged and the subscription renewed.
+    const MinerAux::header_list_ptr elements(message, &message->elements);
+    MinerAux::verify_work(verify_pool_, elements,
+        BIND3(handle_verified, _1, message, complete));
+    return false;
+}
+
+void protocol_header_sync::handle_verified(size_t failed, headers_ptr message,
+    event_handler complete)
+{
+    if (stopped())
+        return;
+
+    if (failed < message->elements.size())
+    {
+        log::warning(LOG_NODE)
+            << "Invalid proof of work for header #"
+            << message->elements[failed].number << " from ["
+            << authority() << "]";
+        complete(error::proof_of_work);
+        return;
+    }
+
     // A merge failure includes automatic rollback to last trust point.
     if (!hashes_.enqueue(message))
     {
         log::warning(LOG_NODE)
             << "Failure merging headers from [" << authority() << "]";
         complete(error::previous_block_invalid);
-        return false;
+        return;
     }
 
     const auto next = next_height();
@@ -153,7 +181,7 @@ bool protocol_header_sync::handle_receive(const code& ec, headers_ptr message,
     {
         log::trace(LOG_NODE) << "protocol header sync handle receive complete";
         complete(error::success);
-        return false;
+        return;
     }
 
     // If we received fewer than 2000 the peer is exhausted, try another.
@@ -161,12 +189,12 @@ bool protocol_header_sync::handle_receive(const code& ec, headers_ptr message,
     {
         log::trace(LOG_NODE) << "protocol header sync handle receive message size < max header response";
         complete(error::operation_failed);
-        return false;
+        return;
     }
 
     // This peer has more headers.
+    SUBSCRIBE3(headers, handle_receive, _1, _2, complete);
     send_get_headers(complete);
-    return true;
 }
 
 // This is fired by the base timer and stop handler.
@@ -66,6 +66,11 @@ void session_block_sync::start(result_handler handler)
     session::start(CONCURRENT2(handle_started, _1, handler));
 }
 
+std::vector<reservation::flow_statistics> session_block_sync::flows() const
+{
+    return reservations_.flows();
+}
+
 void session_block_sync::handle_started(const code& ec, result_handler handler)
 {
     if (ec)
@@ -88,7 +93,8 @@ void session_block_sync::handle_started(const code& ec, result_handler handler)
         << "Getting blocks.";
     const auto connector = create_connector();
     reservations_count_ = table.size();
-    const auto complete = synchronize(handler, table.size(), NAME);
+    const auto complete = synchronize(
+        BIND2(handle_synchronized, _1, handler), table.size(), NAME);
     std::function<void(const code&)> func = complete;
     // This is the end of the start sequence.
     for (const auto row: table)
@@ -105,6 +111,14 @@ void session_block_sync::handle_started(const code& ec, result_handler handler)
 // Block sync sequence.
 // ----------------------------------------------------------------------------
 
+void session_block_sync::handle_synchronized(const code& ec,
+    result_handler handler)
+{
+    // Rows complete once their blocks are staged, wait for the import.
+    reservations_.flush();
+    handler(ec);
+}
+
 void session_block_sync::new_connection(connector::ptr connect,
     reservation::ptr row, result_handler handler)
 {
@@ -27,7 +27,10 @@ namespace node {
 settings::settings()
   : block_timeout_seconds(5),
     download_connections(8),
-    transaction_pool_refresh(true)
+    download_staging_blocks(1024),
+    download_check_threads(4),
+    transaction_pool_refresh(true),
+    work_trace_sample(0)
 {
 }
 
@@ -0,0 +1,298 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/node/utility/block_pipeline.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/consensus/miner/MinerAux.h>
+
+namespace libbitcoin {
+namespace node {
+
+using namespace bc::blockchain;
+using namespace bc::chain;
+
+#define NAME "block_pipeline"
+
+block_pipeline::block_pipeline(simple_chain& chain, size_t capacity,
+    size_t threads)
+  : chain_(chain),
+    pool_(std::max<size_t>(threads, 1)),
+    dispatch_(pool_, NAME),
+    capacity_(std::max<size_t>(capacity, 1)),
+    stopped_(false),
+    draining_(false),
+    checking_(0)
+{
+}
+
+block_pipeline::~block_pipeline()
+{
+    stop();
+    pool_.shutdown();
+    pool_.join();
+}
+
+void block_pipeline::set_reject_handler(reject_handler handler)
+{
+    scoped_lock lock(mutex_);
+    rejected_ = std::move(handler);
+}
+
+// Window.
+//-----------------------------------------------------------------------------
+
+void block_pipeline::expect(size_t height)
+{
+    scoped_lock lock(mutex_);
+    expected_.insert(height);
+}
+
+size_t block_pipeline::head() const
+{
+    return expected_.empty() ? max_size_t : *expected_.begin();
+}
+
+size_t block_pipeline::missing() const
+{
+    scoped_lock lock(mutex_);
+
+    for (const auto height: expected_)
+        if (staged_.find(height) == staged_.end())
+            return height;
+
+    return max_size_t;
+}
+
+size_t block_pipeline::limit() const
+{
+    scoped_lock lock(mutex_);
+    const auto first = head();
+    return first > max_size_t - capacity_ ? max_size_t : first + capacity_;
+}
+
+// Staging.
+//-----------------------------------------------------------------------------
+
+bool block_pipeline::stage(block::ptr block, size_t height)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    {
+        scoped_lock lock(mutex_);
+
+        if (stopped_)
+            return true;
+
+        // Not expected, already imported or a duplicate from another row.
+        if (expected_.find(height) == expected_.end() ||
+            staged_.find(height) != staged_.end())
+            return true;
+
+        // Bound the buffer by distance from the head, not by count, so that
+        // a slow head cannot be starved by blocks that will never drain.
+        if (height - head() >= capacity_)
+            return false;
+
+        staged_.emplace(height, entry{ block, false });
+        ++checking_;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    dispatch_.concurrent(&block_pipeline::do_check, this, block, height);
+    return true;
+}
+
+void block_pipeline::do_check(block::ptr block, size_t height)
+{
+    const auto ec = check(*block);
+    reject_handler rejected;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    {
+        scoped_lock lock(mutex_);
+        --checking_;
+
+        const auto it = staged_.find(height);
+        if (it != staged_.end())
+        {
+            if (ec)
+            {
+                // The height remains expected and must be downloaded again.
+                staged_.erase(it);
+                rejected = rejected_;
+            }
+            else
+            {
+                it->second.checked = true;
+            }
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (ec)
+    {
+        const auto hash = block->header.hash();
+        log::warning(LOG_NODE)
+            << "Rejected staged block #" << height << " ["
+            << encode_hash(hash) << "] " << ec.message();
+
+        if (rejected)
+            rejected(hash, height);
+    }
+
+    drain();
+    idle_.notify_all();
+}
+
+bool block_pipeline::importable() const
+{
+    if (stopped_ || staged_.empty())
+        return false;
+
+    const auto& first = *staged_.begin();
+    return first.first == head() && first.second.checked;
+}
+
+void block_pipeline::drain()
+{
+    while (true)
+    {
+        block::ptr block;
+        size_t height;
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        {
+            scoped_lock lock(mutex_);
+
+            // Another thread is importing and will continue past this block.
+            if (draining_ || !importable())
+                return;
+
+            const auto it = staged_.begin();
+            height = it->first;
+            block = it->second.block;
+            staged_.erase(it);
+            expected_.erase(height);
+            draining_ = true;
+        }
+        ///////////////////////////////////////////////////////////////////////
+
+        // The import is the connect stage and is strictly height ordered.
+        const auto imported = chain_.import(block, height);
+
+        if (imported)
+            log::info(LOG_NODE)
+                << "Imported block #" << height << " ["
+                << encode_hash(block->header.hash()) << "]";
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        {
+            scoped_lock lock(mutex_);
+            draining_ = false;
+            stopped_ = stopped_ || !imported;
+        }
+        ///////////////////////////////////////////////////////////////////////
+
+        idle_.notify_all();
+
+        if (!imported)
+            return;
+    }
+}
+
+void block_pipeline::flush()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    boost::unique_lock<unique_mutex> lock(mutex_);
+
+    while (checking_ > 0 || draining_ || importable())
+        idle_.wait(lock);
+
+    // Sync is over, so these are left to the block inventory protocol.
+    if (!staged_.empty())
+        log::warning(LOG_NODE)
+            << "Discarding " << staged_.size() << " staged blocks #"
+            << staged_.begin()->first << "-#" << staged_.rbegin()->first
+            << " waiting on missing block #" << head() << ".";
+
+    staged_.clear();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void block_pipeline::stop()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    {
+        scoped_lock lock(mutex_);
+        stopped_ = true;
+        staged_.clear();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    idle_.notify_all();
+}
+
+// Checks.
+//-----------------------------------------------------------------------------
+
+// These are the checks of validate_block::check_block that need no chain
+// state, so they can run on any thread while the block waits for its turn.
+code block_pipeline::check(const block& block)
+{
+    const auto& transactions = block.transactions;
+
+    if (transactions.empty() ||
+        block.serialized_size() > blockchain::max_block_size)
+        return error::size_limits;
+
+    if (!transactions.front().is_coinbase())
+        return error::first_not_coinbase;
+
+    if (block.header.merkle != block::generate_merkle_root(transactions))
+        return error::merkle_mismatch;
+
+    // Transaction hashes are cached by the merkle computation above.
+    std::vector<hash_digest> hashes;
+    hashes.reserve(transactions.size());
+    for (const auto& tx: transactions)
+        hashes.push_back(tx.hash());
+
+    std::sort(hashes.begin(), hashes.end());
+    if (std::adjacent_find(hashes.begin(), hashes.end()) != hashes.end())
+        return error::duplicate;
+
+    if (block.header.is_proof_of_work() &&
+        !MinerAux::verify_work(block.header, nullptr))
+        return error::proof_of_work;
+
+    return error::success;
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -19,10 +19,12 @@
  */
 #include <metaverse/node/utility/reservation.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <string>
 #include <utility>
 #include <boost/format.hpp>
 #include <metaverse/bitcoin.hpp>
@@ -49,12 +51,26 @@ static constexpr size_t minimum_history = 3;
 // Simple conversion factor, since we trace in micro and report in seconds.
 static constexpr size_t micro_per_second = 1000 * 1000;
 
+// The bounds and starting size of the window of blocks in flight per row.
+static constexpr size_t minimum_window = 2;
+static constexpr size_t initial_window = 16;
+static constexpr size_t maximum_window = 500;
+
+// A request is stalled once outstanding for this many smoothed round trips,
+// but never before the minimum deadline.
+static constexpr uint64_t stall_round_trips = 4;
+static constexpr uint64_t minimum_deadline = micro_per_second;
+
 reservation::reservation(reservations& reservations, size_t slot,
     uint32_t block_timeout_seconds)
   : rate_({ true, 0, 0, 0 }),
     stopped_(false),
     pending_(true),
     partitioned_(false),
+    window_(initial_window),
+    round_trip_(0),
+    minimum_round_trip_(0),
+    reissued_(0),
     reservations_(reservations),
     slot_(slot),
     rate_window_(minimum_history * block_timeout_seconds * micro_per_second)
@@ -133,6 +149,48 @@ performance reservation::rate() const
     ///////////////////////////////////////////////////////////////////////////
 }
 
+void reservation::set_peer(const config::authority& peer)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(rate_mutex_);
+
+    peer_ = peer.to_string();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+std::string reservation::peer() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(rate_mutex_);
+
+    return peer_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+reservation::flow_statistics reservation::flow() const
+{
+    const auto record = rate();
+    flow_statistics statistics
+    {
+        slot_, peer(), 0, 0, 0, 0,
+        record.idle ? 0.0 : record.total() * micro_per_second, 0
+    };
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(hash_mutex_);
+
+    statistics.window = window_;
+    statistics.in_flight = requested_.size();
+    statistics.remaining = heights_.size();
+    statistics.round_trip = round_trip_;
+    statistics.reissued = reissued_;
+    return statistics;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 // Ignore idleness here, called only from an active channel, avoiding a race.
 bool reservation::expired() const
 {
@@ -270,6 +328,9 @@ message::get_data reservation::request(bool new_channel)
     if (new_channel)
         reset();
 
+    // Blocks beyond the staging window would be refused on arrival.
+    const auto limit = reservations_.import_limit();
+
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
     hash_mutex_.lock_upgrade();
@@ -281,18 +342,41 @@ message::get_data reservation::request(bool new_channel)
         return packet;
     }
 
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    hash_mutex_.unlock_upgrade_and_lock();
+
+    // A new channel has nothing in flight and no measured round trip.
+    if (new_channel)
+    {
+        requested_.clear();
+        window_ = initial_window;
+        round_trip_ = 0;
+        minimum_round_trip_ = 0;
+    }
+
+    auto deferred = false;
+    const auto time = now();
+
     // Build get_blocks request message.
     for (auto height = heights_.right.begin(); height != heights_.right.end();
         ++height)
     {
+        if (height->first >= limit || requested_.size() >= window_)
+        {
+            deferred = true;
+            break;
+        }
+
+        if (!requested_.emplace(height->first, time).second)
+            continue;
+
         static const auto id = message::inventory::type_id::block;
         const message::inventory_vector inventory{ id, height->second };
         packet.inventories.emplace_back(inventory);
     }
 
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    hash_mutex_.unlock_upgrade_and_lock();
-    pending_ = false;
+    // Keep pending so the remainder is requested as either window advances.
+    pending_ = deferred;
     hash_mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
@@ -314,10 +398,31 @@ void reservation::insert(const hash_digest& hash, size_t height)
     unique_lock lock(hash_mutex_);
 
     pending_ = true;
+    requested_.erase(height32);
     heights_.insert({ hash, height32 });
     ///////////////////////////////////////////////////////////////////////////
 }
 
+bool reservation::extract(size_t height, hash_digest& out_hash)
+{
+    BITCOIN_ASSERT(height <= max_uint32);
+    const auto height32 = static_cast<uint32_t>(height);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(hash_mutex_);
+
+    const auto it = heights_.right.find(height32);
+    if (it == heights_.right.end())
+        return false;
+
+    out_hash = it->second;
+    heights_.right.erase(it);
+    requested_.erase(height32);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 void reservation::import(block::ptr block)
 {
     uint32_t height;
@@ -338,7 +443,7 @@ void reservation::import(block::ptr block)
         success = reservations_.import(block, height);
     };
 
-    // Do the block import with timer.
+    // Do the block staging with timer.
     const auto cost = timer<microseconds>::duration(importer);
 
     if (success)
@@ -347,17 +452,22 @@ void reservation::import(block::ptr block)
         update_rate(unit_size, cost);
         const auto record = rate();
         static const auto formatter =
-            "Imported block #%06i (%02i) [%s] %06.2f %05.2f%%";
+            "Staged block #%06i (%02i) [%s] %06.2f %05.2f%%";
 
-        log::info(LOG_NODE)
+        log::debug(LOG_NODE)
             << boost::format(formatter) % height % slot() % encoded %
             (record.total() * micro_per_second) % (record.ratio() * 100);
     }
     else
     {
+        // The import is stalled on a lower block, keep this one for later
+        // and take over the missing height from whichever row is lagging.
         log::debug(LOG_NODE)
-            << "Stopped before importing block (" << slot() << ") ["
+            << "Deferred block #" << height << " (" << slot() << ") ["
             << encoded << "]";
+
+        insert(hash, height);
+        reservations_.expedite(shared_from_this());
     }
 
     populate();
@@ -429,6 +539,7 @@ bool reservation::partition(reservation::ptr minimal)
     // TODO: move the range in a single command.
     for (size_t index = 0; index < offset; ++index)
     {
+        requested_.erase(it->first);
         minimal->heights_.right.insert(std::move(*it));
         it = heights_.right.erase(it);
     }
@@ -459,6 +570,109 @@ bool reservation::partition(reservation::ptr minimal)
     return populated;
 }
 
+// private, call under exclusive hash lock.
+// The window follows twice the bandwidth delay product, taking the rate from
+// the import history and the delay from the fastest round trip seen, since
+// later blocks of a batch also wait behind the earlier ones.
+void reservation::adapt_window(const microseconds& round_trip)
+{
+    const auto sample = static_cast<uint64_t>(round_trip.count());
+    round_trip_ = round_trip_ == 0 ? sample : (7 * round_trip_ + sample) / 8;
+    minimum_round_trip_ = minimum_round_trip_ == 0 ? sample :
+        std::min(minimum_round_trip_, sample);
+
+    const auto record = rate();
+
+    // Without a rate yet grow by one per block, doubling each round trip.
+    if (record.idle)
+    {
+        window_ = std::min(window_ + 1, maximum_window);
+        return;
+    }
+
+    const auto product = record.normal() * minimum_round_trip_;
+    const auto target = static_cast<size_t>(std::min(std::ceil(2 * product),
+        static_cast<double>(maximum_window)));
+
+    window_ = std::max(minimum_window,
+        std::min(maximum_window, (window_ + target + 1) / 2));
+}
+
+// private, call under hash lock.
+microseconds reservation::stall_deadline() const
+{
+    if (round_trip_ == 0)
+        return rate_window();
+
+    const auto deadline = std::max(stall_round_trips * round_trip_,
+        minimum_deadline);
+
+    return std::min(microseconds(deadline), rate_window());
+}
+
+// private
+config::checkpoint::list reservation::release_stalled()
+{
+    config::checkpoint::list stalled;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(hash_mutex_);
+
+    const auto cutoff = now() - stall_deadline();
+
+    for (auto it = requested_.begin(); it != requested_.end();)
+    {
+        if (it->second >= cutoff)
+        {
+            ++it;
+            continue;
+        }
+
+        const auto height = heights_.right.find(it->first);
+        if (height != heights_.right.end())
+        {
+            stalled.emplace_back(height->second, height->first);
+            heights_.right.erase(height);
+        }
+
+        it = requested_.erase(it);
+    }
+
+    if (!stalled.empty())
+    {
+        window_ = std::max(minimum_window, window_ / 2);
+        reissued_ += stalled.size();
+    }
+
+    return stalled;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t reservation::window() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(hash_mutex_);
+
+    return window_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void reservation::reissue_stalled()
+{
+    const auto stalled = release_stalled();
+    if (stalled.empty())
+        return;
+
+    log::debug(LOG_NODE)
+        << "Reissuing " << stalled.size() << " stalled blocks from slot ("
+        << slot() << ") [" << peer() << "].";
+
+    reservations_.reissue(shared_from_this(), stalled);
+    populate();
+}
+
 bool reservation::find_height_and_erase(const hash_digest& hash,
     uint32_t& out_height)
 {
@@ -479,7 +693,18 @@ bool reservation::find_height_and_erase(const hash_digest& hash,
 
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     hash_mutex_.unlock_upgrade_and_lock();
+
+    const auto request = requested_.find(out_height);
+    if (request != requested_.end())
+    {
+        adapt_window(duration_cast<microseconds>(now() - request->second));
+        requested_.erase(request);
+    }
+
     heights_.left.erase(it);
+
+    // The block frees a place in the window.
+    pending_ = pending_ || heights_.size() > requested_.size();
     hash_mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
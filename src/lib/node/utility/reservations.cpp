@@ -36,6 +36,7 @@ namespace node {
 
 using namespace bc::blockchain;
 using namespace bc::chain;
+using namespace std::placeholders;
 
 // The protocol maximum size of get data block requests.
 static constexpr size_t max_block_request = 50000;
@@ -45,15 +46,148 @@ reservations::reservations(header_queue& hashes, simple_chain& chain,
   : hashes_(hashes),
     blockchain_(chain),
     max_request_(max_block_request),
-    timeout_(settings.block_timeout_seconds)
+    timeout_(settings.block_timeout_seconds),
+    pipeline_(chain, settings.download_staging_blocks,
+        settings.download_check_threads)
 {
+    pipeline_.set_reject_handler(
+        std::bind(&reservations::reject, this, _1, _2));
+
     initialize(settings.download_connections);
 }
 
 bool reservations::import(block::ptr block, size_t height)
 {
     // Thread safe.
-    return blockchain_.import(block, height);
+    return pipeline_.stage(block, height);
+}
+
+size_t reservations::import_limit() const
+{
+    // Thread safe.
+    return pipeline_.limit();
+}
+
+void reservations::flush()
+{
+    // Thread safe.
+    pipeline_.flush();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (!rejected_.empty())
+        log::warning(LOG_NODE)
+            << "Block sync completed without " << rejected_.size()
+            << " rejected blocks from #" << rejected_.front().height()
+            << ", they are left to the block inventory protocol.";
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The row that holds the missing height is lagging, so let this row fetch it.
+bool reservations::expedite(reservation::ptr row)
+{
+    const auto height = pipeline_.missing();
+    if (height == max_size_t)
+        return false;
+
+    hash_digest hash;
+    for (const auto& other: table())
+    {
+        if (other == row || !other->extract(height, hash))
+            continue;
+
+        row->insert(hash, height);
+        log::debug(LOG_NODE)
+            << "Moved lagging block #" << height << " from slot ("
+            << other->slot() << ") to (" << row->slot() << ").";
+        return true;
+    }
+
+    return false;
+}
+
+void reservations::reissue(reservation::ptr row,
+    const config::checkpoint::list& blocks)
+{
+    reservation::ptr fastest;
+    auto fastest_rate = 0.0;
+
+    for (const auto& other: table())
+    {
+        if (other == row || other->stopped() || other->idle())
+            continue;
+
+        const auto rate = other->rate().normal();
+        if (!fastest || rate > fastest_rate)
+        {
+            fastest = other;
+            fastest_rate = rate;
+        }
+    }
+
+    // With no other active row the blocks are requested again from the same.
+    const auto target = fastest ? fastest : row;
+    for (const auto& block: blocks)
+        target->insert(block);
+
+    log::debug(LOG_NODE)
+        << "Moved " << blocks.size() << " stalled blocks from slot ("
+        << row->slot() << ") to (" << target->slot() << ").";
+}
+
+std::vector<reservation::flow_statistics> reservations::flows() const
+{
+    std::vector<reservation::flow_statistics> out;
+    for (const auto& row: table())
+        out.push_back(row->flow());
+
+    return out;
+}
+
+void reservations::reject(const hash_digest& hash, size_t height)
+{
+    const auto rows = table();
+    reservation::ptr minimal;
+
+    for (const auto& row: rows)
+        if (!row->stopped() && (!minimal || row->size() < minimal->size()))
+            minimal = row;
+
+    if (!minimal)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        unique_lock lock(mutex_);
+
+        // The height stays expected, so the next row to populate takes it.
+        rejected_.emplace_back(hash, height);
+        ///////////////////////////////////////////////////////////////////////
+
+        log::debug(LOG_NODE)
+            << "No active slot to download block #" << height
+            << " again, deferred to the next populated slot.";
+        return;
+    }
+
+    minimal->insert(hash, height);
+}
+
+// Call under the table mutex.
+void reservations::reclaim(reservation::ptr minimal)
+{
+    if (rejected_.empty())
+        return;
+
+    for (const auto& block: rejected_)
+        minimal->insert(block);
+
+    log::debug(LOG_NODE)
+        << "Reclaimed " << rejected_.size() << " rejected blocks to slot ("
+        << minimal->slot() << ").";
+
+    rejected_.clear();
 }
 
 // Rate methods.
@@ -195,6 +329,7 @@ void reservations::initialize(size_t size)
             if (hashes_.valid(hash))
             {
                 ++count;
+                pipeline_.expect(height);
                 table_[row]->insert(hash, height);
             }
         }
@@ -215,7 +350,9 @@ bool reservations::populate(reservation::ptr minimal)
     ///////////////////////////////////////////////////////////////////////////
     mutex_.lock();
 
-    // Take from unallocated or allocated hashes, true if minimal not empty.
+    // Take rejected blocks first, then unallocated or allocated hashes.
+    // True if minimal is not empty.
+    reclaim(minimal);
     const auto populated = reserve(minimal) || partition(minimal);
 
     mutex_.unlock();
@@ -266,7 +403,10 @@ bool reservations::reserve(reservation::ptr minimal)
         hashes_.dequeue(hash, height);
 
         if (hashes_.valid(hash))
+        {
+            pipeline_.expect(height);
             minimal->insert(hash, height);
+        }
     }
 
     // This may become empty between insert and this test, which is okay.
@@ -34,6 +34,7 @@
 #include <metaverse/macros_define.hpp>
 #include <metaverse/bitcoin/utility/backtrace.hpp>
 #include <metaverse/bitcoin/utility/path.hpp>
+#include <metaverse/database/block_file.hpp>
 
 namespace libbitcoin {
 namespace server {
@@ -144,6 +145,14 @@ bool executor::do_initchain()
         return true;
     }
     else {
+        // The stealth columns are converted first, as the other upgrades
+        // start the whole store, which requires them.
+        if (MVS_DATABASE_VERSION_NUMBER >= 68) {
+            if (!data_base::upgrade_version_68(data_path)) {
+                throw std::runtime_error{ " upgrade database to version 68 failed!" };
+            }
+        }
+
         if (MVS_DATABASE_VERSION_NUMBER >= 63) {
             if (!data_base::upgrade_version_63(data_path)) {
                 throw std::runtime_error{ " upgrade database to version 63 failed!" };
@@ -155,6 +164,37 @@ bool executor::do_initchain()
                 throw std::runtime_error{ " upgrade database to version 63 failed!" };
             }
         }
+
+        if (MVS_DATABASE_VERSION_NUMBER >= 65) {
+            if (!data_base::upgrade_version_65(data_path,
+                metadata_.configured.database.history_start_height)) {
+                throw std::runtime_error{ " upgrade database to version 65 failed!" };
+            }
+        }
+
+        if (MVS_DATABASE_VERSION_NUMBER >= 66) {
+            if (!data_base::upgrade_version_66(data_path,
+                metadata_.configured.database.history_start_height)) {
+                throw std::runtime_error{ " upgrade database to version 66 failed!" };
+            }
+        }
+
+        if (MVS_DATABASE_VERSION_NUMBER >= 67) {
+            if (!data_base::upgrade_version_67(data_path)) {
+                throw std::runtime_error{ " upgrade database to version 67 failed!" };
+            }
+        }
+
+        // Finish indexing the blocks of an interrupted import, unless the
+        // indexer is to resume it in the background.
+        if (!metadata_.configured.database.deferred_indexes &&
+            exists(data_base::store(data_path).index_height)) {
+            data_base database(metadata_.configured.database);
+            if (!database.start() || !database.build_indexes() ||
+                !database.stop()) {
+                throw std::runtime_error{ " build database indexes failed!" };
+            }
+        }
     }
 
     if (ec.value() == directory_exists)
@@ -216,6 +256,21 @@ bool executor::menu()
         {
             return result;
         }
+
+        if (config.convert_transactions)
+        {
+            const auto& database = metadata_.configured.database;
+            return data_base::convert_transactions(database.directory,
+                database.compress_transactions);
+        }
+
+        if (!config.export_blocks.empty())
+            return block_file::export_blocks(metadata_.configured.database,
+                config.export_blocks);
+
+        if (!config.import_blocks.empty())
+            return block_file::import_blocks(metadata_.configured.database,
+                config.import_blocks);
     }
     catch(const std::exception& e){ // initialize failed
         //log::error(LOG_SERVER) << format(BS_INITCHAIN_EXISTS) % data_path;
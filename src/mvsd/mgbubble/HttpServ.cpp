@@ -136,6 +136,31 @@ void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_vers
     out_.setContentLength();
 }
 
+void HttpServ::metrics_request(mg_connection& nc, HttpMessage data)
+{
+    reset(data);
+    StreamBuf buf{ nc.send_mbuf };
+    out_.rdbuf(&buf);
+
+    try {
+        check_rpc_client_addresses(nc);
+
+        if (!isSet(MethodGet)) {
+            out_.reset(405, "Method Not Allowed");
+        }
+        else {
+            // Prometheus text exposition format.
+            out_.reset(200, "OK", "text/plain; version=0.0.4");
+            out_ << metrics::instance().to_prometheus();
+        }
+    }
+    catch (const std::exception& e) {
+        out_.reset(403, "Forbidden");
+        out_ << e.what();
+    }
+    out_.setContentLength();
+}
+
 void HttpServ::ws_request(mg_connection& nc, WebsocketMessage ws)
 {
     Json::Value jv_output;
@@ -205,6 +230,9 @@ void HttpServ::on_http_req_handler(struct mg_connection& nc, http_message& msg)
     if (api_version > 0) {
         rpc_request(nc, HttpMessage(&msg), api_version);
     }
+    else if ((msg.uri.len == 8) && (mg_ncasecmp(msg.uri.p, "/metrics", 8) == 0)) {
+        metrics_request(nc, HttpMessage(&msg));
+    }
     else {
         std::shared_ptr<struct mg_connection> con(&nc, [](struct mg_connection * ptr) { (void)(ptr); });
         serve_http_static(nc, msg);
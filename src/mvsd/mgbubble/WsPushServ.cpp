@@ -128,7 +128,7 @@ void WsPushServ::notify_blocks(uint32_t fork_point, const block_list& blocks)
 
     //auto height = fork_point;
 
-    for (const auto block : blocks)
+    for (const auto& block : blocks)
         notify_block(block.get()->header.number, block);
 }
 
@@ -200,7 +200,7 @@ void block_service::publish_blocks(uint32_t fork_point,
     BITCOIN_ASSERT(fork_point < max_uint32 - blocks.size());
     auto height = fork_point;
 
-    for (const auto block: blocks)
+    for (const auto& block: blocks)
         publish_block(publisher, height++, block);
 }
 
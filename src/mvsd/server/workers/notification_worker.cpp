@@ -514,7 +514,7 @@ void notification_worker::notify_blocks(uint32_t fork_point,
     BITCOIN_ASSERT(fork_point < max_uint32 - blocks.size());
     auto height = fork_point;
 
-    for (const auto block: blocks)
+    for (const auto& block: blocks)
         notify_block(publisher, height++, block);
 }
 
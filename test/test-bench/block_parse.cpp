@@ -0,0 +1,196 @@
+/**
+ * Copyright (c) 2016-2020 mvs developers
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measures block parse throughput and heap allocations per block.
+//
+// Input is a text file with one hex encoded block per line, for example
+// collected from a synced node with:
+//
+//   for h in $(seq 1000000 1001000); do mvs-cli getblock $h --json=false; done
+//
+// Anything around the hex (json quoting, "raw" keys) is ignored.
+//
+// usage: block-parse-bench <blocks.hex> [rounds]
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+
+using namespace libbitcoin;
+
+static std::atomic<uint64_t> allocations{ 0 };
+static std::atomic<uint64_t> allocated_bytes{ 0 };
+
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (auto block = std::malloc(size == 0 ? 1 : size))
+        return block;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept
+{
+    std::free(block);
+}
+
+static std::string longest_hex_run(const std::string& line)
+{
+    size_t best_begin = 0, best_size = 0;
+
+    for (size_t at = 0; at < line.size();)
+    {
+        auto end = at;
+        while (end < line.size() && std::isxdigit(
+            static_cast<unsigned char>(line[end])))
+            ++end;
+
+        if (end - at > best_size)
+        {
+            best_begin = at;
+            best_size = end - at;
+        }
+
+        at = end + 1;
+    }
+
+    return line.substr(best_begin, best_size);
+}
+
+static std::vector<data_chunk> load_blocks(const std::string& path)
+{
+    std::vector<data_chunk> blocks;
+    std::ifstream file(path);
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        data_chunk raw;
+        const auto hex = longest_hex_run(line);
+        if (!hex.empty() && decode_base16(raw, hex))
+            blocks.push_back(std::move(raw));
+    }
+
+    return blocks;
+}
+
+struct sample
+{
+    uint64_t blocks = 0;
+    uint64_t transactions = 0;
+    uint64_t bytes = 0;
+    uint64_t allocations = 0;
+    uint64_t allocated_bytes = 0;
+    double seconds = 0;
+};
+
+static bool run(const std::vector<data_chunk>& blocks, bool hash, sample& out)
+{
+    typedef std::chrono::steady_clock clock;
+
+    const auto start_allocations = allocations.load();
+    const auto start_bytes = allocated_bytes.load();
+    const auto start = clock::now();
+
+    for (const auto& raw: blocks)
+    {
+        chain::block block;
+        if (!block.from_data(raw))
+            return false;
+
+        if (hash)
+            for (const auto& tx: block.transactions)
+                tx.hash();
+
+        out.transactions += block.transactions.size();
+        out.bytes += raw.size();
+        ++out.blocks;
+    }
+
+    out.seconds += std::chrono::duration<double>(clock::now() - start).count();
+    out.allocations += allocations.load() - start_allocations;
+    out.allocated_bytes += allocated_bytes.load() - start_bytes;
+    return true;
+}
+
+static void report(const std::string& name, const sample& value)
+{
+    const auto blocks = static_cast<double>(std::max<uint64_t>(value.blocks, 1));
+    const auto txs = static_cast<double>(std::max<uint64_t>(value.transactions, 1));
+
+    std::cout << name
+        << ": " << value.blocks / value.seconds << " blocks/s"
+        << ", " << value.bytes / value.seconds / (1024 * 1024) << " MiB/s"
+        << ", " << value.allocations / blocks << " allocs/block"
+        << ", " << value.allocations / txs << " allocs/tx"
+        << ", " << value.allocated_bytes / blocks << " alloc bytes/block"
+        << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <blocks.hex> [rounds]"
+            << std::endl;
+        return 1;
+    }
+
+    const auto rounds = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+    const auto blocks = load_blocks(argv[1]);
+
+    if (blocks.empty())
+    {
+        std::cerr << "no blocks found in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    sample parse, parse_hash;
+    for (auto round = 0; round < rounds; ++round)
+    {
+        if (!run(blocks, false, parse) || !run(blocks, true, parse_hash))
+        {
+            std::cerr << "failed to parse block" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << blocks.size() << " blocks x " << rounds << " rounds"
+        << std::endl;
+    report("parse", parse);
+    report("parse+hash", parse_hash);
+    return 0;
+}
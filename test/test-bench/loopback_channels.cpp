@@ -0,0 +1,192 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Load test of the network stack over loopback: connects channels to a local
+// acceptor and keeps a ping in flight on each, reporting round trips per
+// second. Run with zero shards for the shared threadpool and with one shard
+// per core to pin each channel (both of its ends) to a single thread.
+//
+// usage: loopback-channels-bench [connections] [shards] [seconds] [port]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/network/acceptor.hpp>
+#include <metaverse/network/channel.hpp>
+#include <metaverse/network/connector.hpp>
+#include <metaverse/network/settings.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::message;
+using namespace libbitcoin::network;
+
+static std::atomic<uint64_t> round_trips(0);
+static std::atomic<size_t> connected(0);
+static std::atomic<bool> running(true);
+static std::mutex channels_mutex;
+static std::vector<channel::ptr> channels;
+
+static void keep(channel::ptr node)
+{
+    std::lock_guard<std::mutex> lock(channels_mutex);
+    channels.push_back(node);
+}
+
+// The accepting end answers every ping.
+static void serve(channel::ptr node)
+{
+    node->start([node](const code& ec)
+    {
+        if (ec)
+            return;
+
+        node->subscribe<ping>([node](const code& ec, ping::ptr message)
+        {
+            if (ec)
+                return false;
+
+            pong reply;
+            reply.nonce = message->nonce;
+            node->send(reply, [](const code&) {});
+            return true;
+        });
+    });
+
+    keep(node);
+}
+
+// The connecting end sends the next ping as each pong arrives.
+static void drive(channel::ptr node)
+{
+    node->start([node](const code& ec)
+    {
+        if (ec)
+            return;
+
+        node->subscribe<pong>([node](const code& ec, pong::ptr message)
+        {
+            if (ec || !running)
+                return false;
+
+            ++round_trips;
+            node->send(ping(message->nonce + 1), [](const code&) {});
+            return true;
+        });
+
+        ++connected;
+        node->send(ping(0), [](const code&) {});
+    });
+
+    keep(node);
+}
+
+static void accept_next(acceptor::ptr listener)
+{
+    listener->accept([listener](const code& ec, channel::ptr node)
+    {
+        if (ec)
+            return;
+
+        serve(node);
+        accept_next(listener);
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t connections = argc > 1 ? std::max(1, std::atoi(argv[1])) :
+        256;
+    const size_t shards = argc > 2 ? std::max(0, std::atoi(argv[2])) :
+        std::max(1u, std::thread::hardware_concurrency());
+    const auto seconds = argc > 3 ? std::max(1, std::atoi(argv[3])) : 10;
+    const auto port = static_cast<uint16_t>(argc > 4 ?
+        std::atoi(argv[4]) : 15999);
+
+    network::settings configuration;
+    configuration.identifier = 0x6d73766d;
+    configuration.inbound_port = port;
+    configuration.use_ipv6 = false;
+    configuration.connect_timeout_seconds = 30;
+
+    threadpool pool(std::max(1u, std::thread::hardware_concurrency()));
+    pool.spawn_shards(shards);
+
+    const auto listener = std::make_shared<acceptor>(pool, configuration);
+    code result;
+    listener->listen(port, [&result](const code& ec) { result = ec; });
+
+    if (result)
+    {
+        std::cerr << "listen failed: " << result.message() << std::endl;
+        return 1;
+    }
+
+    accept_next(listener);
+
+    const auto dialer = std::make_shared<connector>(pool, configuration);
+    for (size_t index = 0; index < connections; ++index)
+        dialer->connect("127.0.0.1", port, [](const code& ec,
+            channel::ptr node)
+        {
+            if (!ec)
+                drive(node);
+        });
+
+    typedef std::chrono::steady_clock clock;
+    const auto deadline = clock::now() + std::chrono::seconds(30);
+    while (connected < connections && clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    std::cout << connected << " connections, " << shards << " shards"
+        << std::endl;
+
+    const auto from = round_trips.load();
+    const auto start = clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    const auto count = round_trips.load() - from;
+    const auto elapsed = std::chrono::duration<double>(clock::now() -
+        start).count();
+
+    std::cout << uint64_t(count / elapsed) << " round trips/s" << std::endl;
+
+    running = false;
+    listener->stop();
+    dialer->stop();
+
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex);
+        for (const auto& node: channels)
+            node->stop(error::service_stopped);
+
+        channels.clear();
+    }
+
+    pool.shutdown();
+    pool.join();
+    return connected == connections ? 0 : 1;
+}
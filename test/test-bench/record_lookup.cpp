@@ -0,0 +1,198 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measures hash table lookup throughput through memory_map, first alone and
+// then concurrently with a writer that keeps growing the file. Build once as
+// is (remap safety) and once with ENABLE_RESERVED_MAPPING to compare.
+//
+// usage: record-lookup-bench <directory> [records] [threads]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/record_hash_table.hpp>
+#include <metaverse/database/primitives/record_manager.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::database;
+
+typedef record_hash_table<hash_digest> record_map;
+
+static const size_t buckets = 1 << 20;
+static const size_t header_size = record_hash_table_header_size(buckets);
+static const size_t value_size = sizeof(uint64_t);
+static const size_t record_size = hash_table_record_size<hash_digest>(
+    value_size);
+
+static hash_digest key(uint64_t value)
+{
+    return sha256_hash(to_chunk(to_little_endian(value)));
+}
+
+static void store(record_map& map, record_manager& manager, uint64_t value)
+{
+    const auto write = [value](memory_ptr data)
+    {
+        auto serial = make_serializer(REMAP_ADDRESS(data));
+        serial.write_8_bytes_little_endian(value);
+    };
+
+    map.store(key(value), write);
+    manager.sync();
+}
+
+// Look up every stored key from a different starting point, returning the
+// number found.
+static uint64_t lookup(const record_map& map, uint64_t records, uint64_t from)
+{
+    uint64_t found = 0;
+
+    for (uint64_t index = 0; index < records; ++index)
+    {
+        const auto memory = map.find(key((from + index) % records));
+        if (memory)
+            found += from_little_endian_unsafe<uint64_t>(
+                REMAP_ADDRESS(memory)) < records ? 1 : 0;
+    }
+
+    return found;
+}
+
+static double run(const record_map& map, uint64_t records, size_t threads,
+    uint64_t& out_found)
+{
+    typedef std::chrono::steady_clock clock;
+
+    std::atomic<uint64_t> found(0);
+    std::vector<std::thread> readers;
+    const auto start = clock::now();
+
+    for (size_t thread = 0; thread < threads; ++thread)
+        readers.emplace_back([&, thread]()
+        {
+            found += lookup(map, records, records * thread / threads);
+        });
+
+    for (auto& reader: readers)
+        reader.join();
+
+    out_found = found;
+    return std::chrono::duration<double>(clock::now() - start).count();
+}
+
+static void report(const std::string& name, uint64_t lookups,
+    double seconds)
+{
+    std::cout << name << ": " << uint64_t(lookups / seconds)
+        << " lookups/s" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0]
+            << " <directory> [records] [threads]" << std::endl;
+        return 1;
+    }
+
+    const uint64_t records = argc > 2 ?
+        std::max(1, std::atoi(argv[2])) : 1000000;
+    const size_t threads = argc > 3 ? std::max(1, std::atoi(argv[3])) :
+        std::max(1u, std::thread::hardware_concurrency());
+
+    const auto file = boost::filesystem::path(argv[1]) / "record_lookup_bench";
+    if (!data_base::touch_file(file))
+    {
+        std::cerr << "failed to create " << file << std::endl;
+        return 1;
+    }
+
+    uint64_t found = 0;
+    double seconds = 0;
+
+    {
+        memory_map map_file(file);
+        record_hash_table_header header(map_file, buckets);
+        record_manager manager(map_file, header_size, record_size);
+        record_map map(header, manager);
+
+        if (!map_file.start())
+            return 1;
+
+        map_file.resize(header_size + minimum_records_size);
+        if (!header.create() || !manager.create() || !header.start() ||
+            !manager.start())
+            return 1;
+
+        for (uint64_t value = 0; value < records; ++value)
+            store(map, manager, value);
+
+#ifdef RESERVED_MAPPING
+        std::cout << "reserved mapping, ";
+#else
+        std::cout << "remap safety, ";
+#endif
+        std::cout << records << " records, " << threads << " threads"
+            << std::endl;
+
+        seconds = run(map, records, 1, found);
+        report("single", records, seconds);
+
+        seconds = run(map, records, threads, found);
+        report("concurrent", records * threads, seconds);
+
+        // Keep the file growing while reading, which remaps it (and with
+        // remap safety, waits for all readers to release it).
+        std::atomic<bool> writing(true);
+        std::thread writer([&]()
+        {
+            for (auto value = records; writing; ++value)
+                store(map, manager, value);
+        });
+
+        seconds = run(map, records, threads, found);
+        writing = false;
+        writer.join();
+        report("concurrent with growth", records * threads, seconds);
+
+        if (found != records * threads)
+        {
+            std::cerr << "found " << found << " of " << records * threads
+                << std::endl;
+            return 1;
+        }
+
+        map_file.close();
+    }
+
+    boost::filesystem::remove(file);
+    return 0;
+}
@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2016-2020 mvs developers
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Compares the full and compact stored forms of transactions: size, and
+// encode and decode throughput. Every transaction is checked to decode from
+// its compact form to the same hash.
+//
+// Input is the same hex encoded block file as block-parse-bench.
+//
+// usage: transaction-store-bench <blocks.hex> [rounds]
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/primitives/compact_transaction.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::database;
+
+static std::string longest_hex_run(const std::string& line)
+{
+    size_t best_begin = 0, best_size = 0;
+
+    for (size_t at = 0; at < line.size();)
+    {
+        auto end = at;
+        while (end < line.size() && std::isxdigit(
+            static_cast<unsigned char>(line[end])))
+            ++end;
+
+        if (end - at > best_size)
+        {
+            best_begin = at;
+            best_size = end - at;
+        }
+
+        at = end + 1;
+    }
+
+    return line.substr(best_begin, best_size);
+}
+
+static chain::transaction::list load_transactions(const std::string& path)
+{
+    chain::transaction::list transactions;
+    std::ifstream file(path);
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        data_chunk raw;
+        chain::block block;
+        const auto hex = longest_hex_run(line);
+        if (!hex.empty() && decode_base16(raw, hex) && block.from_data(raw))
+            for (auto& tx: block.transactions)
+                transactions.push_back(std::move(tx));
+    }
+
+    return transactions;
+}
+
+struct sample
+{
+    uint64_t bytes = 0;
+    double encode_seconds = 0;
+    double decode_seconds = 0;
+};
+
+static bool run(const chain::transaction::list& transactions, bool compact,
+    sample& out)
+{
+    typedef std::chrono::steady_clock clock;
+
+    std::vector<data_chunk> records;
+    records.reserve(transactions.size());
+
+    auto start = clock::now();
+    for (const auto& tx: transactions)
+        records.push_back(compact ? compact_transaction::to_data(tx) :
+            tx.to_data());
+
+    out.encode_seconds += std::chrono::duration<double>(
+        clock::now() - start).count();
+
+    start = clock::now();
+    for (const auto& record: records)
+    {
+        chain::transaction tx;
+        auto deserial = make_deserializer(record.begin(), record.end());
+        if (compact ? !compact_transaction::from_data(tx, deserial) :
+            !tx.from_data(deserial))
+            return false;
+
+        out.bytes += record.size();
+    }
+
+    out.decode_seconds += std::chrono::duration<double>(
+        clock::now() - start).count();
+    return true;
+}
+
+static bool verify(const chain::transaction::list& transactions)
+{
+    for (const auto& tx: transactions)
+    {
+        const auto record = compact_transaction::to_data(tx);
+        auto deserial = make_deserializer(record.begin(), record.end());
+
+        chain::transaction decoded;
+        if (!compact_transaction::from_data(decoded, deserial) ||
+            !deserial.is_exhausted() || decoded.hash() != tx.hash())
+        {
+            std::cerr << "compact form mismatch for "
+                << encode_hash(tx.hash()) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void report(const std::string& name, const sample& value,
+    size_t rounds)
+{
+    const auto mib = value.bytes / double(1024 * 1024);
+
+    std::cout << name
+        << ": " << value.bytes / rounds << " bytes"
+        << ", encode " << mib / value.encode_seconds << " MiB/s"
+        << ", decode " << mib / value.decode_seconds << " MiB/s"
+        << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <blocks.hex> [rounds]"
+            << std::endl;
+        return 1;
+    }
+
+    const auto rounds = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+    const auto transactions = load_transactions(argv[1]);
+
+    if (transactions.empty())
+    {
+        std::cerr << "no blocks found in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    if (!verify(transactions))
+        return 1;
+
+    sample full, compact;
+    for (auto round = 0; round < rounds; ++round)
+    {
+        if (!run(transactions, false, full) ||
+            !run(transactions, true, compact))
+        {
+            std::cerr << "failed to decode transaction" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << transactions.size() << " transactions x " << rounds
+        << " rounds" << std::endl;
+    report("full", full, rounds);
+    report("compact", compact, rounds);
+    std::cout << "ratio: " << double(compact.bytes) / full.bytes << std::endl;
+    return 0;
+}
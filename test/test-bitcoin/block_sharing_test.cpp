@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/block_detail.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+
+// Every heap allocation of the test program is counted, the checks look only
+// at the difference across the code under test.
+static std::atomic<uint64_t> allocations{ 0 };
+
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (auto block = std::malloc(size == 0 ? 1 : size))
+        return block;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept
+{
+    std::free(block);
+}
+
+// A block as the store reads it back, transactions with their hashes seeded.
+static chain::block make_block(size_t transactions)
+{
+    chain::block block;
+    block.transactions.resize(transactions);
+
+    for (size_t index = 0; index < transactions; ++index)
+    {
+        auto& tx = block.transactions[index];
+        tx.version = 1;
+        tx.inputs.resize(2);
+        tx.outputs.resize(2);
+        tx.set_hash(sha256_hash(to_chunk(to_little_endian<uint64_t>(index))));
+    }
+
+    return block;
+}
+
+// Returns the allocations of handing a chain of popped blocks to two
+// subscribers, the way the organizer does, and whether each subscriber saw
+// the popped transactions themselves, with their hashes.
+static uint64_t reorganize(size_t transactions, size_t blocks, bool& shared)
+{
+    std::vector<chain::block> popped;
+    std::vector<const chain::transaction*> originals;
+    popped.reserve(blocks);
+
+    for (size_t index = 0; index < blocks; ++index)
+    {
+        popped.push_back(make_block(transactions));
+        originals.push_back(popped.back().transactions.data());
+    }
+
+    const auto start = allocations.load();
+
+    // Wrap the popped blocks (block_chain_impl::pop_from).
+    block_detail::list replaced;
+    for (auto& block: popped)
+        replaced.push_back(std::make_shared<block_detail>(std::move(block)));
+
+    // Share them with the subscribers (organizer::notify_reorganize).
+    message::block_message::ptr_list replacements(replaced.size());
+    std::transform(replaced.begin(), replaced.end(), replacements.begin(),
+        [](const block_detail::ptr& detail) { return detail->actual(); });
+
+    // Each subscriber gets the list and reads the transaction hashes.
+    shared = true;
+    const auto subscriber = [&](const message::block_message::ptr_list& list)
+    {
+        for (size_t index = 0; index < list.size(); ++index)
+        {
+            shared &= list[index]->transactions.data() == originals[index];
+            for (const auto& tx: list[index]->transactions)
+                shared &= tx.hash() != null_hash;
+        }
+    };
+
+    subscriber(replacements);
+    subscriber(replacements);
+    return allocations.load() - start;
+}
+
+BOOST_AUTO_TEST_SUITE(block_sharing_tests)
+
+BOOST_AUTO_TEST_CASE(block_sharing__reorganize__popped_blocks__not_copied)
+{
+    bool shared;
+    BOOST_REQUIRE_GT(reorganize(1, 10, shared), 0u);
+    BOOST_REQUIRE(shared);
+
+    reorganize(2000, 10, shared);
+    BOOST_REQUIRE(shared);
+}
+
+// The block is shared, never copied, so the allocations do not grow with
+// the size of the block.
+BOOST_AUTO_TEST_CASE(block_sharing__reorganize__large_blocks__same_allocations)
+{
+    bool shared;
+    const auto small = reorganize(1, 10, shared);
+    const auto large = reorganize(2000, 10, shared);
+    BOOST_REQUIRE_EQUAL(small, large);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+
+using namespace bc;
+
+BOOST_AUTO_TEST_SUITE(metrics_tests)
+
+BOOST_AUTO_TEST_CASE(metrics__histogram__count_at_most__includes_bound)
+{
+    metrics::histogram histogram;
+    histogram.record(0);
+    histogram.record(1);
+    histogram.record(4);
+    histogram.record(5);
+    histogram.record(16);
+    histogram.record(17);
+
+    BOOST_REQUIRE_EQUAL(histogram.count_at_most(1), 2u);
+    BOOST_REQUIRE_EQUAL(histogram.count_at_most(4), 3u);
+    BOOST_REQUIRE_EQUAL(histogram.count_at_most(16), 5u);
+    BOOST_REQUIRE_EQUAL(histogram.count_at_most(64), 6u);
+    BOOST_REQUIRE_EQUAL(histogram.count(), 6u);
+}
+
+BOOST_AUTO_TEST_CASE(metrics__histogram__count_at_most__every_power_of_four)
+{
+    for (uint64_t bound = 1; bound <= (uint64_t(1) << 40); bound <<= 2)
+    {
+        metrics::histogram histogram;
+        histogram.record(bound - 1);
+        histogram.record(bound);
+        histogram.record(bound + 1);
+        BOOST_REQUIRE_EQUAL(histogram.count_at_most(bound), 2u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(metrics__to_prometheus__sample_on_bound__in_le_bucket)
+{
+    const auto histogram = metrics::instance().make_histogram(
+        "mvs_test_seconds", "Test histogram.", "case=\"le\"");
+    histogram->record(1024);
+
+    const auto text = metrics::instance().to_prometheus();
+    metrics::instance().remove("mvs_test_seconds", "case=\"le\"");
+
+    BOOST_REQUIRE(text.find(
+        "mvs_test_seconds_bucket{case=\"le\",le=\"0.001024\"} 1") !=
+        std::string::npos);
+    BOOST_REQUIRE(text.find(
+        "mvs_test_seconds_bucket{case=\"le\",le=\"0.000256\"} 0") !=
+        std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,268 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::wallet;
+
+static const short_hash hash1 = base16_literal(
+    "18c0bd8d1818f1bf99cb1df2269c645318ef7b73");
+
+static const data_chunk key1 = to_chunk(base16_literal(
+    "03e7ab4a2def5fcdc9cbe75c1bdd2d6b3fd7e8a9e0c75cbd1a6d1e1e7bb46e23b6"));
+static const data_chunk key2 = to_chunk(base16_literal(
+    "02a3a8e2f2c0e18c5a5e7ae2c9a1d1f8e1f3b62bdbcb2cc0c9f8d8e5e2f7a1b3c4"));
+static const data_chunk key3 = to_chunk(base16_literal(
+    "0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798"));
+
+// A der encoded endorsement shape, only its size matters to the patterns.
+static const data_chunk endorsement1(72, 0x30);
+static const data_chunk endorsement2(71, 0x30);
+
+static operation push(const data_chunk& data)
+{
+    if (data.size() <= 75)
+        return { opcode::special, data };
+
+    return { data.size() <= max_uint8 ? opcode::pushdata1 : opcode::pushdata2,
+        data };
+}
+
+static script make_script(const operation::stack& ops)
+{
+    script out;
+    out.operations = ops;
+    return out;
+}
+
+// Spelled out, the stack builder leaves leading default operations behind.
+static script pay_multisig_2_of_3()
+{
+    return make_script({ { opcode::op_2, {} }, push(key1), push(key2),
+        push(key3), { opcode::op_3, {} }, { opcode::checkmultisig, {} } });
+}
+
+// The view over the serialized script must agree with the script itself,
+// and the script parsed back through the view must resolve the same address.
+static void check_parity(const script& expected, script_pattern pattern)
+{
+    const auto raw = expected.to_data(false);
+    const script_view view(raw);
+
+    BOOST_REQUIRE(expected.pattern() == pattern);
+    BOOST_REQUIRE(view.is_valid());
+    BOOST_REQUIRE(view.pattern() == pattern);
+    BOOST_REQUIRE_EQUAL(view.size(), expected.operations.size());
+    BOOST_REQUIRE_EQUAL(view.is_push_only(),
+        operation::is_push_only(expected.operations));
+
+    operation::stack ops;
+    BOOST_REQUIRE(view.to_operations(ops));
+    BOOST_REQUIRE(ops == expected.operations);
+
+    size_t index = 0;
+    for (const auto& op: view)
+    {
+        const auto& other = expected.operations[index++];
+        BOOST_REQUIRE(op.code == other.code);
+        BOOST_REQUIRE(data_chunk(op.begin, op.end) == other.data);
+        BOOST_REQUIRE(op.begin >= raw.data());
+        BOOST_REQUIRE(op.end <= raw.data() + raw.size());
+    }
+
+    const auto parsed = script::factory_from_data(raw, false,
+        script::parse_mode::strict);
+    BOOST_REQUIRE(parsed.is_valid());
+    BOOST_REQUIRE(parsed.pattern() == pattern);
+    BOOST_REQUIRE(payment_address::extract(parsed) ==
+        payment_address::extract(expected));
+}
+
+BOOST_AUTO_TEST_SUITE(script_view_tests)
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__null_data__matches_script)
+{
+    const data_chunk data(40, 0x42);
+    check_parity(make_script(operation::to_null_data_pattern(data)),
+        script_pattern::null_data);
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__pay_multisig__matches_script)
+{
+    check_parity(pay_multisig_2_of_3(), script_pattern::pay_multisig);
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__pay_public_key__matches_script)
+{
+    const auto expected = make_script(
+        operation::to_pay_public_key_pattern(key1));
+    check_parity(expected, script_pattern::pay_public_key);
+    BOOST_REQUIRE(payment_address::extract(expected));
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__pay_key_hash__matches_script)
+{
+    const auto expected = make_script(
+        operation::to_pay_key_hash_pattern(hash1));
+    check_parity(expected, script_pattern::pay_key_hash);
+    BOOST_REQUIRE(payment_address::extract(expected).hash() == hash1);
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__pay_key_hash_with_lock_height__matches_script)
+{
+    const auto expected = make_script(
+        operation::to_pay_key_hash_with_lock_height_pattern(hash1, 100000));
+    check_parity(expected, script_pattern::pay_key_hash_with_lock_height);
+    BOOST_REQUIRE(payment_address::extract(expected).hash() == hash1);
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__pay_script_hash__matches_script)
+{
+    const auto expected = make_script(
+        operation::to_pay_script_hash_pattern(hash1));
+    check_parity(expected, script_pattern::pay_script_hash);
+    BOOST_REQUIRE_EQUAL(payment_address::extract(expected).version(),
+        payment_address::mainnet_p2sh);
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__sign_multisig__matches_script)
+{
+    check_parity(make_script({ { opcode::zero, {} }, push(endorsement1),
+        push(endorsement2) }), script_pattern::sign_multisig);
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__sign_multisig_with_redeem__matches_script)
+{
+    const auto redeem = pay_multisig_2_of_3().to_data(false);
+    check_parity(make_script({ { opcode::zero, {} }, push(endorsement1),
+        push(redeem) }), script_pattern::sign_multisig);
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__sign_public_key__matches_script)
+{
+    check_parity(make_script({ push(endorsement1) }),
+        script_pattern::sign_public_key);
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__sign_key_hash__matches_script)
+{
+    const auto expected = make_script({ push(endorsement1), push(key1) });
+    check_parity(expected, script_pattern::sign_key_hash);
+    BOOST_REQUIRE(payment_address::extract(expected));
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__sign_key_hash_with_lock_height__matches_script)
+{
+    const auto expected = make_script({ push(endorsement1), push(key1),
+        push({ 0xa0, 0x86, 0x01 }) });
+    check_parity(expected, script_pattern::sign_key_hash_with_lock_height);
+    BOOST_REQUIRE(payment_address::extract(expected));
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__sign_script_hash__matches_script)
+{
+    const auto redeem = make_script(
+        operation::to_pay_key_hash_pattern(hash1)).to_data(false);
+    const auto expected = make_script({ push(endorsement1), push(redeem) });
+    check_parity(expected, script_pattern::sign_script_hash);
+    BOOST_REQUIRE(payment_address::extract(expected).hash() ==
+        bitcoin_short_hash(redeem));
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__pay_blackhole__matches_script)
+{
+    const auto expected = make_script(
+        operation::to_pay_blackhole_pattern(hash1));
+    check_parity(expected, script_pattern::pay_blackhole_address);
+    BOOST_REQUIRE_EQUAL(payment_address::extract(expected).encoded(),
+        payment_address::blackhole_address);
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__pay_key_hash_with_attenuation_model__matches_script)
+{
+    const std::string model = "PN=0;LH=20000;TYPE=1;LQ=9000;LP=60000;UN=3";
+    const output_point input_point{ null_hash, 0 };
+    const auto expected = make_script(
+        operation::to_pay_key_hash_with_attenuation_model_pattern(hash1,
+            model, input_point));
+    check_parity(expected, script_pattern::pay_key_hash_with_attenuation_model);
+    BOOST_REQUIRE(payment_address::extract(expected).hash() == hash1);
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__pay_key_hash_with_sequence_lock__matches_script)
+{
+    const auto expected = make_script(
+        operation::to_pay_key_hash_with_sequence_lock_pattern(hash1, 1000));
+    check_parity(expected, script_pattern::pay_key_hash_with_sequence_lock);
+    BOOST_REQUIRE(payment_address::extract(expected).hash() == hash1);
+}
+
+BOOST_AUTO_TEST_CASE(script_view__pattern__non_standard__matches_script)
+{
+    const auto expected = make_script({ { opcode::dup, {} },
+        { opcode::drop, {} } });
+    check_parity(expected, script_pattern::non_standard);
+    BOOST_REQUIRE(!payment_address::extract(expected));
+}
+
+BOOST_AUTO_TEST_CASE(script_view__construct__empty__valid_non_standard)
+{
+    const data_chunk raw;
+    const script_view view(raw);
+    BOOST_REQUIRE(view.is_valid());
+    BOOST_REQUIRE(view.empty());
+    BOOST_REQUIRE(view.begin() == view.end());
+    BOOST_REQUIRE(view.pattern() == script_pattern::non_standard);
+}
+
+BOOST_AUTO_TEST_CASE(script_view__construct__truncated_push__invalid)
+{
+    // OP_HASH160 [20] with only 19 bytes of push data.
+    auto raw = make_script(operation::to_pay_script_hash_pattern(hash1))
+        .to_data(false);
+    raw.resize(raw.size() - 2);
+
+    const script_view view(raw);
+    BOOST_REQUIRE(!view.is_valid());
+    BOOST_REQUIRE_EQUAL(view.size(), 0u);
+    BOOST_REQUIRE(view.begin() == view.end());
+    BOOST_REQUIRE(view.pattern() == script_pattern::non_standard);
+
+    operation::stack ops;
+    BOOST_REQUIRE(!view.to_operations(ops));
+
+    script parsed;
+    BOOST_REQUIRE(!parsed.from_data(raw, false, script::parse_mode::strict));
+}
+
+BOOST_AUTO_TEST_CASE(script_view__construct__truncated_pushdata_size__invalid)
+{
+    const data_chunk raw{ static_cast<uint8_t>(opcode::pushdata2), 0x01 };
+    const script_view view(raw);
+    BOOST_REQUIRE(!view.is_valid());
+
+    script parsed;
+    BOOST_REQUIRE(!parsed.from_data(raw, false, script::parse_mode::strict));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2011-2020 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2020 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <utility>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+
+static transaction make_transaction(uint32_t locktime)
+{
+    output out;
+    out.value = 42;
+    out.script.operations = operation::to_pay_key_hash_pattern(
+        short_hash{ { 0x18, 0xc0, 0xbd } });
+
+    input in;
+    in.previous_output = output_point{ null_hash, 0 };
+    in.sequence = max_uint32;
+
+    return { 1, locktime, { in }, { out } };
+}
+
+// The hash the transaction has when nothing is cached.
+static hash_digest fresh_hash(const transaction& tx)
+{
+    return bitcoin_hash(tx.to_data());
+}
+
+BOOST_AUTO_TEST_SUITE(transaction_hash_tests)
+
+BOOST_AUTO_TEST_CASE(transaction__hash__copy_changed__rehashed)
+{
+    const auto tx = make_transaction(0);
+    const auto hash = tx.hash();
+
+    auto copy = tx;
+    copy.locktime = 7;
+    BOOST_REQUIRE(copy.hash() != hash);
+    BOOST_REQUIRE(copy.hash() == fresh_hash(copy));
+    BOOST_REQUIRE(tx.hash() == hash);
+}
+
+BOOST_AUTO_TEST_CASE(transaction__hash__copy_assigned_changed__rehashed)
+{
+    const auto tx = make_transaction(0);
+    auto copy = make_transaction(3);
+    const auto stale = copy.hash();
+
+    copy = tx;
+    copy.outputs[0].value = 43;
+    BOOST_REQUIRE(copy.hash() != tx.hash());
+    BOOST_REQUIRE(copy.hash() != stale);
+    BOOST_REQUIRE(copy.hash() == fresh_hash(copy));
+}
+
+BOOST_AUTO_TEST_CASE(transaction__hash__moved__kept_and_source_reset)
+{
+    auto tx = make_transaction(0);
+    const auto hash = tx.hash();
+
+    auto moved = std::move(tx);
+    BOOST_REQUIRE(moved.hash() == hash);
+    BOOST_REQUIRE(tx.hash() == fresh_hash(tx));
+
+    transaction assigned;
+    assigned = std::move(moved);
+    BOOST_REQUIRE(assigned.hash() == hash);
+    BOOST_REQUIRE(moved.hash() == fresh_hash(moved));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
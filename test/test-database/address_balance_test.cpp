@@ -0,0 +1,305 @@
+#ifdef  DATABASE_TESTS
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database.hpp>
+#include "utility.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+using namespace libbitcoin::database::test;
+using namespace libbitcoin::wallet;
+
+static const data_chunk key1 = to_chunk(base16_literal(
+    "03e7ab4a2def5fcdc9cbe75c1bdd2d6b3fd7e8a9e0c75cbd1a6d1e1e7bb46e23b6"));
+static const data_chunk key2 = to_chunk(base16_literal(
+    "02a3a8e2f2c0e18c5a5e7ae2c9a1d1f8e1f3b62bdbcb2cc0c9f8d8e5e2f7a1b3c4"));
+
+typedef std::tuple<std::string, uint64_t, uint64_t, uint32_t, uint32_t>
+    balance_row;
+typedef std::vector<balance_row> balance_rows;
+
+static balance_rows to_rows(const address_balance::list& balances)
+{
+    balance_rows out;
+    for (const auto& balance: balances)
+        out.emplace_back(balance.symbol, balance.quantity,
+            balance.encumbered_quantity, balance.encumbered_count,
+            balance.output_count);
+
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+// Three blocks of transfers between two addresses, the last of which spends
+// an output of its own block.
+class reorg_chain
+{
+public:
+    reorg_chain()
+      : owner(key_address(key1)),
+        payee(key_address(key2)),
+        genesis(make_block(null_hash, 0, { make_coinbase(0, {
+            pay_asset(owner, "TEST.BAL", 100),
+            make_output(operation::to_pay_key_hash_with_sequence_lock_pattern(
+                owner.hash(), 1000), 0, asset_attachment("TEST.BAL", 5)),
+            pay_asset(payee, "TEST.OTHER", 3) }) })),
+        store("balance_test", genesis)
+    {
+        const auto first = make_spend({ { genesis.transactions[0].hash(), 0 } },
+            key1, { pay_asset(payee, "TEST.BAL", 60),
+                pay_asset(owner, "TEST.BAL", 40) });
+        blocks.push_back(make_block(genesis.header.hash(), 1,
+            { make_coinbase(1, {}), first }));
+
+        const auto second = make_spend({ { first.hash(), 0 } }, key2,
+            { pay_asset(owner, "TEST.BAL", 25),
+              pay_asset(payee, "TEST.BAL", 35) });
+        const auto third = make_spend({ { second.hash(), 1 } }, key2,
+            { pay_asset(owner, "TEST.BAL", 35) });
+        blocks.push_back(make_block(blocks.back().header.hash(), 2,
+            { make_coinbase(2, {}), second, third }));
+    }
+
+    balance_rows balances(const payment_address& address)
+    {
+        return to_rows(store.db().address_balances.get(
+            address_key::from_address(address)));
+    }
+
+    void push(size_t index)
+    {
+        store.db().push(blocks[index]);
+    }
+
+    // A block on the genesis block in place of the first one.
+    void push_instead(const transaction& spend)
+    {
+        store.db().push(make_block(genesis.header.hash(), 1,
+            { make_coinbase(1, {}), spend }));
+    }
+
+    void pop(size_t index)
+    {
+        block out;
+        BOOST_REQUIRE(store.db().pop(out));
+        BOOST_REQUIRE(out.header.hash() == blocks[index].header.hash());
+    }
+
+    const payment_address owner;
+    const payment_address payee;
+    const block genesis;
+    block::list blocks;
+    test_database store;
+};
+
+BOOST_AUTO_TEST_SUITE(address_balance_tests)
+
+BOOST_AUTO_TEST_CASE(address_balance__push__transfers__expected_balances)
+{
+    reorg_chain chain;
+    const balance_row other{ "TEST.OTHER", 3, 0, 0, 1 };
+    const balance_rows locked{ balance_row("TEST.BAL", 105, 5, 1, 2) };
+    const balance_rows spent{ balance_row("TEST.BAL", 45, 5, 1, 2) };
+    const balance_rows received{ balance_row("TEST.BAL", 60, 0, 0, 1),
+        other };
+    const balance_rows gathered{ balance_row("TEST.BAL", 105, 5, 1, 4) };
+
+    BOOST_REQUIRE(chain.balances(chain.owner) == locked);
+    BOOST_REQUIRE(chain.balances(chain.payee) == balance_rows{ other });
+
+    chain.push(0);
+    BOOST_REQUIRE(chain.balances(chain.owner) == spent);
+    BOOST_REQUIRE(chain.balances(chain.payee) == received);
+
+    // The payee no longer holds TEST.BAL, so it is not listed.
+    chain.push(1);
+    BOOST_REQUIRE(chain.balances(chain.owner) == gathered);
+    BOOST_REQUIRE(chain.balances(chain.payee) == balance_rows{ other });
+}
+
+// The spent output leaves the balance of its own address, whatever address
+// the input script resolves to, if any.
+BOOST_AUTO_TEST_CASE(address_balance__push__input_script_without_owner__debits_owner)
+{
+    for (const auto resolvable: { true, false })
+    {
+        reorg_chain chain;
+        const auto before = chain.balances(chain.owner);
+        auto spend = make_spend({ { chain.genesis.transactions[0].hash(), 0 } },
+            key2, { pay_asset(chain.payee, "TEST.BAL", 100) });
+
+        // Only the endorsement, no key to resolve an address from.
+        if (!resolvable)
+        {
+            spend.inputs[0].script.operations.pop_back();
+            BOOST_REQUIRE(!payment_address::extract(spend.inputs[0].script));
+        }
+
+        chain.push_instead(spend);
+        BOOST_REQUIRE(chain.balances(chain.owner) ==
+            balance_rows{ balance_row("TEST.BAL", 5, 5, 1, 1) });
+        BOOST_REQUIRE_EQUAL(chain.store.db().address_balances.get(
+            address_key::from_address(chain.payee), "TEST.BAL").quantity,
+            100u);
+
+        block out;
+        BOOST_REQUIRE(chain.store.db().pop(out));
+        BOOST_REQUIRE(chain.balances(chain.owner) == before);
+    }
+}
+
+// As with the history scan, an unspent output of zero quantity is listed.
+BOOST_AUTO_TEST_CASE(address_balance__get__zero_quantity_output__listed)
+{
+    reorg_chain chain;
+    const auto zero = make_spend({ { chain.genesis.transactions[0].hash(), 2 } },
+        key2, { pay_asset(chain.owner, "TEST.OTHER", 0),
+            pay_asset(chain.payee, "TEST.OTHER", 3) });
+
+    chain.push_instead(zero);
+    const auto owner = chain.balances(chain.owner);
+    BOOST_REQUIRE_EQUAL(owner.size(), 2u);
+    BOOST_REQUIRE(owner[1] == balance_row("TEST.OTHER", 0, 0, 0, 1));
+
+    const auto spend = make_spend({ { zero.hash(), 0 } }, key1,
+        { pay_asset(chain.payee, "TEST.OTHER", 0) });
+    const auto previous = make_block(chain.genesis.header.hash(), 1,
+        { make_coinbase(1, {}), zero });
+    chain.store.db().push(make_block(previous.header.hash(), 2,
+        { make_coinbase(2, {}), spend }));
+    BOOST_REQUIRE_EQUAL(chain.balances(chain.owner).size(), 1u);
+    BOOST_REQUIRE(chain.balances(chain.payee) == balance_rows{
+        balance_row("TEST.OTHER", 3, 0, 0, 2) });
+}
+
+// Each pop restores the balances exactly as they were before the push.
+BOOST_AUTO_TEST_CASE(address_balance__pop__reorganized__restored)
+{
+    reorg_chain chain;
+    std::vector<balance_rows> owner{ chain.balances(chain.owner) };
+    std::vector<balance_rows> payee{ chain.balances(chain.payee) };
+
+    for (size_t index = 0; index < chain.blocks.size(); ++index)
+    {
+        chain.push(index);
+        owner.push_back(chain.balances(chain.owner));
+        payee.push_back(chain.balances(chain.payee));
+    }
+
+    for (auto index = chain.blocks.size(); index > 0; --index)
+    {
+        chain.pop(index - 1);
+        BOOST_REQUIRE(chain.balances(chain.owner) == owner[index - 1]);
+        BOOST_REQUIRE(chain.balances(chain.payee) == payee[index - 1]);
+    }
+
+    // Pushed again, the same blocks give the same balances.
+    for (size_t index = 0; index < chain.blocks.size(); ++index)
+    {
+        chain.push(index);
+        BOOST_REQUIRE(chain.balances(chain.owner) == owner[index + 1]);
+        BOOST_REQUIRE(chain.balances(chain.payee) == payee[index + 1]);
+    }
+}
+
+// The table built by the upgrade matches the one kept through the reorg.
+BOOST_AUTO_TEST_CASE(address_balance__rebuild__after_reorg__same_balances)
+{
+    reorg_chain chain;
+    chain.push(0);
+    chain.push(1);
+    chain.pop(1);
+    chain.pop(0);
+    chain.push(0);
+    chain.push(1);
+
+    const auto owner = chain.balances(chain.owner);
+    const auto payee = chain.balances(chain.payee);
+    chain.store.close();
+
+    const auto& directory = chain.store.directory();
+    boost::filesystem::remove(directory / "address_balance_table");
+    boost::filesystem::remove(directory / "address_balance_row");
+    BOOST_REQUIRE(data_base::upgrade_version_65(directory));
+
+    chain.store.open();
+    BOOST_REQUIRE(chain.balances(chain.owner) == owner);
+    BOOST_REQUIRE(chain.balances(chain.payee) == payee);
+}
+
+// Outputs below the history height are neither counted nor debited, in the
+// build as in the push. The genesis block is always counted, so it holds no
+// asset here.
+BOOST_AUTO_TEST_CASE(address_balance__rebuild__history_height__same_balances)
+{
+    const auto owner = key_address(key1);
+    const auto payee = key_address(key2);
+    const auto genesis = make_block(null_hash, 0, { make_coinbase(0,
+        { pay_key_hash(owner, 1) }) });
+    const auto early = make_block(genesis.header.hash(), 1, { make_coinbase(1,
+        { pay_asset(owner, "TEST.BAL", 100) }) });
+
+    // The spend of the early output is not debited from the later one.
+    const auto spend = make_spend({ { early.transactions[0].hash(), 0 } },
+        key1, { pay_asset(payee, "TEST.BAL", 60),
+            pay_asset(owner, "TEST.BAL", 40) });
+    const auto late = make_block(early.header.hash(), 2, { make_coinbase(2,
+        { pay_asset(owner, "TEST.BAL", 5) }), spend });
+
+    test_database store("balance_history_test", genesis, 2);
+    const auto balances = [&store](const payment_address& address)
+    {
+        return to_rows(store.db().address_balances.get(
+            address_key::from_address(address)));
+    };
+
+    store.db().push(early);
+    BOOST_REQUIRE(balances(owner).empty());
+
+    store.db().push(late);
+    const auto owner_rows = balances(owner);
+    const auto payee_rows = balances(payee);
+    BOOST_REQUIRE(owner_rows ==
+        balance_rows{ balance_row("TEST.BAL", 45, 0, 0, 2) });
+    BOOST_REQUIRE(payee_rows ==
+        balance_rows{ balance_row("TEST.BAL", 60, 0, 0, 1) });
+    store.close();
+
+    const auto& directory = store.directory();
+    boost::filesystem::remove(directory / "address_balance_table");
+    boost::filesystem::remove(directory / "address_balance_row");
+    BOOST_REQUIRE(data_base::upgrade_version_65(directory, 2));
+
+    store.open();
+    BOOST_REQUIRE(balances(owner) == owner_rows);
+    BOOST_REQUIRE(balances(payee) == payee_rows);
+}
+
+// Queries look the address up by its encoded form.
+BOOST_AUTO_TEST_CASE(address_balance__get__encoded_address__same_rows)
+{
+    reorg_chain chain;
+    chain.push(0);
+
+    auto& balances = chain.store.db().address_balances;
+    for (const auto& address: { chain.owner, chain.payee })
+        BOOST_REQUIRE(to_rows(balances.get(address_key::from_string(
+            address.encoded()))) == chain.balances(address));
+
+    // The locked outputs of the owner keep its balance query on the history
+    // scan, as the locked part depends on the height.
+    BOOST_REQUIRE_EQUAL(balances.get(address_key::from_address(chain.owner),
+        "TEST.BAL").encumbered_count, 1u);
+    BOOST_REQUIRE_EQUAL(balances.get(address_key::from_address(chain.payee),
+        "TEST.BAL").encumbered_count, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
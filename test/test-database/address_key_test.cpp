@@ -0,0 +1,372 @@
+#ifdef  DATABASE_TESTS
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database.hpp>
+#include <metaverse/database/address_key.hpp>
+#include <metaverse/database/primitives/record_multimap_iterable.hpp>
+#include <metaverse/database/primitives/record_multimap_iterator.hpp>
+#include "utility.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+using namespace libbitcoin::database::test;
+using namespace libbitcoin::wallet;
+
+static const data_chunk key1 = to_chunk(base16_literal(
+    "03e7ab4a2def5fcdc9cbe75c1bdd2d6b3fd7e8a9e0c75cbd1a6d1e1e7bb46e23b6"));
+static const data_chunk key2 = to_chunk(base16_literal(
+    "02a3a8e2f2c0e18c5a5e7ae2c9a1d1f8e1f3b62bdbcb2cc0c9f8d8e5e2f7a1b3c4"));
+static const data_chunk key3 = to_chunk(base16_literal(
+    "03b9c5e1d2a4f6b8c0e2d4f6a8b0c2e4f6a8b0c2d4e6f8a0b2c4d6e8f0a2b4c6d8"));
+
+static const short_hash from_key = base16_literal(
+    "18c0bd8d1818f1bf99cb1df2269c645318ef7b73");
+static const short_hash to_key = base16_literal(
+    "0a1b2c3d4e5f60718293a4b5c6d7e8f900112233");
+static const short_hash other_key = base16_literal(
+    "ffeeddccbbaa99887766554433221100ffeeddcc");
+
+// A multimap of eight byte rows, composed as by the address tables.
+class multimap_store
+{
+public:
+    static BC_CONSTEXPR size_t buckets = 101;
+    static BC_CONSTEXPR size_t header_size =
+        record_hash_table_header_size(buckets);
+    static BC_CONSTEXPR size_t record_size =
+        hash_table_multimap_record_size<short_hash>();
+    static BC_CONSTEXPR size_t row_size = sizeof(array_index) + 8;
+
+    multimap_store()
+      : lookup_path_("rekey_test_lookup"),
+        rows_path_("rekey_test_rows"),
+        lookup_file_(touch(lookup_path_)),
+        header_(lookup_file_, buckets),
+        lookup_manager_(lookup_file_, header_size, record_size),
+        map_(header_, lookup_manager_),
+        rows_file_(touch(rows_path_)),
+        rows_manager_(rows_file_, 0, row_size),
+        rows_(rows_manager_),
+        multimap_(map_, rows_)
+    {
+        BOOST_REQUIRE(lookup_file_.start());
+        BOOST_REQUIRE(rows_file_.start());
+        lookup_file_.resize(header_size + minimum_records_size);
+        rows_file_.resize(minimum_records_size);
+        BOOST_REQUIRE(header_.create());
+        BOOST_REQUIRE(lookup_manager_.create());
+        BOOST_REQUIRE(rows_manager_.create());
+        BOOST_REQUIRE(header_.start());
+        BOOST_REQUIRE(lookup_manager_.start());
+        BOOST_REQUIRE(rows_manager_.start());
+    }
+
+    ~multimap_store()
+    {
+        lookup_file_.close();
+        rows_file_.close();
+        boost::filesystem::remove(lookup_path_);
+        boost::filesystem::remove(rows_path_);
+    }
+
+    void add(const short_hash& key, uint64_t value)
+    {
+        multimap_.add_row(key, [value](memory_ptr data)
+        {
+            auto serial = make_serializer(REMAP_ADDRESS(data));
+            serial.write_8_bytes_little_endian(value);
+        });
+    }
+
+    std::vector<uint64_t> values(const short_hash& key) const
+    {
+        std::vector<uint64_t> out;
+        const auto start = multimap_.lookup(key);
+        for (const auto index: record_multimap_iterable(rows_, start))
+        {
+            const auto row = rows_.get(index);
+            out.push_back(from_little_endian_unsafe<uint64_t>(
+                REMAP_ADDRESS(row)));
+        }
+
+        return out;
+    }
+
+    // The state left by a rekey interrupted between its link and unlink.
+    void link(const short_hash& key, const short_hash& existing)
+    {
+        const auto first = multimap_.lookup(existing);
+        map_.store(key, [first](memory_ptr data)
+        {
+            auto serial = make_serializer(REMAP_ADDRESS(data));
+            serial.write_little_endian<array_index>(first);
+        });
+    }
+
+    record_multimap<short_hash>& multimap()
+    {
+        return multimap_;
+    }
+
+private:
+    static const boost::filesystem::path& touch(
+        const boost::filesystem::path& file)
+    {
+        boost::filesystem::remove(file);
+        BOOST_REQUIRE(data_base::touch_file(file));
+        return file;
+    }
+
+    const boost::filesystem::path lookup_path_;
+    const boost::filesystem::path rows_path_;
+    memory_map lookup_file_;
+    record_hash_table_header header_;
+    record_manager lookup_manager_;
+    record_hash_table<short_hash> map_;
+    memory_map rows_file_;
+    record_manager rows_manager_;
+    record_list rows_;
+    record_multimap<short_hash> multimap_;
+};
+
+BOOST_AUTO_TEST_SUITE(address_key_tests)
+
+BOOST_AUTO_TEST_CASE(address_key__from_string__address__from_address)
+{
+    const auto address = key_address(key1);
+    const auto key = address_key::from_string(address.encoded());
+    BOOST_REQUIRE(key == address_key::from_address(address));
+    BOOST_REQUIRE(key != address_key::legacy(address));
+}
+
+BOOST_AUTO_TEST_CASE(address_key__from_address__key_and_script_hash__distinct)
+{
+    const auto hash = bitcoin_short_hash(key1);
+    const payment_address key_hash(hash, payment_address::mainnet_p2kh);
+    const payment_address script_hash(hash, payment_address::mainnet_p2sh);
+    BOOST_REQUIRE(address_key::from_address(key_hash) !=
+        address_key::from_address(script_hash));
+}
+
+BOOST_AUTO_TEST_CASE(address_key__from_string__undecodable__null_key)
+{
+    const std::string text = "not.an.address";
+    BOOST_REQUIRE(!payment_address(text));
+    BOOST_REQUIRE(address_key::from_string(text) == null_short_hash);
+    BOOST_REQUIRE(address_key::from_string("") == null_short_hash);
+}
+
+BOOST_AUTO_TEST_CASE(address_key__from_string__bad_checksum__null_key)
+{
+    const auto address = key_address(key1);
+    auto text = address.encoded();
+    text.back() = text.back() == '1' ? '2' : '1';
+    BOOST_REQUIRE(!payment_address(text));
+    BOOST_REQUIRE(address_key::from_string(text) == null_short_hash);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(record_multimap_rekey_tests)
+
+BOOST_AUTO_TEST_CASE(record_multimap__rekey__rows__moved_in_order)
+{
+    multimap_store store;
+    store.add(from_key, 1);
+    store.add(from_key, 2);
+    store.add(from_key, 3);
+
+    BOOST_REQUIRE(store.multimap().rekey(from_key, to_key));
+    BOOST_REQUIRE(store.values(from_key).empty());
+    BOOST_REQUIRE(store.values(to_key) == (std::vector<uint64_t>{ 3, 2, 1 }));
+
+    // Rows added after the move follow the new key.
+    store.add(to_key, 4);
+    BOOST_REQUIRE_EQUAL(store.values(to_key).size(), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(record_multimap__rekey__repeated__false_unchanged)
+{
+    multimap_store store;
+    store.add(from_key, 1);
+    store.add(from_key, 2);
+
+    BOOST_REQUIRE(store.multimap().rekey(from_key, to_key));
+    BOOST_REQUIRE(!store.multimap().rekey(from_key, to_key));
+    BOOST_REQUIRE(store.values(from_key).empty());
+    BOOST_REQUIRE(store.values(to_key) == (std::vector<uint64_t>{ 2, 1 }));
+}
+
+BOOST_AUTO_TEST_CASE(record_multimap__rekey__interrupted__completes_once)
+{
+    multimap_store store;
+    store.add(from_key, 1);
+    store.add(from_key, 2);
+
+    // Both keys name the same rows, as after a crash mid rekey.
+    store.link(to_key, from_key);
+    BOOST_REQUIRE(store.values(to_key) == store.values(from_key));
+
+    BOOST_REQUIRE(store.multimap().rekey(from_key, to_key));
+    BOOST_REQUIRE(store.values(from_key).empty());
+    BOOST_REQUIRE(store.values(to_key) == (std::vector<uint64_t>{ 2, 1 }));
+    BOOST_REQUIRE(!store.multimap().rekey(from_key, to_key));
+}
+
+BOOST_AUTO_TEST_CASE(record_multimap__rekey__target_has_other_rows__false)
+{
+    multimap_store store;
+    store.add(from_key, 1);
+    store.add(to_key, 9);
+
+    BOOST_REQUIRE(!store.multimap().rekey(from_key, to_key));
+    BOOST_REQUIRE(store.values(from_key) == (std::vector<uint64_t>{ 1 }));
+    BOOST_REQUIRE(store.values(to_key) == (std::vector<uint64_t>{ 9 }));
+}
+
+BOOST_AUTO_TEST_CASE(record_multimap__rekey__no_source__false)
+{
+    multimap_store store;
+    store.add(other_key, 1);
+
+    BOOST_REQUIRE(!store.multimap().rekey(from_key, to_key));
+    BOOST_REQUIRE(store.values(to_key).empty());
+    BOOST_REQUIRE(store.values(other_key) == (std::vector<uint64_t>{ 1 }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+static attachment did_attachment(const std::string& symbol,
+    const payment_address& address)
+{
+    return { DID_TYPE, 1, did(DID_DETAIL_TYPE,
+        did_detail(symbol, address.encoded())) };
+}
+
+// Rows are moved to their legacy keys to stand in for a 0.6.6 database,
+// then the upgrade rekeys them from the addresses of the stored chain.
+// The did output pays the owner but names a third address, which only the
+// attachment gives.
+class legacy_chain
+{
+public:
+    legacy_chain()
+      : owner(key_address(key1)),
+        payee(key_address(key2)),
+        named(key_address(key3)),
+        genesis(make_block(null_hash, 0, { make_coinbase(0, {
+            pay_asset(owner, "TEST.REKEY", 100),
+            make_output(operation::to_pay_key_hash_with_sequence_lock_pattern(
+                owner.hash(), 1000), 5, etp_attachment(5)),
+            make_output(operation::to_pay_key_hash_pattern(owner.hash()), 0,
+                did_attachment("TEST.DID", named)) }) })),
+        spend(make_spend({ { genesis.transactions[0].hash(), 0 } }, key1,
+            { pay_asset(payee, "TEST.REKEY", 60),
+              pay_asset(owner, "TEST.REKEY", 40) })),
+        store("rekey_test", genesis)
+    {
+        store.db().push(make_block(genesis.header.hash(), 1,
+            { make_coinbase(1, {}), spend }));
+
+        // As stored by a did transfer pop, under the address of the did.
+        auto detail = genesis.transactions[0].outputs[2].get_did().get_data();
+        store.db().address_dids.store_output(address_key::legacy(named),
+            { genesis.transactions[0].hash(), 2 }, 0, 0,
+            static_cast<uint16_t>(business_kind::did_register), 0, detail);
+
+        to_legacy(owner);
+        to_legacy(payee);
+        store.db().synchronize();
+        store.close();
+        boost::filesystem::remove(store.directory() / "address_keys");
+    }
+
+    void to_legacy(const payment_address& address)
+    {
+        auto& db = store.db();
+        const auto from = address_key::from_address(address);
+        const auto to = address_key::legacy(address);
+        db.address_assets.rekey(from, to);
+        db.address_dids.rekey(from, to);
+        db.address_balances.rekey(from, to);
+        db.address_locks.rekey(from, to);
+    }
+
+    void require_rekeyed()
+    {
+        store.open();
+        auto& db = store.db();
+        const auto owner_key = address_key::from_address(owner);
+        const auto payee_key = address_key::from_address(payee);
+
+        BOOST_REQUIRE_EQUAL(db.address_balances.get(owner_key,
+            "TEST.REKEY").quantity, 40u);
+        BOOST_REQUIRE_EQUAL(db.address_balances.get(payee_key,
+            "TEST.REKEY").quantity, 60u);
+        BOOST_REQUIRE_EQUAL(db.address_locks.get(owner_key).size(), 1u);
+
+        // Two outputs and a spend of the owner, one output of the payee.
+        BOOST_REQUIRE_EQUAL(db.address_assets.get(owner_key, 0, 0).size(), 4u);
+        BOOST_REQUIRE_EQUAL(db.address_assets.get(payee_key, 0, 0).size(), 1u);
+        BOOST_REQUIRE_EQUAL(db.address_dids.get(owner_key, 0, 0).size(), 1u);
+        BOOST_REQUIRE_EQUAL(db.address_dids.get(
+            address_key::from_address(named), 0, 0).size(), 1u);
+
+        for (const auto& address: { owner, payee, named })
+        {
+            const auto legacy = address_key::legacy(address);
+            BOOST_REQUIRE(!db.address_balances.contains(legacy));
+            BOOST_REQUIRE(!db.address_locks.contains(legacy));
+            BOOST_REQUIRE(db.address_assets.get(legacy, 0, 0).empty());
+            BOOST_REQUIRE(db.address_dids.get(legacy, 0, 0).empty());
+        }
+
+        store.close();
+    }
+
+    const payment_address owner;
+    const payment_address payee;
+    const payment_address named;
+    const block genesis;
+    const transaction spend;
+    test_database store;
+};
+
+BOOST_AUTO_TEST_SUITE(rekey_addresses_tests)
+
+BOOST_AUTO_TEST_CASE(rekey_addresses__upgrade__legacy_rows__rekeyed)
+{
+    legacy_chain chain;
+    BOOST_REQUIRE(data_base::upgrade_version_67(chain.store.directory()));
+    BOOST_REQUIRE(boost::filesystem::exists(
+        chain.store.directory() / "address_keys"));
+    chain.require_rekeyed();
+}
+
+BOOST_AUTO_TEST_CASE(rekey_addresses__upgrade__interrupted__repeated)
+{
+    legacy_chain chain;
+
+    // An upgrade stopped after one address of one table was moved.
+    chain.store.open();
+    auto& db = chain.store.db();
+    BOOST_REQUIRE(db.address_balances.rekey(address_key::legacy(chain.owner),
+        address_key::from_address(chain.owner)));
+    db.address_balances.sync();
+    chain.store.close();
+
+    BOOST_REQUIRE(data_base::upgrade_version_67(chain.store.directory()));
+    chain.require_rekeyed();
+
+    // Repeated without the marker, nothing is moved twice.
+    boost::filesystem::remove(chain.store.directory() / "address_keys");
+    BOOST_REQUIRE(data_base::upgrade_version_67(chain.store.directory()));
+    chain.require_rekeyed();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
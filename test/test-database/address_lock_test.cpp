@@ -0,0 +1,233 @@
+#ifdef  DATABASE_TESTS
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database.hpp>
+#include "utility.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+using namespace libbitcoin::database::test;
+using namespace libbitcoin::wallet;
+
+static const data_chunk key1 = to_chunk(base16_literal(
+    "03e7ab4a2def5fcdc9cbe75c1bdd2d6b3fd7e8a9e0c75cbd1a6d1e1e7bb46e23b6"));
+static const data_chunk key2 = to_chunk(base16_literal(
+    "02a3a8e2f2c0e18c5a5e7ae2c9a1d1f8e1f3b62bdbcb2cc0c9f8d8e5e2f7a1b3c4"));
+
+typedef std::tuple<hash_digest, uint32_t, uint32_t, uint64_t> lock_row;
+typedef std::vector<lock_row> lock_rows;
+
+static lock_rows to_rows(const address_lock::list& locks)
+{
+    lock_rows out;
+    for (const auto& lock: locks)
+        out.emplace_back(lock.point.hash, lock.point.index, lock.height,
+            lock.expiration());
+
+    return out;
+}
+
+static output pay_locked(const payment_address& address, uint64_t value,
+    uint32_t heights)
+{
+    return make_output(operation::to_pay_key_hash_with_sequence_lock_pattern(
+        address.hash(), heights), value, etp_attachment(value));
+}
+
+// A block that locks two outputs of the owner, for two and three heights,
+// on the genesis block, followed by empty blocks.
+class lock_chain
+{
+public:
+    lock_chain()
+      : owner(key_address(key1)),
+        payee(key_address(key2)),
+        genesis(make_block(null_hash, 0, { make_coinbase(0,
+            { pay_key_hash(owner, 1) }) })),
+        store("lock_test", genesis)
+    {
+        blocks.push_back(make_block(genesis.header.hash(), 1,
+            { make_coinbase(1, { pay_locked(owner, 50, 3),
+                pay_locked(owner, 20, 2), pay_key_hash(payee, 5) }) }));
+    }
+
+    output_point locked(uint32_t index) const
+    {
+        return output_point{ blocks.front().transactions[0].hash(), index };
+    }
+
+    lock_rows locks(const payment_address& address)
+    {
+        return to_rows(store.db().address_locks.get(
+            address_key::from_address(address)));
+    }
+
+    uint64_t top()
+    {
+        size_t out;
+        BOOST_REQUIRE(store.db().blocks.top(out));
+        return out;
+    }
+
+    // Extends the chain with an empty block, or with the given spend.
+    void push(const transaction::list& spends={})
+    {
+        const auto height = static_cast<uint32_t>(blocks.size() + 1);
+        auto transactions = spends;
+        transactions.insert(transactions.begin(), make_coinbase(height, {}));
+        blocks.push_back(make_block(blocks.back().header.hash(), height,
+            transactions));
+        store.db().push(blocks.back());
+    }
+
+    void pop()
+    {
+        block out;
+        BOOST_REQUIRE(store.db().pop(out));
+        BOOST_REQUIRE(out.header.hash() == blocks.back().header.hash());
+        blocks.pop_back();
+    }
+
+    const payment_address owner;
+    const payment_address payee;
+    const block genesis;
+    block::list blocks;
+    test_database store;
+};
+
+BOOST_AUTO_TEST_SUITE(address_lock_tests)
+
+// An output stays locked up to the height before its expiration, which is
+// the height of its block plus the locked heights, and no further.
+BOOST_AUTO_TEST_CASE(address_lock__is_locked__expiration_height__unlocked)
+{
+    lock_chain chain;
+    chain.store.db().push(chain.blocks.front());
+
+    // Listed by expiration, not by the order of the outputs.
+    const auto& tx_hash = chain.locked(0).hash;
+    BOOST_REQUIRE(chain.locks(chain.owner) == (lock_rows{
+        lock_row(tx_hash, 1, 1, 3), lock_row(tx_hash, 0, 1, 4) }));
+    BOOST_REQUIRE(chain.locks(chain.payee).empty());
+
+    while (chain.top() < 4)
+    {
+        const auto top = chain.top();
+        const auto locks = chain.store.db().address_locks.get(
+            address_key::from_address(chain.owner));
+        BOOST_REQUIRE_EQUAL(locks.size(), 2u);
+        BOOST_REQUIRE_EQUAL(locks[0].is_locked(top), top < 3);
+        BOOST_REQUIRE(locks[1].is_locked(top));
+        chain.push();
+    }
+
+    // Expired outputs are still listed until spent.
+    const auto locks = chain.store.db().address_locks.get(
+        address_key::from_address(chain.owner));
+    BOOST_REQUIRE_EQUAL(locks.size(), 2u);
+    BOOST_REQUIRE(!locks[0].is_locked(4));
+    BOOST_REQUIRE(!locks[1].is_locked(4));
+}
+
+// A lock is spent under the address of its own script, whatever address the
+// input script resolves to, if any, and the pop of the spend restores it.
+BOOST_AUTO_TEST_CASE(address_lock__pop__spend__lock_restored)
+{
+    for (const auto resolvable: { true, false })
+    {
+        lock_chain chain;
+        chain.store.db().push(chain.blocks.front());
+        chain.push();
+        chain.push();
+        const auto before = chain.locks(chain.owner);
+
+        auto spend = make_spend({ chain.locked(1) }, key2,
+            { pay_key_hash(chain.payee, 20) });
+
+        // Only the endorsement, no key to resolve an address from.
+        if (!resolvable)
+        {
+            spend.inputs[0].script.operations.pop_back();
+            BOOST_REQUIRE(!payment_address::extract(spend.inputs[0].script));
+        }
+
+        chain.push({ spend });
+        BOOST_REQUIRE(chain.locks(chain.owner) ==
+            lock_rows{ before.back() });
+
+        chain.pop();
+        BOOST_REQUIRE(chain.locks(chain.owner) == before);
+
+        // The restored lock can be spent again, by another block.
+        chain.push({ make_spend({ chain.locked(1), chain.locked(0) }, key1,
+            { pay_key_hash(chain.payee, 70) }) });
+        BOOST_REQUIRE(chain.locks(chain.owner).empty());
+
+        chain.pop();
+        BOOST_REQUIRE(chain.locks(chain.owner) == before);
+    }
+}
+
+// The pop of the block of the locks removes them, and they come back with it.
+BOOST_AUTO_TEST_CASE(address_lock__pop__locking_block__removed)
+{
+    lock_chain chain;
+    const auto first = chain.blocks.front();
+    chain.store.db().push(first);
+    const auto before = chain.locks(chain.owner);
+    BOOST_REQUIRE_EQUAL(before.size(), 2u);
+
+    block out;
+    BOOST_REQUIRE(chain.store.db().pop(out));
+    BOOST_REQUIRE(out.header.hash() == first.header.hash());
+    BOOST_REQUIRE(chain.locks(chain.owner).empty());
+    BOOST_REQUIRE(!chain.store.db().address_locks.contains(
+        address_key::from_address(chain.owner)));
+
+    chain.store.db().push(first);
+    BOOST_REQUIRE(chain.locks(chain.owner) == before);
+}
+
+// The table built by the upgrade matches the one kept through the reorg, and
+// like the push it skips the outputs below the history height.
+BOOST_AUTO_TEST_CASE(address_lock__rebuild__after_reorg__same_locks)
+{
+    for (const size_t history_height: { 0, 2 })
+    {
+        lock_chain chain;
+        chain.store.db().push(chain.blocks.front());
+        chain.push({ make_spend({ chain.locked(1) }, key2,
+            { pay_locked(chain.payee, 20, 5) }) });
+        chain.pop();
+        chain.push({ make_spend({ chain.locked(0) }, key1,
+            { pay_locked(chain.payee, 50, 5) }) });
+
+        const auto owner = chain.locks(chain.owner);
+        const auto payee = chain.locks(chain.payee);
+        BOOST_REQUIRE_EQUAL(owner.size(), 1u);
+        BOOST_REQUIRE_EQUAL(payee.size(), 1u);
+        chain.store.close();
+
+        const auto& directory = chain.store.directory();
+        boost::filesystem::remove(directory / "address_lock_table");
+        boost::filesystem::remove(directory / "address_lock_row");
+        BOOST_REQUIRE(data_base::upgrade_version_66(directory,
+            history_height));
+
+        chain.store.open();
+        BOOST_REQUIRE(chain.locks(chain.payee) == payee);
+
+        if (history_height == 0)
+            BOOST_REQUIRE(chain.locks(chain.owner) == owner);
+        else
+            BOOST_REQUIRE(chain.locks(chain.owner).empty());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,263 @@
+#ifdef  DATABASE_TESTS
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database.hpp>
+#include <metaverse/database/primitives/compact_transaction.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+
+static const short_hash hash1 = base16_literal(
+    "18c0bd8d1818f1bf99cb1df2269c645318ef7b73");
+
+static const hash_digest previous1 = base16_literal(
+    "4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+
+static script make_script(const data_chunk& raw, script::parse_mode mode)
+{
+    script out;
+    BOOST_REQUIRE(out.from_data(raw, false, mode));
+    return out;
+}
+
+static script make_script(const operation::stack& ops)
+{
+    script out;
+    out.operations = ops;
+    return out;
+}
+
+static output make_output(uint64_t value, const script& script)
+{
+    output out;
+    out.value = value;
+    out.script = script;
+    return out;
+}
+
+static transaction make_coinbase()
+{
+    transaction tx;
+    tx.version = 1;
+
+    // Coinbase scripts are kept verbatim, whatever they would parse as.
+    tx.inputs.push_back({ { null_hash, max_uint32 },
+        make_script({ 0x03, 0x40, 0x42, 0x0f, 0x4c },
+            script::parse_mode::raw_data),
+        max_uint32 });
+
+    tx.outputs.push_back(make_output(300000000, make_script(
+        operation::to_pay_key_hash_pattern(hash1))));
+    return tx;
+}
+
+static transaction make_spend()
+{
+    transaction tx;
+    tx.version = 2;
+    tx.locktime = 1234567;
+
+    // A pushdata1 without its size byte only parses as raw data.
+    tx.inputs.push_back({ { previous1, 0 },
+        make_script({ 0x4c }, script::parse_mode::raw_data_fallback), 0 });
+    tx.inputs.push_back({ { previous1, 7 },
+        make_script({ 0x01, 0x02 }, script::parse_mode::strict), max_uint32 });
+    tx.inputs.push_back({ { previous1, max_uint32 - 1 },
+        script{}, max_uint32 - 1 });
+
+    tx.outputs.push_back(make_output(1, make_script(
+        operation::to_pay_key_hash_pattern(hash1))));
+    tx.outputs.push_back(make_output(max_uint64, make_script(
+        operation::to_pay_script_hash_pattern(hash1))));
+    tx.outputs.push_back(make_output(0, make_script(
+        operation::to_pay_key_hash_with_lock_height_pattern(hash1, 9000))));
+    tx.outputs.push_back(make_output(42, make_script({ 0x76, 0xa9, 0x14 },
+        script::parse_mode::raw_data_fallback)));
+    tx.outputs.push_back(make_output(43, script{}));
+
+    auto& message = tx.outputs[0].attach_data;
+    message = attachment(MESSAGE_TYPE, 1, blockchain_message("compact"));
+
+    tx.outputs[1].attach_data = attachment("from.did", "to.did");
+    tx.outputs[1].attach_data.set_type(MESSAGE_TYPE);
+    tx.outputs[1].attach_data.set_attach(blockchain_message("to did"));
+    return tx;
+}
+
+static transaction round_trip(const transaction& tx)
+{
+    const auto data = compact_transaction::to_data(tx);
+    data_source istream(data);
+    istream_reader source(istream);
+
+    transaction out;
+    BOOST_REQUIRE(compact_transaction::from_data(out, source));
+    BOOST_REQUIRE(source.is_exhausted());
+    return out;
+}
+
+static void require_equal(const transaction& left, const transaction& right)
+{
+    BOOST_REQUIRE(left.to_data() == right.to_data());
+    BOOST_REQUIRE(left.hash() == right.hash());
+}
+
+// A fresh store, stopped and reopened between stores to vary the form.
+class transaction_store
+{
+public:
+    transaction_store()
+      : path_("compact_transaction_test")
+    {
+        boost::filesystem::remove(path_);
+        BOOST_REQUIRE(database::data_base::touch_file(path_));
+        transaction_database created(path_);
+        BOOST_REQUIRE(created.create());
+        BOOST_REQUIRE(created.stop());
+    }
+
+    ~transaction_store()
+    {
+        boost::filesystem::remove(path_);
+    }
+
+    void store(size_t height, size_t index, const transaction& tx,
+        bool compact)
+    {
+        transaction_database instance(path_, nullptr, compact);
+        BOOST_REQUIRE(instance.start());
+        instance.store(height, index, tx);
+        instance.sync();
+        BOOST_REQUIRE(instance.stop());
+    }
+
+    const boost::filesystem::path path_;
+};
+
+BOOST_AUTO_TEST_SUITE(compact_transaction_tests)
+
+BOOST_AUTO_TEST_CASE(compact_transaction__round_trip__coinbase__unchanged)
+{
+    const auto tx = make_coinbase();
+    BOOST_REQUIRE(tx.is_coinbase());
+
+    const auto out = round_trip(tx);
+    require_equal(tx, out);
+    BOOST_REQUIRE(out.inputs[0].previous_output.is_null());
+    BOOST_REQUIRE(out.inputs[0].script.is_raw_data());
+    BOOST_REQUIRE_EQUAL(out.inputs[0].sequence, max_uint32);
+}
+
+BOOST_AUTO_TEST_CASE(compact_transaction__round_trip__spend__unchanged)
+{
+    const auto tx = make_spend();
+    const auto out = round_trip(tx);
+    require_equal(tx, out);
+
+    BOOST_REQUIRE(out.inputs[0].script.is_raw_data());
+    BOOST_REQUIRE_EQUAL(out.inputs[0].sequence, 0u);
+    BOOST_REQUIRE_EQUAL(out.inputs[1].sequence, max_uint32);
+    BOOST_REQUIRE_EQUAL(out.inputs[2].previous_output.index, max_uint32 - 1);
+    BOOST_REQUIRE(out.outputs[0].script.pattern() ==
+        script_pattern::pay_key_hash);
+    BOOST_REQUIRE(out.outputs[1].script.pattern() ==
+        script_pattern::pay_script_hash);
+    BOOST_REQUIRE(out.outputs[3].script.is_raw_data());
+    BOOST_REQUIRE_EQUAL(out.outputs[1].value, max_uint64);
+}
+
+BOOST_AUTO_TEST_CASE(compact_transaction__round_trip__attachments__unchanged)
+{
+    const auto tx = make_spend();
+    const auto out = round_trip(tx);
+
+    const auto& message = out.outputs[0].attach_data;
+    BOOST_REQUIRE_EQUAL(message.get_type(), MESSAGE_TYPE);
+    BOOST_REQUIRE(message.to_data() == tx.outputs[0].attach_data.to_data());
+
+    const auto& to_did = out.outputs[1].attach_data;
+    BOOST_REQUIRE_EQUAL(to_did.get_version(), DID_ATTACH_VERIFY_VERSION);
+    BOOST_REQUIRE_EQUAL(to_did.get_to_did(), "to.did");
+    BOOST_REQUIRE_EQUAL(to_did.get_from_did(), "from.did");
+}
+
+BOOST_AUTO_TEST_CASE(compact_transaction__to_data__templated_scripts__smaller)
+{
+    const auto tx = make_spend();
+    BOOST_REQUIRE_LT(compact_transaction::to_data(tx).size(),
+        tx.serialized_size());
+}
+
+BOOST_AUTO_TEST_CASE(compact_transaction__from_data__truncated__false)
+{
+    auto data = compact_transaction::to_data(make_spend());
+    data.resize(data.size() / 2);
+    data_source istream(data);
+    istream_reader source(istream);
+
+    transaction out;
+    BOOST_REQUIRE(!compact_transaction::from_data(out, source));
+}
+
+BOOST_AUTO_TEST_CASE(compact_transaction__get__both_forms__unchanged)
+{
+    transaction_store file;
+    const auto coinbase = make_coinbase();
+    const auto spend = make_spend();
+    file.store(10, 0, coinbase, false);
+    file.store(10, 1, spend, true);
+
+    transaction_database instance(file.path_);
+    BOOST_REQUIRE(instance.start());
+
+    // Results hold the map, so they are released before it stops.
+    {
+        const auto full = instance.get(coinbase.hash());
+        BOOST_REQUIRE(full);
+        BOOST_REQUIRE_EQUAL(full.height(), 10u);
+        BOOST_REQUIRE_EQUAL(full.index(), 0u);
+        require_equal(full.transaction(), coinbase);
+
+        const auto compact = instance.get(spend.hash());
+        BOOST_REQUIRE(compact);
+        BOOST_REQUIRE_EQUAL(compact.height(), 10u);
+        BOOST_REQUIRE_EQUAL(compact.index(), 1u);
+        require_equal(compact.transaction(), spend);
+    }
+
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_CASE(compact_transaction__get_block__mixed_forms__unchanged)
+{
+    transaction_store file;
+    const auto coinbase = make_coinbase();
+    const auto spend = make_spend();
+    auto second = make_spend();
+    second.locktime = 7;
+
+    file.store(20, 0, coinbase, true);
+    file.store(20, 1, spend, false);
+    file.store(20, 2, second, true);
+
+    transaction_database instance(file.path_);
+    BOOST_REQUIRE(instance.start());
+
+    transaction::list out;
+    const hash_list hashes{ coinbase.hash(), spend.hash(), second.hash() };
+    BOOST_REQUIRE(instance.get_block(out, hashes, 20));
+    BOOST_REQUIRE_EQUAL(out.size(), 3u);
+    require_equal(out[0], coinbase);
+    require_equal(out[1], spend);
+    require_equal(out[2], second);
+
+    // The stored index, not the form flag, must match the block position.
+    BOOST_REQUIRE(!instance.get_block(out, { spend.hash(), second.hash() },
+        20));
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
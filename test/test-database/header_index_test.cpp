@@ -0,0 +1,374 @@
+#ifdef  DATABASE_TESTS
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/block.hpp>
+#include <metaverse/blockchain/header_index.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+using namespace libbitcoin::chain;
+
+static const uint32_t unknown_version = 7;
+
+// Mostly proof of work, with runs of the other versions and timestamps that
+// are not monotonic. The seed makes each branch distinct.
+static header make_header(uint64_t height, uint32_t seed)
+{
+    const auto random = static_cast<uint32_t>(height * 2654435761u + seed);
+
+    header out;
+    out.number = height;
+    out.timestamp = 1500000000 + static_cast<uint32_t>(height) * 20 +
+        random % 97;
+    out.bits = 1000 + random % 4096;
+
+    switch (random % 11)
+    {
+        case 0:
+        case 1:
+            out.version = block_version_pos;
+            break;
+        case 2:
+            out.version = block_version_dpos;
+            break;
+        case 3:
+            out.version = unknown_version;
+            break;
+        default:
+            out.version = block_version_pow;
+    }
+
+    return out;
+}
+
+// An entry of height zero is none, whatever the genesis header holds.
+static bool operator==(const header_index::retarget_entry& left,
+    const header_index::retarget_entry& right)
+{
+    return left.height == right.height && (left.height == 0 ||
+        (left.timestamp == right.timestamp && left.bits == right.bits));
+}
+
+// The index and the headers it is compared against, which are walked the
+// way the chain falls back to when the index cannot answer. The lengths of
+// the windows are followed to know when the index must answer.
+class header_chain
+{
+public:
+    void push(uint64_t count, uint32_t seed)
+    {
+        const auto window = header_index::retarget_window;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            const auto height = headers.size();
+            headers.push_back(make_header(height, seed));
+            index.push(headers.back(), height);
+
+            work_window = std::min(work_window + 1, window);
+            auto& retargets = retarget_windows[headers.back().version];
+            retargets = std::min(retargets + 1, window);
+        }
+
+        BOOST_REQUIRE_EQUAL(index.size(), headers.size());
+    }
+
+    // Without pop_index only the headers are popped, for the index to be
+    // truncated otherwise.
+    void pop(uint64_t height, bool pop_index=true)
+    {
+        const auto popped = headers.size() - height;
+        work_window -= std::min(work_window, popped);
+
+        for (auto it = headers.begin() + height; it != headers.end(); ++it)
+        {
+            auto& retargets = retarget_windows[it->version];
+            retargets -= std::min<size_t>(retargets, 1);
+        }
+
+        headers.resize(height);
+        if (!pop_index)
+            return;
+
+        index.pop(height);
+        BOOST_REQUIRE_EQUAL(index.size(), headers.size());
+    }
+
+    uint64_t walk_previous(uint64_t height, uint32_t version,
+        bool same_version) const
+    {
+        while (height-- > 1)
+            if ((headers[height].version == version) == same_version)
+                return height;
+
+        return 0;
+    }
+
+    uint32_t walk_median(uint64_t height, size_t span) const
+    {
+        const auto count = std::min<uint64_t>(height, span);
+        std::vector<uint32_t> times;
+
+        for (uint64_t i = 1; i <= count; ++i)
+            times.push_back(headers[height - count + i].timestamp);
+
+        std::sort(times.begin(), times.end());
+        return times.empty() ? 0 : times[times.size() / 2];
+    }
+
+    // The two highest headers of the version below height.
+    void walk_retarget(header_index::retarget_entry& out_last,
+        header_index::retarget_entry& out_previous, uint64_t height,
+        uint32_t version) const
+    {
+        out_last = { 0, 0, 0 };
+        out_previous = { 0, 0, 0 };
+
+        while (height-- > 1)
+        {
+            const auto& header = headers[height];
+            if (header.version != version)
+                continue;
+
+            const header_index::retarget_entry entry{ height,
+                header.timestamp, header.bits };
+
+            if (out_last.height == 0)
+            {
+                out_last = entry;
+                continue;
+            }
+
+            out_previous = entry;
+            return;
+        }
+    }
+
+    u256 walk_work(uint64_t height) const
+    {
+        u256 work = 0;
+        for (auto index = height; index < headers.size(); ++index)
+            work += block_work(headers[index].bits);
+
+        return work;
+    }
+
+    // Every answer the index gives is the answer of the walk.
+    void require_find_previous() const
+    {
+        const auto size = headers.size();
+        for (uint64_t height = 0; height <= size + 1; ++height)
+        {
+            for (const auto version: { block_version_pow, block_version_pos,
+                block_version_dpos })
+            {
+                for (const auto same: { true, false })
+                {
+                    uint64_t previous;
+                    const auto found = index.find_previous(previous, height,
+                        version, same);
+
+                    // Up to the parent of the next block, it always answers.
+                    BOOST_REQUIRE_EQUAL(found, height <= size || height < 2);
+                    if (found)
+                        BOOST_REQUIRE_EQUAL(previous,
+                            walk_previous(height, version, same));
+                }
+            }
+
+            uint64_t previous;
+            BOOST_REQUIRE(!index.find_previous(previous, height,
+                unknown_version, true));
+        }
+    }
+
+    void require_median_time_past() const
+    {
+        const auto size = headers.size();
+        for (uint64_t height = 0; height <= size; ++height)
+        {
+            for (const size_t span: { 1, 11 })
+            {
+                uint32_t median;
+                const auto found = index.median_time_past(median, height,
+                    span);
+
+                BOOST_REQUIRE_EQUAL(found, height < size || height == 0);
+                if (found)
+                    BOOST_REQUIRE_EQUAL(median, walk_median(height, span));
+            }
+        }
+    }
+
+    void require_timestamps() const
+    {
+        uint32_t timestamp;
+        for (uint64_t height = 0; height < headers.size(); ++height)
+        {
+            BOOST_REQUIRE(index.get_timestamp(timestamp, height));
+            BOOST_REQUIRE_EQUAL(timestamp, headers[height].timestamp);
+        }
+
+        BOOST_REQUIRE(!index.get_timestamp(timestamp, headers.size()));
+    }
+
+    void require_retarget() const
+    {
+        const auto size = headers.size();
+        for (const auto version: { block_version_pow, block_version_pos,
+            block_version_dpos })
+        {
+            std::vector<uint64_t> heights;
+            for (uint64_t height = 0; height < size; ++height)
+                if (headers[height].version == version)
+                    heights.push_back(height);
+
+            const auto window = retarget_window(version);
+            const auto complete = window == heights.size();
+            const auto first = heights.size() - window;
+
+            for (uint64_t height = 0; height <= size + 1; ++height)
+            {
+                header_index::retarget_entry last;
+                header_index::retarget_entry previous;
+                const auto found = index.find_retarget(last, previous,
+                    height, version);
+
+                // Headers of the version in the window below height.
+                const auto below = static_cast<size_t>(std::lower_bound(
+                    heights.begin() + first, heights.end(), height) -
+                    (heights.begin() + first));
+
+                BOOST_REQUIRE_EQUAL(found, height >= 2 && height <= size &&
+                    (below >= 2 || complete));
+
+                if (!found)
+                    continue;
+
+                header_index::retarget_entry walk_last;
+                header_index::retarget_entry walk_previous;
+                walk_retarget(walk_last, walk_previous, height, version);
+                BOOST_REQUIRE(last == walk_last);
+                BOOST_REQUIRE(previous == walk_previous);
+            }
+        }
+    }
+
+    void require_work() const
+    {
+        const auto size = headers.size();
+        const auto base = size - work_window;
+
+        for (uint64_t height = 0; height <= size + 1; ++height)
+        {
+            u256 work;
+            const auto found = index.get_work(work, height);
+
+            // The work below the window is unknown, unless it is genesis.
+            BOOST_REQUIRE_EQUAL(found, work_window > 0 && height <= size &&
+                (height > base || (height == base && base == 0)));
+
+            if (found)
+                BOOST_REQUIRE(work == walk_work(height));
+        }
+    }
+
+    void require_walk() const
+    {
+        require_timestamps();
+        require_find_previous();
+        require_median_time_past();
+        require_retarget();
+        require_work();
+    }
+
+    size_t retarget_window(uint32_t version) const
+    {
+        const auto it = retarget_windows.find(version);
+        return it == retarget_windows.end() ? 0 : it->second;
+    }
+
+    std::vector<header> headers;
+    header_index index;
+    size_t work_window = 0;
+    std::map<uint32_t, size_t> retarget_windows;
+};
+
+BOOST_AUTO_TEST_SUITE(header_index_tests)
+
+BOOST_AUTO_TEST_CASE(header_index__push_pop_push__matches_walk)
+{
+    header_chain chain;
+    chain.push(300, 1);
+    chain.require_walk();
+
+    chain.pop(200);
+    chain.require_walk();
+
+    // A different branch above the fork point.
+    chain.push(150, 2);
+    chain.require_walk();
+
+    chain.pop(1);
+    chain.require_walk();
+    chain.push(40, 3);
+    chain.require_walk();
+}
+
+// A push at or below the top replaces the headers from there up, as in a
+// reorganization, and a push beyond the top is ignored.
+// Enough headers that the work window and the proof of work retarget window
+// roll, then popped below both windows, which the index cannot refill.
+BOOST_AUTO_TEST_CASE(header_index__windows_push_pop_push__matches_walk)
+{
+    header_chain chain;
+    chain.push(2000, 1);
+    BOOST_REQUIRE_EQUAL(chain.work_window, header_index::retarget_window);
+    BOOST_REQUIRE_EQUAL(chain.retarget_window(block_version_pow),
+        header_index::retarget_window);
+    chain.require_walk();
+
+    chain.pop(1900);
+    chain.require_walk();
+    chain.push(300, 2);
+    chain.require_walk();
+
+    chain.pop(600);
+    BOOST_REQUIRE_EQUAL(chain.work_window, 0u);
+    chain.require_walk();
+    chain.push(100, 3);
+    chain.require_walk();
+}
+
+BOOST_AUTO_TEST_CASE(header_index__push_below_top__truncates)
+{
+    header_chain chain;
+    chain.push(50, 1);
+
+    chain.pop(30, false);
+    chain.push(1, 2);
+    chain.require_walk();
+
+    chain.index.push(make_header(40, 3), 40);
+    chain.require_walk();
+}
+
+BOOST_AUTO_TEST_CASE(header_index__clear__empty)
+{
+    header_chain chain;
+    chain.push(20, 1);
+    chain.pop(0, false);
+    chain.index.clear();
+    BOOST_REQUIRE_EQUAL(chain.index.size(), 0u);
+    chain.require_walk();
+
+    chain.push(20, 2);
+    chain.require_walk();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,176 @@
+#ifdef  DATABASE_TESTS
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/pool_validations.hpp>
+#include "utility.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database::test;
+
+static const data_chunk key1 = to_chunk(base16_literal(
+    "03e7ab4a2def5fcdc9cbe75c1bdd2d6b3fd7e8a9e0c75cbd1a6d1e1e7bb46e23b6"));
+
+static const hash_digest tip = base16_literal(
+    "000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f");
+static const hash_digest other_tip = base16_literal(
+    "00000000839a8e6886ab5951d76f411475428afc90947ee320161bbf18eb6048");
+
+// A confirmed output, of a transaction before the block.
+static const output_point confirmed_point{ other_tip, 0 };
+
+static pool_validations::validation validated(const hash_digest& against,
+    const pool_validations::indexes& unconfirmed={})
+{
+    return { against, 100, 1, unconfirmed };
+}
+
+// A block of a coinbase, a pool parent spending a confirmed output and a
+// child spending the parent, as the pool validated them.
+class pooled_block
+{
+public:
+    pooled_block()
+      : coinbase(make_coinbase(1, {})),
+        parent(make_spend({ confirmed_point }, key1, { make_output({}, 1,
+            etp_attachment(1)) })),
+        child(make_spend({ { parent.hash(), 0 } }, key1, {}))
+    {
+    }
+
+    const transaction coinbase;
+    const transaction parent;
+    const transaction child;
+};
+
+BOOST_AUTO_TEST_SUITE(pooled_connect_tests)
+
+BOOST_AUTO_TEST_CASE(pooled_connect__connect__parent_first__connected)
+{
+    pooled_block block;
+    pooled_connect connector;
+    connector.add(block.coinbase);
+    BOOST_REQUIRE(connector.connect(block.parent, validated(tip)));
+    BOOST_REQUIRE(connector.connect(block.child, validated(tip, { 0 })));
+}
+
+// The pool parent of the transaction is not in the block.
+BOOST_AUTO_TEST_CASE(pooled_connect__connect__parent_missing__fails)
+{
+    pooled_block block;
+    pooled_connect connector;
+    connector.add(block.coinbase);
+    BOOST_REQUIRE(!connector.connect(block.child, validated(tip, { 0 })));
+}
+
+BOOST_AUTO_TEST_CASE(pooled_connect__connect__parent_after_child__fails)
+{
+    pooled_block block;
+
+    // Whether the parent was validated by the pool or in full.
+    for (const auto parent_pooled: { true, false })
+    {
+        pooled_connect connector;
+        connector.add(block.coinbase);
+        BOOST_REQUIRE(!connector.connect(block.child, validated(tip, { 0 })));
+
+        if (parent_pooled)
+            BOOST_REQUIRE(connector.connect(block.parent, validated(tip)));
+        else
+            connector.add(block.parent);
+    }
+
+    // The parent validated in full also counts when it precedes the child.
+    pooled_connect connector;
+    connector.add(block.parent);
+    BOOST_REQUIRE(connector.connect(block.child, validated(tip, { 0 })));
+}
+
+BOOST_AUTO_TEST_CASE(pooled_connect__connect__double_spend__fails)
+{
+    pooled_block block;
+    const auto spend = make_spend({ confirmed_point }, key1, {});
+    BOOST_REQUIRE(spend.hash() != block.parent.hash());
+
+    pooled_connect connector;
+    BOOST_REQUIRE(connector.connect(block.parent, validated(tip)));
+    BOOST_REQUIRE(!connector.connect(spend, validated(tip)));
+
+    // Within the transaction itself.
+    pooled_connect twice;
+    const auto doubled = make_spend({ confirmed_point, confirmed_point }, key1,
+        {});
+    BOOST_REQUIRE(!twice.connect(doubled, validated(tip)));
+}
+
+BOOST_AUTO_TEST_CASE(pooled_connect__connect__unconfirmed_index_out_of_range__fails)
+{
+    pooled_block block;
+    pooled_connect connector;
+    connector.add(block.parent);
+    BOOST_REQUIRE(!connector.connect(block.child, validated(tip, { 1 })));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(pool_validations_tests)
+
+BOOST_AUTO_TEST_CASE(pool_validations__find__not_stored__false)
+{
+    pooled_block block;
+    pool_validations validations;
+    pool_validations::validation out;
+    BOOST_REQUIRE(!validations.find(out, block.parent.hash(), tip));
+}
+
+BOOST_AUTO_TEST_CASE(pool_validations__find__same_tip__stored_result)
+{
+    pooled_block block;
+    pool_validations validations;
+    validations.store(block.child.hash(), validated(tip, { 0 }));
+
+    pool_validations::validation out;
+    BOOST_REQUIRE(validations.find(out, block.child.hash(), tip));
+    BOOST_REQUIRE(out.tip == tip);
+    BOOST_REQUIRE_EQUAL(out.value_in, 100u);
+    BOOST_REQUIRE_EQUAL(out.sigops, 1u);
+    BOOST_REQUIRE(out.unconfirmed == pool_validations::indexes{ 0 });
+}
+
+// The tip moved between the pool validation and the connect of the block.
+BOOST_AUTO_TEST_CASE(pool_validations__find__tip_changed__false)
+{
+    pooled_block block;
+    pool_validations validations;
+    validations.store(block.parent.hash(), validated(tip));
+
+    pool_validations::validation out;
+    BOOST_REQUIRE(!validations.find(out, block.parent.hash(), other_tip));
+
+    // The block connected on the new tip keeps only its validations.
+    validations.store(block.child.hash(), validated(other_tip));
+    validations.retain(other_tip);
+    BOOST_REQUIRE_EQUAL(validations.size(), 1u);
+    BOOST_REQUIRE(!validations.find(out, block.parent.hash(), tip));
+    BOOST_REQUIRE(validations.find(out, block.child.hash(), other_tip));
+
+    // A reorganization keeps none.
+    validations.retain(null_hash);
+    BOOST_REQUIRE_EQUAL(validations.size(), 0u);
+}
+
+// The tip moved while the pool validation ran.
+BOOST_AUTO_TEST_CASE(pool_validations__store__tip_moved_during_validation__not_kept)
+{
+    pooled_block block;
+    pool_validations validations;
+    validations.store(block.parent.hash(), validated(null_hash));
+    BOOST_REQUIRE_EQUAL(validations.size(), 0u);
+
+    pool_validations::validation out;
+    BOOST_REQUIRE(!validations.find(out, block.parent.hash(), null_hash));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
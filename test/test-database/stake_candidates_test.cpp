@@ -0,0 +1,240 @@
+#ifdef  DATABASE_TESTS
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/stake_candidates.hpp>
+#include "utility.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database::test;
+using namespace libbitcoin::wallet;
+
+static const data_chunk key1 = to_chunk(base16_literal(
+    "03e7ab4a2def5fcdc9cbe75c1bdd2d6b3fd7e8a9e0c75cbd1a6d1e1e7bb46e23b6"));
+static const data_chunk key2 = to_chunk(base16_literal(
+    "02a3a8e2f2c0e18c5a5e7ae2c9a1d1f8e1f3b62bdbcb2cc0c9f8d8e5e2f7a1b3c4"));
+
+static const uint64_t maturity = 3;
+static const uint64_t small_value = 10;
+
+typedef std::tuple<bool, uint64_t, hash_digest, uint32_t> visited;
+typedef std::vector<visited> visited_list;
+
+// As the chain makes them, by height and value rules only.
+static bool make_candidate(stake_candidates::candidate& out,
+    const transaction& tx, uint32_t index, uint64_t height)
+{
+    if (index >= tx.outputs.size() || height == 0)
+        return false;
+
+    out.info = { tx.outputs[index], { tx.hash(), index }, height };
+    out.ready_height = height + maturity;
+    out.recheck = false;
+    out.small = tx.outputs[index].value < small_value;
+    return true;
+}
+
+// Blocks that pay the staker, spend its earlier outputs and pay others, and
+// the candidates of the staker found by walking them, as the loader does.
+class stake_chain
+{
+public:
+    stake_chain()
+      : staker(key_address(key1)),
+        other(key_address(key2))
+    {
+        blocks.push_back(make_block(null_hash, 0, { make_coinbase(0,
+            { pay_key_hash(staker, 50) }) }));
+    }
+
+    // Pays the staker a large and a small output, spends its oldest unspent
+    // output (if any) to the other address and pays the other address.
+    void push(uint32_t seed)
+    {
+        const auto height = static_cast<uint32_t>(blocks.size());
+        transaction::list transactions{ make_coinbase(height,
+            { pay_key_hash(staker, 100 + seed), pay_key_hash(staker, 5),
+              pay_key_hash(other, 70), pay_asset(staker, "TEST.STAKE", 1) }) };
+
+        const auto unspent = walk();
+        if (!unspent.empty())
+            transactions.push_back(make_spend({ unspent.front().info.point },
+                key1, { pay_key_hash(other, 1), pay_key_hash(staker, seed) }));
+
+        blocks.push_back(make_block(blocks.back().header.hash(), height,
+            transactions));
+    }
+
+    void connect()
+    {
+        candidates.connect(blocks.back(), blocks.size() - 1, make_candidate);
+    }
+
+    // The chain invalidates on a pop and reloads on the next use.
+    void pop()
+    {
+        blocks.pop_back();
+        candidates.invalidate();
+        load();
+    }
+
+    void load()
+    {
+        candidates.load(staker, [this]()
+        {
+            return walk();
+        });
+    }
+
+    stake_candidates::candidate::list walk() const
+    {
+        std::unordered_set<point> spent;
+        for (const auto& block: blocks)
+            for (const auto& tx: block.transactions)
+                if (!tx.is_coinbase())
+                    for (const auto& input: tx.inputs)
+                        spent.insert(input.previous_output);
+
+        stake_candidates::candidate::list out;
+        for (size_t height = 0; height < blocks.size(); ++height)
+        {
+            for (const auto& tx: blocks[height].transactions)
+            {
+                for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+                {
+                    const auto& output = tx.outputs[index];
+                    stake_candidates::candidate candidate;
+
+                    if (output.value != 0 && output.is_etp() &&
+                        payment_address::extract(output.script) == staker &&
+                        spent.find({ tx.hash(), index }) == spent.end() &&
+                        make_candidate(candidate, tx, index, height))
+                        out.push_back(candidate);
+                }
+            }
+        }
+
+        return out;
+    }
+
+    // The walked candidates ready at height, in the order they are visited.
+    visited_list walked(uint64_t height) const
+    {
+        visited_list out;
+        for (const auto& candidate: walk())
+            if (candidate.ready_height <= height)
+                out.emplace_back(candidate.small, candidate.ready_height,
+                    candidate.info.point.hash, candidate.info.point.index);
+
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    visited_list visit(uint64_t height) const
+    {
+        visited_list out;
+        const auto record = [&out](const stake_candidates::candidate& item)
+        {
+            out.emplace_back(item.small, item.ready_height,
+                item.info.point.hash, item.info.point.index);
+            return true;
+        };
+
+        candidates.visit(staker, height, record, record);
+
+        // Within each schedule the points of a height are in point order.
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    void require_walk() const
+    {
+        const auto top = blocks.size() - 1;
+        for (auto height = top; height <= top + maturity + 1; ++height)
+            BOOST_REQUIRE(visit(height) == walked(height));
+
+        // Outputs of the genesis block cannot be staked.
+        BOOST_REQUIRE_EQUAL(walked(top + maturity).empty(), top == 0);
+    }
+
+    const payment_address staker;
+    const payment_address other;
+    block::list blocks;
+    stake_candidates candidates;
+};
+
+BOOST_AUTO_TEST_SUITE(stake_candidates_tests)
+
+BOOST_AUTO_TEST_CASE(stake_candidates__push_pop_push__matches_walk)
+{
+    stake_chain chain;
+    chain.load();
+    chain.require_walk();
+
+    for (uint32_t seed = 1; seed <= 8; ++seed)
+    {
+        chain.push(seed);
+        chain.connect();
+        chain.require_walk();
+    }
+
+    for (size_t pops = 0; pops < 3; ++pops)
+    {
+        chain.pop();
+        chain.require_walk();
+    }
+
+    // A different branch on the fork point.
+    for (uint32_t seed = 20; seed <= 25; ++seed)
+    {
+        chain.push(seed);
+        chain.connect();
+        chain.require_walk();
+    }
+}
+
+// Blocks connected while the loader walks the chain are reconciled with its
+// result, including the spends of outputs the walk still saw.
+BOOST_AUTO_TEST_CASE(stake_candidates__connect_while_loading__matches_walk)
+{
+    stake_chain chain;
+    for (uint32_t seed = 1; seed <= 3; ++seed)
+        chain.push(seed);
+
+    chain.candidates.load(chain.staker, [&chain]()
+    {
+        const auto walked = chain.walk();
+        chain.push(4);
+        chain.connect();
+        return walked;
+    });
+
+    chain.require_walk();
+}
+
+// Invalidated while loading, the load is dropped and redone on next use.
+BOOST_AUTO_TEST_CASE(stake_candidates__invalidate_while_loading__reloaded)
+{
+    stake_chain chain;
+    chain.push(1);
+
+    chain.candidates.load(chain.staker, [&chain]()
+    {
+        const auto walked = chain.walk();
+        chain.candidates.invalidate();
+        return walked;
+    });
+
+    BOOST_REQUIRE(chain.visit(chain.blocks.size() + maturity).empty());
+    chain.load();
+    chain.require_walk();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
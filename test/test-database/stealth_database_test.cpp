@@ -0,0 +1,241 @@
+#ifdef  DATABASE_TESTS
+#include <cstdint>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::database;
+
+// Not a multiple of four, so scans from each height end on every tail size.
+static constexpr uint32_t rows_per_height = 3;
+static constexpr uint32_t row_count = 37;
+static constexpr uint32_t top_height = (row_count - 1) / rows_per_height;
+
+struct stored_row
+{
+    uint32_t prefix;
+    uint32_t height;
+    stealth_compact row;
+};
+
+// Every third prefix shares all but its last byte with the one before it, so
+// long filters still match more than one row.
+static std::vector<stored_row> make_rows()
+{
+    std::vector<stored_row> out;
+    uint32_t random = 42;
+
+    for (uint32_t index = 0; index < row_count; ++index)
+    {
+        random = random * 1103515245 + 12345;
+        auto prefix = random;
+
+        if (index % 3 == 2)
+            prefix = (out.back().prefix & 0x00ffffff) | (random & 0xff000000);
+
+        stored_row stored{ prefix, index / rows_per_height, {} };
+        stored.row.ephemeral_public_key_hash.fill(0x02);
+        stored.row.public_key_hash.fill(0x03);
+        stored.row.transaction_hash.fill(0x00);
+        stored.row.transaction_hash[0] = static_cast<uint8_t>(index);
+        out.push_back(stored);
+    }
+
+    return out;
+}
+
+// The filter of the first bits of a prefix, as compared by the scan.
+static binary make_filter(uint32_t prefix, binary::size_type bits)
+{
+    return { bits, to_little_endian(prefix) };
+}
+
+// The hashes of the rows the previous row by row scan returned.
+static hash_list expected_scan(const std::vector<stored_row>& rows,
+    const binary& filter, size_t from_height)
+{
+    hash_list out;
+    for (const auto& stored: rows)
+        if (stored.height >= from_height && filter.is_prefix_of(stored.prefix))
+            out.push_back(stored.row.transaction_hash);
+
+    return out;
+}
+
+static hash_list to_hashes(const stealth_compact::list& rows)
+{
+    hash_list out;
+    for (const auto& row: rows)
+        out.push_back(row.transaction_hash);
+
+    return out;
+}
+
+// A fresh pair of columns holding the rows in height order.
+class stealth_store
+{
+public:
+    stealth_store()
+      : prefixes_("stealth_test_prefixes"),
+        payloads_("stealth_test_payloads"),
+        rows(make_rows())
+    {
+        remove();
+        BOOST_REQUIRE(data_base::touch_file(prefixes_));
+        BOOST_REQUIRE(data_base::touch_file(payloads_));
+
+        stealth_database created(prefixes_, payloads_);
+        BOOST_REQUIRE(created.create());
+
+        for (const auto& stored: rows)
+            created.store(stored.prefix, stored.height, stored.row);
+
+        created.sync();
+        BOOST_REQUIRE(created.stop());
+    }
+
+    ~stealth_store()
+    {
+        remove();
+    }
+
+    void remove()
+    {
+        boost::filesystem::remove(prefixes_);
+        boost::filesystem::remove(payloads_);
+    }
+
+    const boost::filesystem::path prefixes_;
+    const boost::filesystem::path payloads_;
+    const std::vector<stored_row> rows;
+};
+
+BOOST_AUTO_TEST_SUITE(stealth_database_tests)
+
+// The vector compare must match the bitwise prefix test on any row position.
+BOOST_AUTO_TEST_CASE(stealth_database__scan__filter_lengths__matches_scalar)
+{
+    stealth_store file;
+    stealth_database instance(file.prefixes_, file.payloads_);
+    BOOST_REQUIRE(instance.start());
+
+    for (const binary::size_type bits: { 0, 1, 3, 8, 11, 16, 20, 24, 31, 32 })
+    {
+        for (const auto& stored: file.rows)
+        {
+            const auto filter = make_filter(stored.prefix, bits);
+            const auto expected = expected_scan(file.rows, filter, 0);
+            BOOST_REQUIRE(!expected.empty());
+            BOOST_REQUIRE(to_hashes(instance.scan(filter, 0)) == expected);
+        }
+
+        const auto missing = make_filter(~file.rows.front().prefix, bits);
+        BOOST_REQUIRE(to_hashes(instance.scan(missing, 0)) ==
+            expected_scan(file.rows, missing, 0));
+    }
+
+    BOOST_REQUIRE_EQUAL(instance.scan({}, 0).size(), row_count);
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_CASE(stealth_database__scan__filter_beyond_prefix__zero_padded)
+{
+    stealth_store file;
+    stealth_database instance(file.prefixes_, file.payloads_);
+    BOOST_REQUIRE(instance.start());
+
+    const auto prefix = file.rows[5].prefix;
+    auto padded = to_chunk(to_little_endian(prefix));
+    padded.push_back(0x00);
+
+    const binary zeros(40, padded);
+    BOOST_REQUIRE(to_hashes(instance.scan(zeros, 0)) ==
+        expected_scan(file.rows, zeros, 0));
+    BOOST_REQUIRE_EQUAL(instance.scan(zeros, 0).size(), 1u);
+
+    padded.back() = 0x01;
+    const binary ones(40, padded);
+    BOOST_REQUIRE(instance.scan(ones, 0).empty());
+    BOOST_REQUIRE(expected_scan(file.rows, ones, 0).empty());
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_CASE(stealth_database__scan__from_height__rows_at_and_above)
+{
+    stealth_store file;
+    stealth_database instance(file.prefixes_, file.payloads_);
+    BOOST_REQUIRE(instance.start());
+
+    for (size_t height = 0; height <= top_height; ++height)
+    {
+        const auto all = to_hashes(instance.scan({}, height));
+        BOOST_REQUIRE_EQUAL(all.size(), row_count - height * rows_per_height);
+        BOOST_REQUIRE(all == expected_scan(file.rows, {}, height));
+
+        for (const binary::size_type bits: { 4, 24 })
+        {
+            const auto filter = make_filter(file.rows.back().prefix, bits);
+            BOOST_REQUIRE(to_hashes(instance.scan(filter, height)) ==
+                expected_scan(file.rows, filter, height));
+        }
+    }
+
+    BOOST_REQUIRE(instance.scan({}, top_height + 1).empty());
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_CASE(stealth_database__unlink__mid_height__removes_at_and_above)
+{
+    stealth_store file;
+    const size_t height = 5;
+
+    {
+        stealth_database instance(file.prefixes_, file.payloads_);
+        BOOST_REQUIRE(instance.start());
+        instance.unlink(height);
+        instance.sync();
+
+        const auto all = expected_scan(file.rows, {}, 0);
+        const hash_list below(all.begin(),
+            all.begin() + height * rows_per_height);
+        BOOST_REQUIRE(to_hashes(instance.scan({}, 0)) == below);
+        BOOST_REQUIRE(instance.scan({}, height).empty());
+        BOOST_REQUIRE(instance.stop());
+    }
+
+    // The truncation is kept and the height can be stored again.
+    stealth_database instance(file.prefixes_, file.payloads_);
+    BOOST_REQUIRE(instance.start());
+    BOOST_REQUIRE_EQUAL(instance.scan({}, 0).size(), height * rows_per_height);
+
+    const auto& replaced = file.rows[height * rows_per_height];
+    instance.store(replaced.prefix, replaced.height, replaced.row);
+    const auto rows = to_hashes(instance.scan({}, height));
+    BOOST_REQUIRE(rows == hash_list{ replaced.row.transaction_hash });
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_CASE(stealth_database__unlink__bounds__all_or_nothing)
+{
+    stealth_store file;
+    stealth_database instance(file.prefixes_, file.payloads_);
+    BOOST_REQUIRE(instance.start());
+
+    instance.unlink(top_height + 1);
+    BOOST_REQUIRE_EQUAL(instance.scan({}, 0).size(), row_count);
+
+    instance.unlink(top_height);
+    BOOST_REQUIRE_EQUAL(instance.scan({}, 0).size(),
+        top_height * rows_per_height);
+
+    instance.unlink(0);
+    BOOST_REQUIRE(instance.scan({}, 0).empty());
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
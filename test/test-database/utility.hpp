@@ -0,0 +1,180 @@
+#ifndef MVS_TEST_DATABASE_UTILITY_HPP
+#define MVS_TEST_DATABASE_UTILITY_HPP
+
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database.hpp>
+
+namespace libbitcoin {
+namespace database {
+namespace test {
+
+// Chain builders, only what the indexes look at is filled in.
+//-----------------------------------------------------------------------------
+
+inline wallet::payment_address key_address(const data_chunk& public_key)
+{
+    return { bitcoin_short_hash(public_key),
+        wallet::payment_address::mainnet_p2kh };
+}
+
+inline chain::attachment etp_attachment(uint64_t value)
+{
+    return { ETP_TYPE, 1, chain::etp(value) };
+}
+
+inline chain::attachment asset_attachment(const std::string& symbol,
+    uint64_t quantity)
+{
+    return { ASSET_TYPE, 1, chain::asset(ASSET_TRANSFERABLE_TYPE,
+        chain::asset_transfer(symbol, quantity)) };
+}
+
+inline chain::output make_output(const chain::operation::stack& ops,
+    uint64_t value, const chain::attachment& attach)
+{
+    chain::output out;
+    out.value = value;
+    out.script.operations = ops;
+    out.attach_data = attach;
+    return out;
+}
+
+inline chain::output pay_key_hash(const wallet::payment_address& address,
+    uint64_t value)
+{
+    return make_output(chain::operation::to_pay_key_hash_pattern(
+        address.hash()), value, etp_attachment(value));
+}
+
+inline chain::output pay_asset(const wallet::payment_address& address,
+    const std::string& symbol, uint64_t quantity)
+{
+    return make_output(chain::operation::to_pay_key_hash_pattern(
+        address.hash()), 0, asset_attachment(symbol, quantity));
+}
+
+// The height makes the coinbase, and so the block, unique.
+inline chain::transaction make_coinbase(uint32_t height,
+    const chain::output::list& outputs)
+{
+    chain::transaction tx;
+    tx.version = 1;
+    tx.inputs.resize(1);
+
+    auto& input = tx.inputs.front();
+    input.previous_output = chain::output_point{ null_hash, max_uint32 };
+    input.script.operations.push_back({ chain::opcode::raw_data,
+        to_chunk(to_little_endian(height)) });
+    input.sequence = max_uint32;
+
+    tx.outputs = outputs;
+    return tx;
+}
+
+// Spends each point with a key hash signature of the public key.
+inline chain::transaction make_spend(const chain::point::list& points,
+    const data_chunk& public_key, const chain::output::list& outputs)
+{
+    static const data_chunk endorsement(72, 0x30);
+
+    chain::transaction tx;
+    tx.version = 1;
+
+    for (const auto& point: points)
+    {
+        chain::input input;
+        input.previous_output = point;
+        input.script.operations.push_back({ chain::opcode::special,
+            endorsement });
+        input.script.operations.push_back({ chain::opcode::special,
+            public_key });
+        input.sequence = max_uint32;
+        tx.inputs.push_back(input);
+    }
+
+    tx.outputs = outputs;
+    return tx;
+}
+
+inline chain::block make_block(const hash_digest& previous, uint32_t height,
+    const chain::transaction::list& transactions)
+{
+    chain::block out;
+    out.header.version = 1;
+    out.header.previous_block_hash = previous;
+    out.header.timestamp = 1500000000 + height;
+    out.header.bits = 1;
+    out.header.number = height;
+    out.transactions = transactions;
+    out.header.merkle = chain::block::generate_merkle_root(transactions);
+    out.header.transaction_count = transactions.size();
+    return out;
+}
+
+// A database in a fresh directory of the working directory, initialized
+// with the genesis block and removed when done.
+//-----------------------------------------------------------------------------
+
+class test_database
+{
+public:
+    test_database(const std::string& directory, const chain::block& genesis,
+        size_t history_height=0)
+      : directory_(directory), history_height_(history_height)
+    {
+        boost::filesystem::remove_all(directory_);
+        boost::filesystem::create_directories(directory_);
+        BOOST_REQUIRE(data_base::initialize(directory_, genesis));
+        open();
+    }
+
+    ~test_database()
+    {
+        close();
+        boost::filesystem::remove_all(directory_);
+    }
+
+    void open()
+    {
+        settings configuration;
+        configuration.directory = directory_;
+        configuration.history_start_height = history_height_;
+        instance_ = std::make_shared<data_base>(configuration);
+        BOOST_REQUIRE(instance_->start());
+    }
+
+    // Required before a static upgrade opens its own instance.
+    void close()
+    {
+        if (!instance_)
+            return;
+
+        instance_->stop();
+        instance_.reset();
+    }
+
+    data_base& db()
+    {
+        return *instance_;
+    }
+
+    const boost::filesystem::path& directory() const
+    {
+        return directory_;
+    }
+
+private:
+    const boost::filesystem::path directory_;
+    const size_t history_height_;
+    std::shared_ptr<data_base> instance_;
+};
+
+} // namespace test
+} // namespace database
+} // namespace libbitcoin
+
+#endif